@@ -0,0 +1,170 @@
+/**
+ * @file rbf_airtime.h
+ * @brief Airtime accounting per traffic class and channel utilization over sliding windows
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+#ifndef RBF_AIRTIME_H
+#define RBF_AIRTIME_H
+
+#include <stdint.h>
+#include "rbf_api.h"
+#include "rbf_subdev_ota.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @brief Preamble, sync word, header and CRC bytes added to each frame, an estimate
+ * 
+ * The radio library publishes neither its frame format nor its data rates. The overhead, the
+ * default band rates (38400 bit/s, 9600 bit/s on 433 MHz) and the payload lengths of received
+ * frames (heartbeat RBF_OBSERVER_HEARTBEAT_LEN, alarm 8, output status 12) are assumptions, not
+ * values read from the library: the figures are estimates. Set them to the radio module firmware.
+ */
+#ifndef RBF_AIRTIME_OVERHEAD_BYTES
+#define RBF_AIRTIME_OVERHEAD_BYTES      (16)
+#endif
+
+#ifndef RBF_AIRTIME_SLOTS
+#define RBF_AIRTIME_SLOTS               (60)        /**< Slots per sliding window */
+#endif
+
+#define RBF_AIRTIME_SHORT_SLOT_MS       (1000)      /**< Short window: 60 x 1 s */
+#define RBF_AIRTIME_LONG_SLOT_MS        (60000)     /**< Long window: 60 x 1 min */
+
+
+/**
+ * @brief Traffic class
+ * 
+ */
+typedef enum
+{
+    RBF_AIRTIME_HEARTBEAT = 0,      /**< Heartbeats */
+    RBF_AIRTIME_ALARM,              /**< Alarms, input events and status, keys */
+    RBF_AIRTIME_BROADCAST,          /**< Broadcast controls */
+    RBF_AIRTIME_OTA,                /**< Sub-device firmware data */
+    RBF_AIRTIME_P2P,                /**< Point to point controls, settings and output status */
+    RBF_AIRTIME_CLASS_MAX
+}rbf_airtime_class_t;
+
+
+/**
+ * @brief Frame direction
+ * 
+ */
+typedef enum
+{
+    RBF_AIRTIME_TX = 0,     /**< Sent by the hub */
+    RBF_AIRTIME_RX,         /**< Received by the hub */
+    RBF_AIRTIME_DIR_MAX
+}rbf_airtime_dir_t;
+
+
+/**
+ * @brief Sliding window
+ * 
+ */
+typedef enum
+{
+    RBF_AIRTIME_SHORT = 0,  /**< Last minute */
+    RBF_AIRTIME_LONG,       /**< Last hour */
+    RBF_AIRTIME_WINDOW_MAX
+}rbf_airtime_window_t;
+
+
+/**
+ * @brief Airtime statistics
+ * 
+ */
+typedef struct
+{
+    uint32_t window_ms;                                         /**< Window length */
+    uint32_t airtime_ms[RBF_AIRTIME_CLASS_MAX];                 /**< Airtime per class over the window */
+    uint16_t class_permille[RBF_AIRTIME_CLASS_MAX];             /**< Channel utilization per class over the window in 0.1 % */
+    uint16_t busy_permille;                                     /**< Channel utilization over the window in 0.1 % */
+    uint32_t frames[RBF_AIRTIME_DIR_MAX][RBF_AIRTIME_CLASS_MAX];/**< Frames since init */
+}rbf_airtime_stats_t;
+
+
+/**
+ * @brief Initialize the airtime accounting
+ * 
+ * @param freq Frequency band of the hub, as given to rbf_set_hub()
+ * @return int 0-sucess -1-failed
+ * @note Received frames are accounted through rbf_observer: wrap the callback functions clusters with
+ * rbf_observer_wrap_*() before registering them. rbf_cmd_send() and the rbf_group broadcasts report
+ * their frames with rbf_observer_tx(), accounted once the hook is installed here, other sent frames
+ * are given with rbf_airtime_record(). rbf_airtime_frame_us() on this band is installed as the
+ * rbf_observer frame airtime model, used e.g. by rbf_heartbeat.
+ * @note Only the frames seen by the extension are accounted. The frames the library sends on its
+ * own (acknowledgements, retransmissions, registration, hub OTA) and the SDK calls made directly
+ * by the application, e.g. a broadcast control, are missing unless given to rbf_airtime_record():
+ * the utilization is a lower bound.
+ */
+int rbf_airtime_init(RBF_Freq_t freq);
+
+
+/**
+ * @brief Set the data rate of a frequency band, the defaults are assumptions
+ * 
+ * @param freq Frequency band
+ * @param bps Data rate in bit/s, match it to the radio module firmware
+ * @return int 0-sucess -1-failed
+ */
+int rbf_airtime_rate_set(RBF_Freq_t freq, uint32_t bps);
+
+
+/**
+ * @brief Airtime of a frame on a frequency band
+ * 
+ * @param freq Frequency band
+ * @param len Frame payload length, RBF_AIRTIME_OVERHEAD_BYTES are added
+ * @return uint32_t Airtime in microseconds, 0 for an unknown band
+ */
+uint32_t rbf_airtime_frame_us(RBF_Freq_t freq, uint16_t len);
+
+
+/**
+ * @brief Account a frame
+ * 
+ * @param dir Direction
+ * @param cls Traffic class
+ * @param len Frame payload length
+ * @return int 0-sucess -1-failed
+ */
+int rbf_airtime_record(rbf_airtime_dir_t dir, rbf_airtime_class_t cls, uint16_t len);
+
+
+/**
+ * @brief Account the sub-device firmware data
+ * 
+ * Each data request served is accounted as one frame of the requested size: the library does not
+ * tell how it splits the data into radio frames, a request carried by several frames is
+ * accounted with the overhead of one.
+ * 
+ * @param cbs Sub-device OTA callback functions cluster, modified in place
+ * @return int 0-sucess -1-failed
+ */
+int rbf_airtime_wrap_subdev_ota(RBF_subdev_ota_evt_callbacks_t* cbs);
+
+
+/**
+ * @brief Get the airtime statistics
+ * 
+ * @param window Sliding window
+ * @param stats Airtime statistics
+ * @return int 0-sucess -1-failed
+ */
+int rbf_airtime_stats_get(rbf_airtime_window_t window, rbf_airtime_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,121 @@
+/**
+ * @file rbf_ant.h
+ * @brief Antenna diversity: antenna selection from surveyed device RSSI and noise
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+#ifndef RBF_ANT_H
+#define RBF_ANT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "rbf_api.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#ifndef RBF_ANT_DEVICES_MAX
+#define RBF_ANT_DEVICES_MAX             (32)        /**< Maximum number of devices measured by a survey */
+#endif
+
+#define RBF_ANT_COUNT                   (3)         /**< RBF_ANT_BUILTIN_0, RBF_ANT_BUILTIN_1 and RBF_ANT_EXTERNAL */
+#define RBF_ANT_MASK(index)             (1U << (index))
+
+
+/**
+ * @brief Diversity configuration
+ * 
+ */
+typedef struct
+{
+    uint8_t ants;               /**< Candidate antennas, RBF_ANT_MASK() bits */
+    RBF_ant_index_t current;    /**< Antenna in use at startup */
+    uint32_t dwell_ms;          /**< Measuring time per antenna */
+    uint32_t period_ms;         /**< Re-evaluation period, 0 for on demand surveys only */
+    uint8_t hysteresis;         /**< Margin gain in dB needed to switch from the current antenna */
+}rbf_ant_cfg_t;
+
+
+/**
+ * @brief Survey result
+ * 
+ */
+typedef struct
+{
+    RBF_ant_index_t selected;           /**< Antenna in use after the survey */
+    RBF_ant_index_t previous;           /**< Antenna in use before the survey */
+    bool switched;                      /**< selected differs from previous */
+    uint8_t devices;                    /**< Devices heard on any antenna */
+    bool valid[RBF_ANT_COUNT];          /**< Antenna surveyed and its noise measured */
+    uint8_t heard[RBF_ANT_COUNT];       /**< Devices heard on the antenna */
+    int32_t noise[RBF_ANT_COUNT];       /**< Average noise on the antenna */
+    int32_t margin[RBF_ANT_COUNT];      /**< Aggregate margin in 0.1 dB: mean of device RSSI minus noise, 0 for the devices not heard */
+}rbf_ant_result_t;
+
+
+/**
+ * @brief Diversity event reporting, called at the end of each survey
+ * @param result Survey result
+ * @note Called from rbf_ant_poll()
+ */
+typedef void (*rbf_ant_evt_handle_t)(const rbf_ant_result_t* result);
+
+
+/**
+ * @brief Initialize the diversity manager
+ * 
+ * @param cfg Configuration
+ * @param handle Event reporting callback, may be NULL
+ * @return int 0-sucess -1-failed
+ * @note Relies on rbf_observer: wrap the callback functions clusters with rbf_observer_wrap_*()
+ * before registering them.
+ */
+int rbf_ant_init(const rbf_ant_cfg_t* cfg, rbf_ant_evt_handle_t handle);
+
+
+/**
+ * @brief Start a survey, each candidate antenna is used for dwell_ms then the best one is selected
+ * 
+ * @param ids Devices asked for RSSI broadcast during the survey with rbf_start_rssi(), kept for the
+ * periodic surveys. NULL measures the normal traffic only
+ * @param count Number of ids, at most RBF_ANT_DEVICES_MAX
+ * @return int 0-sucess -1-failed or a survey is running
+ */
+int rbf_ant_survey_start(const RBF_dev_id_t* ids, uint8_t count);
+
+
+/**
+ * @brief Cancel the running survey and go back to the antenna in use before it
+ * 
+ * @return int 0-sucess -1-no survey running
+ */
+int rbf_ant_survey_cancel(void);
+
+
+/**
+ * @brief Diversity poll, runs the survey steps and the periodic re-evaluation
+ * 
+ * @return int 0-sucess -1-failed
+ * @note Call it periodically from an application thread
+ */
+int rbf_ant_poll(void);
+
+
+/**
+ * @brief Get the last survey result
+ * 
+ * @param result Survey result
+ * @return int 0-sucess -1-no survey done yet
+ */
+int rbf_ant_result_get(rbf_ant_result_t* result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
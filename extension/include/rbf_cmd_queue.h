@@ -0,0 +1,172 @@
+/**
+ * @file rbf_cmd_queue.h
+ * @brief Coalescing downlink command queue: only the latest command per device and kind is sent
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+#ifndef RBF_CMD_QUEUE_H
+#define RBF_CMD_QUEUE_H
+
+#include <stdint.h>
+#include "rbf_api.h"
+#include "rbf_relay.h"
+#include "rbf_wall_switch.h"
+#include "rbf_smartplug.h"
+#include "rbf_keypad.h"
+#include "rbf_pir.h"
+#include "rbf_temphumi.h"
+#include "rbf_sounder.h"
+#include "rbf_indoor_siren.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#ifndef RBF_CMD_QUEUE_MAX
+#define RBF_CMD_QUEUE_MAX               (32)     /**< Maximum number of (device, kind) entries */
+#endif
+
+#ifndef RBF_CMD_QUEUE_BURST
+#define RBF_CMD_QUEUE_BURST             (4)      /**< Commands sent by one rbf_cmd_queue_poll() at most */
+#endif
+
+#ifndef RBF_CMD_QUEUE_RETRIES
+#define RBF_CMD_QUEUE_RETRIES           (3)      /**< Failed sends of a command retried by the next polls */
+#endif
+
+/**
+ * @brief Time limit of a command in flight, 0 - none
+ * 
+ * A command stays in flight until its device is seen, so the next command for it is not sent
+ * before the device could take it. A device off the air keeps its commands in flight: set a
+ * limit to release them, well above the heartbeat interval of the devices.
+ */
+#ifndef RBF_CMD_QUEUE_HOLD_MS
+#define RBF_CMD_QUEUE_HOLD_MS           (0)
+#endif
+
+
+/**
+ * @brief Command kind
+ * 
+ */
+typedef enum
+{
+    RBF_CMD_RELAY_CTRL = 0,         /**< rbf_relay_ctrl(), also ended by the output status */
+    RBF_CMD_WALL_SWITCH_CTRL,       /**< rbf_wall_switch_ctrl(), also ended by the output status */
+    RBF_CMD_SMARTPLUG_CTRL,         /**< rbf_smartplug_ctrl(), also ended by the output status */
+    RBF_CMD_KEYPAD_SET,             /**< rbf_keypad_set() */
+    RBF_CMD_PIR_SET,                /**< rbf_pir_set() */
+    RBF_CMD_TEMP_HUMI_SET,          /**< rbf_temp_humi_set() */
+    RBF_CMD_SOUNDER_VOLUME,         /**< rbf_sounder_volume_set() */
+    RBF_CMD_INDOOR_SIREN_VOLUME,    /**< rbf_indoor_siren_volume_set() */
+    RBF_CMD_LED_INDICATE,           /**< rbf_device_led_indicate_set() */
+    RBF_CMD_KIND_MAX
+}rbf_cmd_kind_t;
+
+
+/**
+ * @brief Downlink command
+ * 
+ */
+typedef struct
+{
+    rbf_cmd_kind_t kind;    /**< Command kind */
+    RBF_dev_id_t id;        /**< Target device, the category is only used by RBF_CMD_LED_INDICATE */
+    union
+    {
+        rbf_relay_ctrl_t relay;
+        rbf_wall_switch_ctrl_t wall_switch;
+        rbf_smartplug_ctrl_t smartplug;
+        rbf_keypad_settings_t keypad;
+        rbf_pir_config_t pir;
+        rbf_temp_humi_config_t temp_humi;
+        RBF_sounder_volume_t sounder_volume;
+        RBF_indoor_siren_volume_t indoor_siren_volume;
+        RBF_led_indicate_t led_indicate;
+    }param;                 /**< Command parameter of the kind */
+}rbf_cmd_t;
+
+
+/**
+ * @brief Queue statistics
+ * 
+ */
+typedef struct
+{
+    uint32_t queued;        /**< Commands put in the queue */
+    uint32_t superseded;    /**< Commands replaced by a later one before being sent */
+    uint32_t sent;          /**< Commands sent */
+    uint32_t failed;        /**< Sends that failed */
+    uint32_t dropped;       /**< Commands given up after RBF_CMD_QUEUE_RETRIES failed sends */
+    uint32_t cancelled;     /**< Toggles cancelled by another toggle before being sent, counted per command */
+    uint32_t confirmed;     /**< Commands in flight ended by a heartbeat or an output status of their device */
+    uint32_t expired;       /**< Commands in flight released by RBF_CMD_QUEUE_HOLD_MS */
+    uint16_t pending;       /**< Commands waiting in the queue */
+}rbf_cmd_queue_stats_t;
+
+
+/**
+ * @brief Send a command right away
+ * 
+ * @param cmd Command
+ * @return int 0-sucess -1-failed
+ */
+int rbf_cmd_send(const rbf_cmd_t* cmd);
+
+
+/**
+ * @brief Initialize the queue
+ * 
+ * @return int 0-sucess -1-failed
+ * @note Commands in flight are ended through rbf_observer: wrap the callback functions clusters of
+ * the target devices with rbf_observer_wrap_*() before registering them. A command in flight ends
+ * on the next heartbeat of its device, matched on category and registration number, and an
+ * output control also on an output status of its kind.
+ */
+int rbf_cmd_queue_init(void);
+
+
+/**
+ * @brief Queue a command
+ * 
+ * A pending command of the same kind for the same device is replaced. While a command is in
+ * flight, the next one of the same kind and device waits, and is dropped if it asks for the
+ * same thing. Toggles are relative and never dropped that way: a toggle after a pending on/off
+ * inverts it, and two pending toggles cancel out.
+ * 
+ * @param cmd Command, copied
+ * @return int 0-sucess -1-queue full
+ */
+int rbf_cmd_queue_put(const rbf_cmd_t* cmd);
+
+
+/**
+ * @brief Queue poll, sends up to RBF_CMD_QUEUE_BURST commands in the order they were queued
+ * 
+ * A command whose send fails goes back to the queue at its position, merged with the command of
+ * the same kind queued since, and is retried by the next polls up to RBF_CMD_QUEUE_RETRIES times.
+ * 
+ * @return int Number of commands sent
+ * @note Call it periodically from an application thread
+ */
+int rbf_cmd_queue_poll(void);
+
+
+/**
+ * @brief Get the queue statistics
+ * 
+ * @param stats Statistics
+ * @return int 0-sucess -1-failed
+ */
+int rbf_cmd_queue_stats_get(rbf_cmd_queue_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
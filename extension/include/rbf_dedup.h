@@ -0,0 +1,90 @@
+/**
+ * @file rbf_dedup.h
+ * @brief Duplicate suppression of the input status and event retransmissions of the sub-devices
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+#ifndef RBF_DEDUP_H
+#define RBF_DEDUP_H
+
+#include <stdint.h>
+#include "rbf_api.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#ifndef RBF_DEDUP_MAX
+#define RBF_DEDUP_MAX                   (64)        /**< Cache entries, a power of 2 */
+#endif
+
+#ifndef RBF_DEDUP_WINDOW_MS
+#define RBF_DEDUP_WINDOW_MS             (3000)      /**< Default input status window, a repeated status within it is a retransmission */
+#endif
+
+#ifndef RBF_DEDUP_EVT_WINDOW_MS
+#define RBF_DEDUP_EVT_WINDOW_MS         (0)         /**< Default input event window, 0 to never suppress events */
+#endif
+
+#ifndef RBF_DEDUP_EVT_WINDOW_MAX_MS
+#define RBF_DEDUP_EVT_WINDOW_MAX_MS     (500)       /**< Longest input event window */
+#endif
+
+
+/**
+ * @brief Duplicate suppression statistics
+ * 
+ */
+typedef struct
+{
+    uint32_t checked;               /**< Input status messages, and event messages once enabled, checked */
+    uint32_t suppressed_status;     /**< Input status duplicates dropped */
+    uint32_t suppressed_evt;        /**< Input event duplicates dropped */
+    uint32_t evicted;               /**< Entries replaced within their window because the cache was full */
+}rbf_dedup_stats_t;
+
+
+/**
+ * @brief Initialize the duplicate suppression
+ * 
+ * @param window_ms Time an input status is remembered, 0 for RBF_DEDUP_WINDOW_MS
+ * @return int 0-sucess -1-failed
+ * @note Relies on rbf_observer: wrap the callback functions clusters with rbf_observer_wrap_*() before
+ * registering them. Initialize it before the other rbf_observer modules so that they do not see the
+ * duplicates. An input status is a duplicate when it repeats the last input status of the device
+ * within the window: a device going back to a previous state is always delivered. Input events are
+ * not suppressed unless enabled with rbf_dedup_evt_window_set().
+ */
+int rbf_dedup_init(uint32_t window_ms);
+
+
+/**
+ * @brief Set the input event window
+ * 
+ * @param window_ms Time an input event is remembered, 0 to never suppress events, at most
+ * RBF_DEDUP_EVT_WINDOW_MAX_MS
+ * @return int 0-sucess -1-failed
+ * @note Events such as a PIR detection or an emergency button press carry a single value, so a
+ * genuine repeat looks like a retransmission: keep the window shorter than the fastest repeat the
+ * devices can produce.
+ */
+int rbf_dedup_evt_window_set(uint32_t window_ms);
+
+
+/**
+ * @brief Get the duplicate suppression statistics
+ * 
+ * @param stats Statistics
+ * @return int 0-sucess -1-failed
+ */
+int rbf_dedup_stats_get(rbf_dedup_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,114 @@
+/**
+ * @file rbf_devtab.h
+ * @brief Registered device table, kept in step with the registrations and deletions
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+#ifndef RBF_DEVTAB_H
+#define RBF_DEVTAB_H
+
+#include <stdint.h>
+#include "rbf_api.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @brief Maximum number of devices, at most 254
+ * 
+ * The (category, number) map holds each entry index in one byte, 0xFF marking an unregistered
+ * number, and the count is a byte: a larger table would not fit them.
+ */
+#ifndef RBF_DEVTAB_MAX
+#define RBF_DEVTAB_MAX                  (254)
+#endif
+
+
+/**
+ * @brief Registered device
+ * 
+ */
+typedef struct
+{
+    RBF_dev_id_t id;                            /**< Device category and registration number */
+    RBF_dev_type_t type;                        /**< Device type, RBF_DEV_TYPE_UNKNOW if only seen in the registration information */
+    uint8_t ver[3];                             /**< Device version, 0 if unknown */
+    uint8_t sn[RBF_DEVICE_SN_LEN];              /**< Serial number, not '\0' terminated at 16 characters */
+    uint8_t mac[RBF_DEVICE_MAC_LEN];            /**< MAC address */
+}rbf_devtab_entry_t;
+
+
+/**
+ * @brief Add the device table bookkeeping to the HUB event callback functions
+ * 
+ * Successful registration responses add or replace a device, the registration information rebuilds
+ * the table: devices missing from it are removed, new ones added with an unknown type. Deletions
+ * are given with rbf_devtab_remove(). Register cbs with rbf_register_evt_callback() afterwards.
+ * 
+ * The table is for the application, e.g. to list the devices or find the type and serial number of
+ * a reporting device. The extension modules do not use it: they keep per-device state for the
+ * devices they hear from or are given, with indices that stay valid when a device is deleted.
+ * 
+ * @param cbs HUB event callback functions, modified in place
+ * @return int 0-sucess -1-failed
+ */
+int rbf_devtab_wrap(RBF_evt_callbacks_t* cbs);
+
+
+/**
+ * @brief Index of a device
+ * 
+ * The index stays valid until a device is removed.
+ * 
+ * @param id Device
+ * @return int Index in [0, rbf_devtab_count()), -1-not registered
+ */
+int rbf_devtab_index(const RBF_dev_id_t* id);
+
+
+/**
+ * @brief Get a registered device
+ * 
+ * @param id Device
+ * @param entry Device information
+ * @return int 0-sucess -1-not registered
+ */
+int rbf_devtab_get(const RBF_dev_id_t* id, rbf_devtab_entry_t* entry);
+
+
+/**
+ * @brief Get a registered device by index
+ * 
+ * @param index Index in [0, rbf_devtab_count())
+ * @param entry Device information
+ * @return int 0-sucess -1-failed
+ */
+int rbf_devtab_at(uint16_t index, rbf_devtab_entry_t* entry);
+
+
+/**
+ * @brief Number of registered devices
+ * 
+ * @return uint16_t Devices in the table
+ */
+uint16_t rbf_devtab_count(void);
+
+
+/**
+ * @brief Remove a device from the table, call it after rbf_device_delete()
+ * 
+ * @param id Device, NULL empties the table after rbf_device_delete_all()
+ * @return int 0-sucess -1-not registered
+ */
+int rbf_devtab_remove(const RBF_dev_id_t* id);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
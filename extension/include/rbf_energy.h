@@ -0,0 +1,131 @@
+/**
+ * @file rbf_energy.h
+ * @brief Energy aggregation of smartplug and wall switch heartbeats
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+#ifndef RBF_ENERGY_H
+#define RBF_ENERGY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "rbf_api.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#ifndef RBF_ENERGY_DEVICES
+#define RBF_ENERGY_DEVICES              (16)     /**< Maximum number of metered devices */
+#endif
+
+#ifndef RBF_ENERGY_HOURS
+#define RBF_ENERGY_HOURS                (24)     /**< Hourly buckets kept */
+#endif
+
+#ifndef RBF_ENERGY_DAYS
+#define RBF_ENERGY_DAYS                 (7)      /**< Daily buckets kept */
+#endif
+
+#ifndef RBF_ENERGY_MAX_GAP_S
+#define RBF_ENERGY_MAX_GAP_S            (900)    /**< Longer heartbeat gaps are not integrated */
+#endif
+
+
+/**
+ * @brief Energy bucket
+ * 
+ * Energies are in 1/1000 of the inst_power unit times one hour, e.g. mWh when the device
+ * reports inst_power in W. A daily bucket holds up to 4294967295, a 178 kW average in W. The
+ * summary total is kept on 64 bits, 32 bits would wrap after 89 days at 2 kW.
+ */
+typedef struct
+{
+    uint32_t time;          /**< Bucket start time in seconds */
+    uint32_t energy;        /**< Energy consumed in the bucket */
+    uint32_t peak;          /**< Highest inst_power reported in the bucket */
+}rbf_energy_bucket_t;
+
+
+/**
+ * @brief Device energy summary
+ * 
+ */
+typedef struct
+{
+    uint8_t no;             /**< Device registration number */
+    RBF_dev_type_t type;    /**< RBF_DEV_TYPE_SMART_PLUG or RBF_DEV_TYPE_WALL_SWITCH */
+    uint32_t power;         /**< Last inst_power */
+    rbf_energy_bucket_t hour;   /**< Current hour */
+    rbf_energy_bucket_t day;    /**< Current day */
+    uint64_t total;         /**< Energy integrated since the device was first seen */
+    uint32_t meter;         /**< Smartplug cumu_power increase since the device was first seen (0.1Kwh),
+                                 device resets and counter wraps excluded. 0 for wall switches */
+}rbf_energy_summary_t;
+
+
+/**
+ * @brief Time source of the aggregator
+ * @return uint32_t Current time in seconds. Use local time so that days start at local midnight.
+ */
+typedef uint32_t (*rbf_energy_time_t)(void);
+
+
+/**
+ * @brief Initialize the aggregator and integrate the heartbeats of all smartplugs and wall switches
+ * 
+ * @param now Time source, NULL to use the rbfsdk millisecond tick
+ * @return int 0-sucess -1-failed
+ * @note Relies on rbf_observer: wrap the smartplug and wall switch callback functions clusters with
+ * rbf_observer_wrap_smartplug() and rbf_observer_wrap_wall_switch() before registering them.
+ */
+int rbf_energy_init(rbf_energy_time_t now);
+
+
+/**
+ * @brief Get the summaries of all metered devices at once
+ * 
+ * @param summaries Returned summaries
+ * @param max_summaries Size of summaries
+ * @return int Number of summaries returned
+ */
+int rbf_energy_summary_get(rbf_energy_summary_t* summaries, uint8_t max_summaries);
+
+
+/**
+ * @brief Get the hourly buckets of a device, oldest first, the current hour last
+ * 
+ * @param no Device registration number
+ * @param buckets Returned buckets, RBF_ENERGY_HOURS entries
+ * @return int Number of buckets returned, -1-not found
+ */
+int rbf_energy_hours_get(uint8_t no, rbf_energy_bucket_t* buckets);
+
+
+/**
+ * @brief Get the daily buckets of a device, oldest first, the current day last
+ * 
+ * @param no Device registration number
+ * @param buckets Returned buckets, RBF_ENERGY_DAYS entries
+ * @return int Number of buckets returned, -1-not found
+ */
+int rbf_energy_days_get(uint8_t no, rbf_energy_bucket_t* buckets);
+
+
+/**
+ * @brief Remove a device, e.g. after it has been deleted
+ * 
+ * @param no Device registration number
+ * @return int 0-sucess -1-not found
+ */
+int rbf_energy_clear(uint8_t no);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,196 @@
+/**
+ * @file rbf_group.h
+ * @brief Named sub-device groups with precomputed broadcast lists
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+#ifndef RBF_GROUP_H
+#define RBF_GROUP_H
+
+#include <stdint.h>
+#include "rbf_api.h"
+#include "rbf_sounder.h"
+#include "rbf_indoor_siren.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#ifndef RBF_GROUP_MAX
+#define RBF_GROUP_MAX                   (8)      /**< Maximum number of groups */
+#endif
+
+#define RBF_GROUP_NAME_LEN              (16)     /**< Group name length, including '\0' */
+#define RBF_GROUP_MEMBERS_MAX           (256)    /**< Every registration number of the category */
+
+
+/**
+ * @brief Saved form of a group
+ * 
+ */
+typedef struct
+{
+    char name[RBF_GROUP_NAME_LEN];                  /**< Group name, '\0' terminated */
+    RBF_dev_cat_t cat;                              /**< Category of the members */
+    uint32_t bitmap[RBF_GROUP_MEMBERS_MAX / 32];    /**< Member no is bit no % 32 of word no / 32 */
+}rbf_group_record_t;
+
+
+/**
+ * @brief Group storage callbacks, typically backed by flash or EEPROM
+ * 
+ */
+typedef struct
+{
+    /**
+     * @brief Load the group saved in a slot
+     * @param group Group id 0 to RBF_GROUP_MAX - 1
+     * @param record Returned group
+     * @return int 0-sucess Other values-no group saved in the slot
+     */
+    int (*load)(uint8_t group, rbf_group_record_t* record);
+
+    /**
+     * @brief Save the group of a slot
+     * @param group Group id 0 to RBF_GROUP_MAX - 1
+     * @param record Group to save, NULL to erase the slot
+     * @return int 0-sucess Other values-failed
+     */
+    int (*save)(uint8_t group, const rbf_group_record_t* record);
+}rbf_group_store_t;
+
+
+/**
+ * @brief Add the group bookkeeping to the HUB event callback functions
+ * 
+ * Registration responses and registration information keep the groups in sync: a registration
+ * number given to a new device or missing from the registration information leaves all groups.
+ * Register cbs with rbf_register_evt_callback() afterwards.
+ * 
+ * @param cbs HUB event callback functions, modified in place
+ * @return int 0-sucess -1-failed
+ */
+int rbf_group_wrap(RBF_evt_callbacks_t* cbs);
+
+
+/**
+ * @brief Restore the saved groups and save every later change
+ * 
+ * Replaces all groups with the ones loaded from store, group ids are kept. Afterwards a created,
+ * destroyed or changed group is saved in the thread making the change, after the group lock is
+ * released. Call it after rbf_group_wrap() and before rbf_register_evt_callback(), the
+ * registration information then drops the members deleted while the hub was off.
+ * 
+ * @param store Group storage callbacks, copied
+ * @return int 0-sucess -1-failed
+ */
+int rbf_group_restore(const rbf_group_store_t* store);
+
+
+/**
+ * @brief Create a group, e.g. a zone or a partition
+ * 
+ * @param name Group name, at most RBF_GROUP_NAME_LEN - 1 characters, unique
+ * @param cat Category of the members
+ * @return int Group id, -1-failed
+ */
+int rbf_group_create(const char* name, RBF_dev_cat_t cat);
+
+
+/**
+ * @brief Find a group by name
+ * 
+ * @param name Group name
+ * @return int Group id, -1-not found
+ */
+int rbf_group_find(const char* name);
+
+
+/**
+ * @brief Destroy a group
+ * 
+ * @param group Group id
+ * @return int 0-sucess -1-failed
+ */
+int rbf_group_destroy(int group);
+
+
+/**
+ * @brief Add a device to a group
+ * 
+ * @param group Group id
+ * @param no Device registration number
+ * @return int 0-sucess -1-failed
+ */
+int rbf_group_add(int group, uint8_t no);
+
+
+/**
+ * @brief Remove a device from a group
+ * 
+ * @param group Group id
+ * @param no Device registration number
+ * @return int 0-sucess -1-failed
+ */
+int rbf_group_remove(int group, uint8_t no);
+
+
+/**
+ * @brief Get the members of a group
+ * 
+ * @param group Group id
+ * @param no_list Returned registration numbers, ascending
+ * @param max_count Size of no_list
+ * @return int Number of members returned, -1-failed
+ */
+int rbf_group_members_get(int group, uint8_t* no_list, uint16_t max_count);
+
+
+/**
+ * @brief Remove a device from all groups, call it after rbf_device_delete()
+ * 
+ * @param id Sub-device ID
+ * @return int 0-sucess -1-failed
+ */
+int rbf_group_forget(const RBF_dev_id_t* id);
+
+
+/**
+ * @brief Broadcast a sounder control to the members of a group
+ * 
+ * @param group Group id, RBF_DEV_SOUNDER category
+ * @param param Sounder control parameters
+ * @return int 0-sucess -1-failed
+ * @note Groups larger than the broadcast count limit are sent in several broadcasts
+ */
+int rbf_group_sounder_control(int group, RBF_sounder_param_t* param);
+
+
+/**
+ * @brief Broadcast an indoor siren control to the members of a group
+ * 
+ * @param group Group id, RBF_DEV_SOUNDER category
+ * @param param Indoor siren control parameters
+ * @return int 0-sucess -1-failed
+ */
+int rbf_group_indoor_siren_control(int group, RBF_indoor_siren_param_t* param);
+
+
+/**
+ * @brief Arm or disarm the members of a group
+ * 
+ * @param group Group id, RBF_DEV_IO category
+ * @param status Arming/disarming status
+ * @return int 0-sucess -1-failed
+ */
+int rbf_group_io_alarm_set(int group, RBF_io_alarm_status_t status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,124 @@
+/**
+ * @file rbf_heartbeat.h
+ * @brief Heartbeat load: measured and planned heartbeat intervals, channel utilization estimate
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+#ifndef RBF_HEARTBEAT_H
+#define RBF_HEARTBEAT_H
+
+#include <stdint.h>
+#include "rbf_api.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#ifndef RBF_HEARTBEAT_MAX
+#define RBF_HEARTBEAT_MAX               (254)       /**< Maximum number of tracked devices, at most 254 */
+#endif
+
+#ifndef RBF_HEARTBEAT_AIRTIME_US
+#define RBF_HEARTBEAT_AIRTIME_US        (10000)     /**< Channel time of one heartbeat without rbf_observer frame airtime model */
+#endif
+
+
+/**
+ * @brief Heartbeat load of a device type
+ * 
+ */
+typedef struct
+{
+    uint16_t devices;           /**< Devices of the type heard */
+    uint32_t measured_ms;       /**< Average heartbeat gap measured, 0 if unknown */
+    uint32_t planned_s;         /**< Planned heartbeat interval, 0 if none */
+    uint16_t measured_permille; /**< Channel utilization of the measured heartbeats in 0.1 % */
+    uint16_t planned_permille;  /**< Channel utilization with the planned intervals in 0.1 % */
+}rbf_heartbeat_type_load_t;
+
+
+/**
+ * @brief Heartbeat load
+ * 
+ */
+typedef struct
+{
+    rbf_heartbeat_type_load_t types[RBF_DEV_TYPE_UNKNOW];   /**< Load per device type */
+    uint16_t devices;           /**< Devices heard */
+    uint32_t frames_per_hour;   /**< Measured heartbeat frames per hour */
+    uint16_t measured_permille; /**< Channel utilization of the measured heartbeats in 0.1 % */
+    uint16_t planned_permille;  /**< Channel utilization with the planned intervals in 0.1 %, measured gap for the devices without plan */
+}rbf_heartbeat_load_t;
+
+
+/**
+ * @brief Initialize the heartbeat load tracking
+ * 
+ * @return int 0-sucess -1-failed
+ * @note Relies on rbf_observer: wrap the callback functions clusters with rbf_observer_wrap_*()
+ * before registering them.
+ */
+int rbf_heartbeat_init(void);
+
+
+/**
+ * @brief Plan the heartbeat interval of a device type
+ * 
+ * @param type Device type
+ * @param seconds Heartbeat interval, 0 removes the plan
+ * @return int 0-sucess -1-failed
+ * @note The public API has no command to change the heartbeat cadence of the devices: the plan is
+ * the interval the devices are configured with, used for the utilization estimate and by
+ * rbf_heartbeat_supervision_get()
+ */
+int rbf_heartbeat_plan_set(RBF_dev_type_t type, uint32_t seconds);
+
+
+/**
+ * @brief Plan the heartbeat interval of a device, overrides the plan of its type
+ * 
+ * @param id Device
+ * @param seconds Heartbeat interval, 0 to use the plan of its type
+ * @return int 0-sucess -1-device not heard yet or failed
+ */
+int rbf_heartbeat_device_plan_set(const RBF_dev_id_t* id, uint32_t seconds);
+
+
+/**
+ * @brief Get the heartbeat load
+ * 
+ * The airtime of a heartbeat comes from the rbf_observer frame airtime model installed by
+ * rbf_airtime_init() for the band, RBF_HEARTBEAT_AIRTIME_US without it. Both are estimates,
+ * the heartbeat frame length RBF_OBSERVER_HEARTBEAT_LEN is not published by the radio library.
+ * 
+ * @param load Heartbeat load
+ * @return int 0-sucess -1-failed
+ */
+int rbf_heartbeat_load_get(rbf_heartbeat_load_t* load);
+
+
+/**
+ * @brief Get the supervision interval of every device type: misses planned heartbeat intervals
+ * 
+ * @code
+ * uint32_t seconds[RBF_DEV_TYPE_UNKNOW];
+ * if (0 == rbf_heartbeat_supervision_get(3, seconds)) {
+ *     rbf_supervision_intervals_set(seconds);
+ * }
+ * @endcode
+ * 
+ * @param misses Heartbeats a device may miss before going offline
+ * @param seconds Interval per device type, 0 for the types without plan
+ * @return int 0-sucess -1-failed, seconds is not written
+ */
+int rbf_heartbeat_supervision_get(uint8_t misses, uint32_t seconds[RBF_DEV_TYPE_UNKNOW]);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
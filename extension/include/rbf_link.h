@@ -0,0 +1,134 @@
+/**
+ * @file rbf_link.h
+ * @brief Per-device link quality: RSSI statistics and heartbeat loss estimate
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+#ifndef RBF_LINK_H
+#define RBF_LINK_H
+
+#include <stdint.h>
+#include "rbf_api.h"
+#include "rbf_time.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @brief Maximum number of tracked devices
+ * 
+ * Devices heard while the table is full are not tracked and are counted by
+ * rbf_link_untracked_get(). Raise it up to the number of registered devices, 254 per category.
+ */
+#ifndef RBF_LINK_MAX
+#define RBF_LINK_MAX                    (64)
+#endif
+
+#ifndef RBF_LINK_GAP_MAX
+#define RBF_LINK_GAP_MAX                (8)         /**< Longer heartbeat gaps, in periods, are outages and not counted as loss */
+#endif
+
+#define RBF_LINK_BUCKETS                (16)        /**< RSSI histogram buckets */
+#define RBF_LINK_BUCKET_DBM             (5)         /**< RSSI histogram bucket width */
+#define RBF_LINK_BUCKET_MIN             (-115)      /**< Lower edge of the first bucket, lower RSSI fall in it */
+
+
+/**
+ * @brief Device link statistics
+ * 
+ */
+typedef struct
+{
+    RBF_dev_id_t id;            /**< Device */
+    RBF_dev_type_t type;        /**< Device type */
+    int32_t last;               /**< Last RSSI */
+    int32_t ewma;               /**< RSSI moving average, weight 1/8 */
+    int32_t min;                /**< Lowest RSSI */
+    int32_t max;                /**< Highest RSSI */
+    int32_t p10;                /**< 10th percentile RSSI, bucket precision */
+    int32_t p50;                /**< Median RSSI, bucket precision */
+    int32_t p90;                /**< 90th percentile RSSI, bucket precision */
+    uint32_t received;          /**< Heartbeats received */
+    uint32_t missed;            /**< Heartbeats estimated missed from the heartbeat gaps */
+    uint8_t loss_percent;       /**< missed / (received + missed) */
+    uint32_t period_ms;         /**< Heartbeat period, configured or learned, 0 if not known yet */
+    rbf_time_t last_ms;         /**< Time of the last heartbeat */
+}rbf_link_stats_t;
+
+
+/**
+ * @brief Initialize the link tracker
+ * 
+ * @return int 0-sucess -1-failed
+ * @note Relies on rbf_observer: wrap the callback functions clusters with rbf_observer_wrap_*()
+ * before registering them. Devices are tracked from their first heartbeat. A heartbeat less than
+ * 1 s after the previous one of the device is a retransmission and is not counted.
+ */
+int rbf_link_init(void);
+
+
+/**
+ * @brief Set the heartbeat period of a device type
+ * 
+ * Without it, the period is learned as the shortest heartbeat gap of each device over its last
+ * 16 heartbeats.
+ * 
+ * @param type Device type
+ * @param seconds Heartbeat period, 0 to learn it
+ * @return int 0-sucess -1-failed
+ */
+int rbf_link_period_set(RBF_dev_type_t type, uint32_t seconds);
+
+
+/**
+ * @brief Get the link statistics of a device
+ * 
+ * @param id Device
+ * @param stats Statistics
+ * @return int 0-sucess -1-not tracked
+ */
+int rbf_link_get(const RBF_dev_id_t* id, rbf_link_stats_t* stats);
+
+
+/**
+ * @brief Get the weak links, weakest average RSSI first
+ * 
+ * A link is weak when its average RSSI is below rssi_threshold or its loss reaches loss_threshold.
+ * 
+ * @param rssi_threshold RSSI threshold
+ * @param loss_threshold Loss threshold in percent, 0 to ignore the loss
+ * @param stats Statistics of the weak links
+ * @param max_count Size of stats
+ * @return int Number of weak links returned
+ */
+int rbf_link_weak_get(int32_t rssi_threshold, uint8_t loss_threshold, rbf_link_stats_t* stats, uint8_t max_count);
+
+
+/**
+ * @brief Clear the statistics of a device, call it after rbf_device_delete()
+ * 
+ * @param id Device, NULL clears all
+ * @return int 0-sucess -1-not tracked
+ */
+int rbf_link_clear(const RBF_dev_id_t* id);
+
+
+/**
+ * @brief Get the number of devices heard but not tracked because RBF_LINK_MAX devices are tracked
+ * 
+ * A device leaves the count once it is tracked or cleared.
+ * 
+ * @return int Number of untracked devices, 0 if every device heard is tracked
+ */
+int rbf_link_untracked_get(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,92 @@
+/**
+ * @file rbf_mailbox.h
+ * @brief Sleepy device mailbox: downlinks are sent when the device reports
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+#ifndef RBF_MAILBOX_H
+#define RBF_MAILBOX_H
+
+#include <stdint.h>
+#include "rbf_cmd_queue.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#ifndef RBF_MAILBOX_MAX
+#define RBF_MAILBOX_MAX                 (32)        /**< Maximum number of staged commands */
+#endif
+
+#ifndef RBF_MAILBOX_TTL_MS
+#define RBF_MAILBOX_TTL_MS              (86400000)  /**< Staged commands older than this are dropped */
+#endif
+
+
+/**
+ * @brief Mailbox statistics
+ * 
+ */
+typedef struct
+{
+    uint32_t staged;            /**< Commands staged */
+    uint32_t superseded;        /**< Staged commands replaced by a later one */
+    uint32_t delivered;         /**< Commands sent in a transmit window */
+    uint32_t failed;            /**< Sends that failed, the command stays staged */
+    uint32_t expired;           /**< Commands dropped after RBF_MAILBOX_TTL_MS */
+    uint32_t windows;           /**< Device reports that found staged commands */
+    uint8_t hit_percent;        /**< delivered / (delivered + expired) */
+    uint32_t delay_avg_ms;      /**< Average staging to delivery delay */
+    uint32_t delay_max_ms;      /**< Longest staging to delivery delay */
+    uint16_t pending;           /**< Commands staged now */
+}rbf_mailbox_stats_t;
+
+
+/**
+ * @brief Initialize the mailbox
+ * 
+ * @return int 0-sucess -1-failed
+ * @note Relies on rbf_observer: wrap the callback functions clusters of the battery devices with
+ * rbf_observer_wrap_*() before registering them. Any heartbeat, input, alarm or key message of a
+ * device opens its transmit window.
+ */
+int rbf_mailbox_init(void);
+
+
+/**
+ * @brief Stage a command until the device reports
+ * 
+ * A staged command of the same kind for the same device is replaced.
+ * 
+ * @param cmd Command, copied
+ * @return int 0-sucess -1-mailbox full
+ */
+int rbf_mailbox_stage(const rbf_cmd_t* cmd);
+
+
+/**
+ * @brief Drop a staged command
+ * 
+ * @param cmd Command kind and device to drop, the parameter is ignored
+ * @return int 0-sucess -1-not found
+ */
+int rbf_mailbox_cancel(const rbf_cmd_t* cmd);
+
+
+/**
+ * @brief Get the mailbox statistics
+ * 
+ * @param stats Statistics
+ * @return int 0-sucess -1-failed
+ */
+int rbf_mailbox_stats_get(rbf_mailbox_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
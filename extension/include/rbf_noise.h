@@ -0,0 +1,132 @@
+/**
+ * @file rbf_noise.h
+ * @brief Background noise sampling, noise history and jamming confidence
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+#ifndef RBF_NOISE_H
+#define RBF_NOISE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "rbf_api.h"
+#include "rbf_time.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#ifndef RBF_NOISE_BUCKETS
+#define RBF_NOISE_BUCKETS               (24)        /**< Number of history buckets */
+#endif
+
+#ifndef RBF_NOISE_BUCKET_MS
+#define RBF_NOISE_BUCKET_MS             (300000)    /**< History bucket length, 24 x 5 min by default */
+#endif
+
+#ifndef RBF_NOISE_PERIOD_DEFAULT
+#define RBF_NOISE_PERIOD_DEFAULT        (10000)     /**< Default sampling period */
+#endif
+
+#ifndef RBF_NOISE_JAMMING_DEFAULT
+#define RBF_NOISE_JAMMING_DEFAULT       (-80)       /**< Default jamming noise level in dBm */
+#endif
+
+#define RBF_NOISE_WINDOW                (32)        /**< Samples used for the jamming confidence */
+
+
+/**
+ * @brief Noise history bucket
+ * 
+ */
+typedef struct
+{
+    rbf_time_t time;        /**< Bucket start */
+    uint16_t count;         /**< Samples in the bucket, 0 if the bucket has no sample */
+    uint16_t jammed;        /**< Samples at or above the jamming level */
+    int16_t min;            /**< Lowest real-time noise */
+    int16_t max;            /**< Highest real-time noise */
+    int16_t avg;            /**< Average real-time noise */
+}rbf_noise_bucket_t;
+
+
+/**
+ * @brief Noise summary
+ * 
+ */
+typedef struct
+{
+    uint32_t samples;           /**< Samples received */
+    uint32_t lost;              /**< Requests without response */
+    int32_t realtime;           /**< Last real-time noise */
+    int32_t avg;                /**< Last average noise reported by the hub */
+    int32_t min;                /**< Lowest real-time noise over the history */
+    int32_t max;                /**< Highest real-time noise over the history */
+    int32_t history_avg;        /**< Average real-time noise over the history */
+    int32_t trend;              /**< Noise trend over the history in 0.1 dB per hour */
+    uint8_t confidence;         /**< Jamming confidence in percent, share of the last RBF_NOISE_WINDOW samples at or above the jamming level */
+    bool hub_jamming;           /**< Last jamming state reported by the hub */
+    uint32_t hub_jamming_count; /**< Jamming reports of the hub */
+    rbf_time_t last_ms;         /**< Time of the last sample */
+}rbf_noise_summary_t;
+
+
+/**
+ * @brief Add the noise sampler to the HUB event callback functions
+ * 
+ * The noise responses and the jamming reports are recorded, then given to the application
+ * callbacks. Register cbs with rbf_register_evt_callback() afterwards.
+ * 
+ * @param cbs HUB event callback functions, modified in place
+ * @return int 0-sucess -1-failed
+ */
+int rbf_noise_wrap(RBF_evt_callbacks_t* cbs);
+
+
+/**
+ * @brief Set the sampling
+ * 
+ * @param period_ms Sampling period, 0 stops the sampling
+ * @param jamming_rssi Noise level counted as jamming in dBm, match it to the jamming_threshold
+ * given to rbf_set_hub()
+ * @return int 0-sucess -1-failed
+ */
+int rbf_noise_config_set(uint32_t period_ms, int32_t jamming_rssi);
+
+
+/**
+ * @brief Noise poll, sends a rbf_get_hub_noise() request when a sample is due
+ * 
+ * @return int 1-request sent 0-nothing to do
+ * @note Call it periodically from an application thread. The request is asynchronous, one at a time.
+ */
+int rbf_noise_poll(void);
+
+
+/**
+ * @brief Get the noise summary
+ * 
+ * @param summary Noise summary
+ * @return int 0-sucess -1-failed
+ */
+int rbf_noise_summary_get(rbf_noise_summary_t* summary);
+
+
+/**
+ * @brief Get the noise history, oldest bucket first
+ * 
+ * @param buckets History buckets
+ * @param max_count Size of buckets
+ * @return int Number of buckets returned
+ */
+int rbf_noise_buckets_get(rbf_noise_bucket_t* buckets, uint8_t max_count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
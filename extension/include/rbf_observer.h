@@ -0,0 +1,358 @@
+/**
+ * @file rbf_observer.h
+ * @brief Sub-device message observer: lets extension modules see every device callback
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+#ifndef RBF_OBSERVER_H
+#define RBF_OBSERVER_H
+
+#include <stdint.h>
+#include "rbf_api.h"
+#include "rbf_time.h"
+#include "rbf_magnetic.h"
+#include "rbf_pir.h"
+#include "rbf_water_leak.h"
+#include "rbf_emergency_button.h"
+#include "rbf_smoke.h"
+#include "rbf_temphumi.h"
+#include "rbf_smartplug.h"
+#include "rbf_relay.h"
+#include "rbf_wall_switch.h"
+#include "rbf_sounder.h"
+#include "rbf_indoor_siren.h"
+#include "rbf_keypad.h"
+#include "rbf_keyfob.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#ifndef RBF_OBSERVER_MAX
+#define RBF_OBSERVER_MAX                 (16)    /**< Maximum number of observers, the extension modules add up to 14 */
+#endif
+
+/**
+ * @brief Payload length of a heartbeat frame used by the airtime estimates
+ * 
+ * An estimate, not derived from the radio library, which documents neither its frame format nor
+ * the heartbeat length. The rbf_*_heartbeat_t structures are decoded data, from a battery level
+ * to 20 bytes of smartplug readings, not the frame. Define it to the length measured on the air
+ * for accurate utilization figures.
+ */
+#ifndef RBF_OBSERVER_HEARTBEAT_LEN
+#define RBF_OBSERVER_HEARTBEAT_LEN       (12)
+#endif
+
+#define RBF_OBSERVER_PASS                (0)     /**< Deliver the message to the next observers and to the application */
+#define RBF_OBSERVER_DROP                (1)     /**< Stop the delivery of the message */
+
+
+/**
+ * @brief Sub-device message type
+ * 
+ */
+typedef enum
+{
+    RBF_OBSERVER_MSG_HEARTBEAT = 0,     /**< Heartbeat, payload is the rbf_*_heartbeat_t of the device */
+    RBF_OBSERVER_MSG_INPUT_STATUS,      /**< Input status, payload is the rbf_*_input_status_t of the device */
+    RBF_OBSERVER_MSG_INPUT_EVT,         /**< Input event, value is the rbf_*_input_evt_t of the device */
+    RBF_OBSERVER_MSG_ALARM,             /**< Keypad alarm, payload is rbf_keypad_alarm_status_t */
+    RBF_OBSERVER_MSG_KEY,               /**< Key fob: value is the key. Keypad: payload is input_keys, value is input_count */
+    RBF_OBSERVER_MSG_OUTPUT_STATUS,     /**< Output status, payload is the rbf_*_output_status_t of the device */
+}rbf_observer_msg_type_t;
+
+
+/**
+ * @brief Sub-device message
+ * 
+ */
+typedef struct 
+{
+    rbf_observer_msg_type_t msg;    /**< Message type */
+    RBF_dev_type_t type;            /**< Device type, emergency buttons are reported as RBF_DEV_TYPE_FIXED_PA */
+    RBF_dev_id_t id;                /**< Device category and registration number */
+    rbf_time_t time;                /**< Arrival time in milliseconds */
+    int32_t rssi;                   /**< Device RSSI, heartbeat only */
+    const void* payload;            /**< Message structure as delivered to the application callback, may be NULL */
+    uint32_t value;                 /**< Message value, see rbf_observer_msg_type_t */
+}rbf_observer_msg_t;
+
+
+/**
+ * @brief Storage for any message payload
+ * 
+ */
+typedef union
+{
+    rbf_magnetic_heartbeat_t magnetic_heartbeat;
+    rbf_magnetic_input_status_t magnetic_input_status;
+    rbf_pir_heartbeat_t pir_heartbeat;
+    rbf_pir_input_status_t pir_input_status;
+    rbf_water_leak_heartbeat_t water_leak_heartbeat;
+    rbf_water_leak_input_status_t water_leak_input_status;
+    rbf_emergency_button_heartbeat_t emergency_button_heartbeat;
+    rbf_smoke_heartbeat_t smoke_heartbeat;
+    rbf_smoke_input_status_t smoke_input_status;
+    rbf_temp_humi_heartbeat_t temp_humi_heartbeat;
+    rbf_temp_humi_status_t temp_humi_status;
+    rbf_smartplug_heartbeat_t smartplug_heartbeat;
+    rbf_smartplug_output_status_t smartplug_output_status;
+    rbf_relay_heartbeat_t relay_heartbeat;
+    rbf_relay_output_status_t relay_output_status;
+    rbf_wall_switch_heartbeat_t wall_switch_heartbeat;
+    rbf_wall_switch_output_status_t wall_switch_output_status;
+    rbf_sounder_heartbeat_t sounder_heartbeat;
+    rbf_sounder_input_status_t sounder_input_status;
+    rbf_indoor_siren_heartbeat_t indoor_siren_heartbeat;
+    rbf_indoor_siren_input_status_t indoor_siren_input_status;
+    rbf_keypad_heartbeat_t keypad_heartbeat;
+    rbf_keypad_alarm_status_t keypad_alarm_status;
+    uint8_t keypad_keys[32];
+    rbf_keyfob_heartbeat_t keyfob_heartbeat;
+}rbf_observer_payload_t;
+
+
+/**
+ * @brief Observer callback
+ * @param msg Sub-device message
+ * @param arg Argument given to rbf_observer_add()
+ * @return int RBF_OBSERVER_PASS or RBF_OBSERVER_DROP
+ * @note Called from the rbfsdk thread before the application callback, keep it short
+ */
+typedef int (*rbf_observer_handle_t)(const rbf_observer_msg_t* msg, void* arg);
+
+
+/**
+ * @brief Add an observer, observers are called in the order they were added
+ * 
+ * @param handle Observer callback
+ * @param arg Argument passed to handle
+ * @return int 0-sucess -1-failed, RBF_OBSERVER_MAX observers already added
+ * @note Add observers before registering the observed callback clusters to rbfsdk
+ */
+int rbf_observer_add(rbf_observer_handle_t handle, void* arg);
+
+
+/**
+ * @brief Remove an observer
+ * 
+ * @param handle Observer callback
+ * @param arg Argument given to rbf_observer_add()
+ * @return int 0-sucess -1-not found
+ */
+int rbf_observer_remove(rbf_observer_handle_t handle, void* arg);
+
+
+/**
+ * @brief Size of the payload of a message
+ * 
+ * @param msg Sub-device message
+ * @return uint32_t Payload size, 0 if the message has no payload
+ */
+uint32_t rbf_observer_payload_size(const rbf_observer_msg_t* msg);
+
+
+/**
+ * @brief Deliver a message to the application callback, the observers are not called
+ * 
+ * Lets an observer that dropped a message hand it to the application later, from another thread.
+ * 
+ * @param msg Sub-device message, the payload is given to the callback as is
+ * @return int Return value of the application callback, 0 if there is none
+ */
+int rbf_observer_deliver(const rbf_observer_msg_t* msg);
+
+
+/**
+ * @brief Frame sent by an extension module
+ * 
+ */
+typedef enum
+{
+    RBF_OBSERVER_TX_P2P = 0,        /**< Point to point control or setting */
+    RBF_OBSERVER_TX_BROADCAST,      /**< Broadcast control */
+}rbf_observer_tx_t;
+
+
+/**
+ * @brief Sent frame hook
+ * @param tx Frame kind
+ * @param len Frame payload length
+ */
+typedef void (*rbf_observer_tx_handle_t)(rbf_observer_tx_t tx, uint16_t len);
+
+
+/**
+ * @brief Install the sent frame hook, e.g. by rbf_airtime_init()
+ * 
+ * A single hook of its own, it does not take an observer slot.
+ * 
+ * @param handle Hook, NULL to remove it
+ * @return int 0-sucess
+ */
+int rbf_observer_tx_set(rbf_observer_tx_handle_t handle);
+
+
+/**
+ * @brief Report a frame sent by an extension module to the hook, nothing is done without hook
+ * 
+ * @param tx Frame kind
+ * @param len Frame payload length
+ */
+void rbf_observer_tx(rbf_observer_tx_t tx, uint16_t len);
+
+
+/**
+ * @brief Frame airtime model
+ * @param len Frame payload length
+ * @return uint32_t Airtime in microseconds on the current band
+ */
+typedef uint32_t (*rbf_observer_airtime_t)(uint16_t len);
+
+
+/**
+ * @brief Install the frame airtime model, e.g. by rbf_airtime_init()
+ * 
+ * A single model of its own, it does not take an observer slot.
+ * 
+ * @param airtime Model, NULL to remove it
+ * @return int 0-sucess
+ */
+int rbf_observer_airtime_set(rbf_observer_airtime_t airtime);
+
+
+/**
+ * @brief Airtime of a frame from the installed model
+ * 
+ * @param len Frame payload length
+ * @return uint32_t Airtime in microseconds, 0 without model
+ */
+uint32_t rbf_observer_airtime_us(uint16_t len);
+
+
+/**
+ * @brief Observe the magnetic callback functions cluster
+ * 
+ * @param cbs Magnetic callback functions cluster, modified in place
+ * @return int 0-sucess -1-failed
+ */
+int rbf_observer_wrap_magnetic(rbf_magnetic_callbacks_t* cbs);
+
+
+/**
+ * @brief Observe the pir callback functions cluster
+ * 
+ * @param cbs Pir callback functions cluster, modified in place
+ * @return int 0-sucess -1-failed
+ */
+int rbf_observer_wrap_pir(rbf_pir_callbacks_t* cbs);
+
+
+/**
+ * @brief Observe the water leak callback functions cluster
+ * 
+ * @param cbs Water leak callback functions cluster, modified in place
+ * @return int 0-sucess -1-failed
+ */
+int rbf_observer_wrap_water_leak(rbf_water_leak_callbacks_t* cbs);
+
+
+/**
+ * @brief Observe the emergency button callback functions cluster
+ * 
+ * @param cbs Emergency button callback functions cluster, modified in place
+ * @return int 0-sucess -1-failed
+ */
+int rbf_observer_wrap_emergency_button(rbf_emergency_button_callbacks_t* cbs);
+
+
+/**
+ * @brief Observe the smoke callback functions cluster
+ * 
+ * @param cbs Smoke callback functions cluster, modified in place
+ * @return int 0-sucess -1-failed
+ */
+int rbf_observer_wrap_smoke(rbf_smoke_callbacks_t* cbs);
+
+
+/**
+ * @brief Observe the temp humi callback functions cluster
+ * 
+ * @param cbs Temp humi callback functions cluster, modified in place
+ * @return int 0-sucess -1-failed
+ */
+int rbf_observer_wrap_temp_humi(rbf_temp_humi_callbacks_t* cbs);
+
+
+/**
+ * @brief Observe the smartplug callback functions cluster
+ * 
+ * @param cbs Smartplug callback functions cluster, modified in place
+ * @return int 0-sucess -1-failed
+ */
+int rbf_observer_wrap_smartplug(rbf_smartplug_callbacks_t* cbs);
+
+
+/**
+ * @brief Observe the relay callback functions cluster
+ * 
+ * @param cbs Relay callback functions cluster, modified in place
+ * @return int 0-sucess -1-failed
+ */
+int rbf_observer_wrap_relay(rbf_relay_callbacks_t* cbs);
+
+
+/**
+ * @brief Observe the wall switch callback functions cluster
+ * 
+ * @param cbs Wall switch callback functions cluster, modified in place
+ * @return int 0-sucess -1-failed
+ */
+int rbf_observer_wrap_wall_switch(rbf_wall_switch_callbacks_t* cbs);
+
+
+/**
+ * @brief Observe the sounder callback functions cluster
+ * 
+ * @param cbs Sounder callback functions cluster, modified in place
+ * @return int 0-sucess -1-failed
+ */
+int rbf_observer_wrap_sounder(rbf_sounder_callbacks_t* cbs);
+
+
+/**
+ * @brief Observe the indoor siren callback functions cluster
+ * 
+ * @param cbs Indoor siren callback functions cluster, modified in place
+ * @return int 0-sucess -1-failed
+ */
+int rbf_observer_wrap_indoor_siren(rbf_indoor_siren_callbacks_t* cbs);
+
+
+/**
+ * @brief Observe the keypad callback functions cluster
+ * 
+ * @param cbs Keypad callback functions cluster, modified in place
+ * @return int 0-sucess -1-failed
+ */
+int rbf_observer_wrap_keypad(rbf_keypad_callbacks_t* cbs);
+
+
+/**
+ * @brief Observe the keyfob callback functions cluster
+ * 
+ * @param cbs Keyfob callback functions cluster, modified in place
+ * @return int 0-sucess -1-failed
+ */
+int rbf_observer_wrap_keyfob(rbf_keyfob_callbacks_t* cbs);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
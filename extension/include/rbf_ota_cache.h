@@ -0,0 +1,114 @@
+/**
+ * @file rbf_ota_cache.h
+ * @brief Read-ahead firmware cache for OTA data requests
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+#ifndef RBF_OTA_CACHE_H
+#define RBF_OTA_CACHE_H
+
+#include <stdint.h>
+#include "rbf_ota_ex.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define RBF_OTA_CACHE_LINE_SIZE_DEFAULT        (1024)   /**< Default cache line size in bytes */
+#define RBF_OTA_CACHE_LINE_COUNT_DEFAULT       (2)      /**< Default number of cache lines: double buffered */
+
+
+/**
+ * @brief Cache configuration
+ * 
+ */
+typedef struct
+{
+    uint32_t line_size;     /**< Bytes fetched from the data handle at once, 0 - RBF_OTA_CACHE_LINE_SIZE_DEFAULT */
+    uint8_t line_count;     /**< Number of cache lines, at least 2, 0 - RBF_OTA_CACHE_LINE_COUNT_DEFAULT */
+}rbf_ota_cache_cfg_t;
+
+
+/**
+ * @brief Cache statistics
+ * 
+ */
+typedef struct
+{
+    uint32_t requests;      /**< Data requests from the OTA engine */
+    uint32_t hits;          /**< Requests served from the cache only */
+    uint32_t misses;        /**< Requests that had to wait for the data handle */
+    uint32_t fetches;       /**< Data handle calls, including prefetches */
+    uint32_t prefetches;    /**< Lines read ahead by rbf_ota_cache_poll() */
+}rbf_ota_cache_stats_t;
+
+
+/**
+ * @brief Add a read-ahead cache to the hub OTA callback cluster
+ * 
+ * The data handle of cbs is replaced with the cache handle which reads whole lines from the
+ * original one. Register cbs with rbf_ota_register_evt_callback() afterwards.
+ * 
+ * @param cbs OTA callback function cluster, modified in place
+ * @param cfg Cache configuration, NULL for default
+ * @return int 0-sucess -1-failed
+ */
+int rbf_ota_cache_wrap_hub(RBF_ota_evt_callbacks_t* cbs, const rbf_ota_cache_cfg_t* cfg);
+
+
+/**
+ * @brief Add a read-ahead cache to the sub-device OTA callback cluster
+ * 
+ * Devices of the same wave share the cache, so a line is fetched once per wave.
+ * 
+ * @param cbs Sub-device OTA callback function cluster, modified in place
+ * @param cfg Cache configuration, NULL for default
+ * @return int 0-sucess -1-failed
+ */
+int rbf_ota_cache_wrap_subdev(RBF_subdev_ota_evt_callbacks_t* cbs, const rbf_ota_cache_cfg_t* cfg);
+
+
+/**
+ * @brief Drop the cached data and set the image size, call it before starting an upgrade with another image
+ * 
+ * @param target OTA engine
+ * @param fw_size Size of the next image, lines are never read past it. 0 - unknown, nothing is cached and
+ * the requests pass through to the wrapped data handle
+ * @return int 0-sucess -1-failed
+ * @note The end of an upgrade drops the cached data but keeps the size, so waves of the same image
+ * need no reset.
+ */
+int rbf_ota_cache_reset(rbf_ota_target_t target, uint32_t fw_size);
+
+
+/**
+ * @brief Cache poll, reads the line following the last served one
+ * 
+ * @return int Number of lines read ahead
+ * @note Call it from an application thread other than the rbfsdk thread, so the next
+ * line is read while the current page is on air. The cache lock is not held during the read,
+ * so the wrapped data handle may run in both threads at once and must be thread safe.
+ * Nothing is read ahead until rbf_ota_cache_reset() gives the image size. A request for the line
+ * being read ahead waits for it.
+ */
+int rbf_ota_cache_poll(void);
+
+
+/**
+ * @brief Get cache statistics
+ * 
+ * @param target OTA engine
+ * @param stats Cache statistics
+ * @return int 0-sucess -1-failed
+ */
+int rbf_ota_cache_stats_get(rbf_ota_target_t target, rbf_ota_cache_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
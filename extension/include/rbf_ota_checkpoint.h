@@ -0,0 +1,138 @@
+/**
+ * @file rbf_ota_checkpoint.h
+ * @brief Resumable hub OTA: persists the offset confirmed by the bootloader and continues from it
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+#ifndef RBF_OTA_CHECKPOINT_H
+#define RBF_OTA_CHECKPOINT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "rbf_ota.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @brief Default number of bytes between two checkpoint saves
+ * 
+ */
+#ifndef RBF_OTA_CHECKPOINT_SAVE_INTERVAL
+#define RBF_OTA_CHECKPOINT_SAVE_INTERVAL        (4096)
+#endif
+
+
+/**
+ * @brief Hub OTA checkpoint, persisted by the application
+ * 
+ */
+typedef struct
+{
+    uint32_t fw_size;           /**< Firmware size of the interrupted transfer */
+    uint32_t image_crc;         /**< Image CRC32 supplied to rbf_ota_checkpoint_start() */
+    uint32_t confirmed_offset;  /**< Firmware bytes confirmed by the bootloader */
+}rbf_ota_checkpoint_t;
+
+
+/**
+ * @brief Checkpoint storage callbacks, typically backed by flash or EEPROM
+ * 
+ */
+typedef struct
+{
+    /**
+     * @brief Load the last saved checkpoint
+     * @param checkpoint Returned checkpoint
+     * @return int 0-sucess Other values-no checkpoint saved
+     */
+    int (*load)(rbf_ota_checkpoint_t* checkpoint);
+
+    /**
+     * @brief Save the checkpoint
+     * @param checkpoint Checkpoint to save
+     * @return int 0-sucess Other values-failed
+     */
+    int (*save)(const rbf_ota_checkpoint_t* checkpoint);
+
+    /**
+     * @brief Erase the saved checkpoint
+     * @return int 0-sucess Other values-failed
+     */
+    int (*clear)(void);
+}rbf_ota_checkpoint_store_t;
+
+
+/**
+ * @brief Checkpoint information of the current or last transfer
+ * 
+ */
+typedef struct
+{
+    bool resumed;               /**< The current or last transfer started at the saved checkpoint */
+    uint32_t checkpoint_offset; /**< Confirmed offset loaded from the checkpoint */
+    uint32_t bytes_skipped;     /**< Firmware bytes the current or last transfer did not send again */
+    uint32_t bytes_skipped_total;/**< Firmware bytes not sent again since boot */
+    uint32_t resume_count;      /**< Number of resumed transfers since boot */
+}rbf_ota_checkpoint_info_t;
+
+
+/**
+ * @brief Hook checkpoint tracking into a hub OTA callback cluster
+ * 
+ * The data and event handles of cbs are replaced with checkpointing handles which
+ * forward to the original ones, with offsets in the whole image. Register cbs with
+ * rbf_ota_register_evt_callback() afterwards. Modules wrapped after this one see the
+ * offsets of the library transfer, which starts at 0 when resuming.
+ * 
+ * @param cbs OTA callback function cluster, modified in place
+ * @param store Checkpoint storage callbacks
+ * @param save_interval Bytes between two checkpoint saves, 0 - RBF_OTA_CHECKPOINT_SAVE_INTERVAL
+ * @return int 0-sucess -1-failed
+ * @par Example:
+ * @code
+ * RBF_ota_evt_callbacks_t cbs = {app_ota_data, app_ota_evt};
+ * rbf_ota_checkpoint_store_t store = {app_cp_load, app_cp_save, app_cp_clear};
+ * 
+ * rbf_ota_checkpoint_wrap(&cbs, &store, 0);
+ * rbf_ota_register_evt_callback(&cbs);
+ * rbf_ota_checkpoint_start(fw_size, fw_crc32);
+ * @endcode
+ */
+int rbf_ota_checkpoint_wrap(RBF_ota_evt_callbacks_t* cbs, rbf_ota_checkpoint_store_t* store, uint32_t save_interval);
+
+
+/**
+ * @brief Start a hub OTA update, resuming at the saved checkpoint when it belongs to the same image
+ * 
+ * @param fw_size Firmware size
+ * @param image_crc CRC32 of the whole firmware image, used to identify the image
+ * @return int 0-sucess -1-failed
+ * @note The xmodem engine of the library always starts at block 0 and takes no start offset, so a
+ * resumed transfer is started with rbf_ota_start(fw_size - checkpoint) and its data requests are
+ * shifted by the checkpoint: the bootloader must keep the blocks it has written and append the
+ * next transfer after them. The library progress percent is then relative to the remaining bytes.
+ * The checkpoint is cleared when the upgrade completes or the bootloader refuses to start it
+ * (RBF_OTA_EVT_START_FAIL, the next start sends the whole image), and saved when it fails midway.
+ */
+int rbf_ota_checkpoint_start(uint32_t fw_size, uint32_t image_crc);
+
+
+/**
+ * @brief Get the checkpoint information
+ * 
+ * @param info Checkpoint information
+ * @return int 0-sucess -1-failed
+ */
+int rbf_ota_checkpoint_info_get(rbf_ota_checkpoint_info_t* info);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,88 @@
+/**
+ * @file rbf_ota_crc.h
+ * @brief Incremental CRC32 of the firmware image during OTA streaming
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+#ifndef RBF_OTA_CRC_H
+#define RBF_OTA_CRC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "rbf_ota_ex.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @brief Running CRC32 state of an OTA transfer
+ * 
+ */
+typedef struct 
+{
+    uint32_t crc;           /**< CRC32 of the firmware bytes [0, offset) */
+    uint32_t offset;        /**< Firmware bytes covered by crc */
+    uint32_t fw_size;       /**< Firmware size, 0 - unknown */
+    bool complete;          /**< crc covers the whole image, it is the image digest */
+}rbf_ota_crc_state_t;
+
+
+/**
+ * @brief Update a CRC32 (IEEE 802.3, zlib compatible) with more data
+ * 
+ * @param crc CRC32 of the previous data, 0 for the first call
+ * @param data Data
+ * @param len Data length
+ * @return uint32_t CRC32 of the previous data followed by data
+ */
+uint32_t rbf_crc32_update(uint32_t crc, const unsigned char* data, uint32_t len);
+
+
+/**
+ * @brief Compute the running image CRC32 in the hub OTA data handle
+ * 
+ * @param cbs OTA callback function cluster, modified in place
+ * @return int 0-sucess -1-failed
+ */
+int rbf_ota_crc_wrap_hub(RBF_ota_evt_callbacks_t* cbs);
+
+
+/**
+ * @brief Compute the running image CRC32 in the sub-device OTA data handle
+ * 
+ * @param cbs Sub-device OTA callback function cluster, modified in place
+ * @return int 0-sucess -1-failed
+ */
+int rbf_ota_crc_wrap_subdev(RBF_subdev_ota_evt_callbacks_t* cbs);
+
+
+/**
+ * @brief Reset the running CRC32 before starting an upgrade
+ * 
+ * @param target OTA engine
+ * @param fw_size Firmware size, the digest is complete once fw_size bytes are covered. 0 - unknown
+ * @return int 0-sucess -1-failed
+ * @note The state is also reset by the first data request following the end of an upgrade
+ */
+int rbf_ota_crc_reset(rbf_ota_target_t target, uint32_t fw_size);
+
+
+/**
+ * @brief Get the running CRC32 state
+ * 
+ * @param target OTA engine
+ * @param state Running CRC32 state
+ * @return int 0-sucess -1-failed
+ */
+int rbf_ota_crc_get(rbf_ota_target_t target, rbf_ota_crc_state_t* state);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,47 @@
+/**
+ * @file rbf_ota_ex.h
+ * @brief Definitions shared by the OTA extension modules
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+#ifndef RBF_OTA_EX_H
+#define RBF_OTA_EX_H
+
+#include "rbf_ota.h"
+#include "rbf_subdev_ota.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @brief OTA engine
+ * 
+ */
+typedef enum
+{
+    RBF_OTA_TARGET_HUB = 0,     /**< Hub OTA, rbf_ota_start() */
+    RBF_OTA_TARGET_SUBDEV,      /**< Sub-device OTA, rbf_subdev_ota_start() */
+    RBF_OTA_TARGET_MAX
+}rbf_ota_target_t;
+
+
+/**
+ * @brief Firmware data request handle, same signature as rbf_ota_request_upgrade_data_handle
+ * and rbf_subdev_ota_request_upgrade_data_handle
+ * @param offset Firmware offset address
+ * @param size Request data length
+ * @param data Request returned data
+ * @return int 0-sucess Other values-failed
+ */
+typedef int (*rbf_ota_data_handle_t)(unsigned int offset, unsigned int size, unsigned char* data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,93 @@
+/**
+ * @file rbf_ota_map.h
+ * @brief Memory-mapped firmware data source for OTA
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+#ifndef RBF_OTA_MAP_H
+#define RBF_OTA_MAP_H
+
+#include <stdint.h>
+#include "rbf_ota_ex.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @brief Memory-mapped firmware data source
+ * 
+ */
+typedef struct 
+{
+    /**
+     * @brief Map firmware data
+     * @param offset Firmware offset address
+     * @param len Returned number of contiguous bytes readable from the returned pointer
+     * @return const unsigned char* Pointer to the firmware data at offset, NULL-failed
+     */
+    const unsigned char* (*map)(unsigned int offset, unsigned int* len);
+
+    uint32_t fw_size;   /**< Firmware size, requests past it are padded with zeros. 0 - unknown */
+}rbf_ota_map_source_t;
+
+
+/**
+ * @brief Set the firmware data source of an OTA engine
+ * 
+ * @param target OTA engine
+ * @param source Memory-mapped data source, NULL to remove it
+ * @return int 0-sucess -1-failed
+ */
+int rbf_ota_map_set_source(rbf_ota_target_t target, const rbf_ota_map_source_t* source);
+
+
+/**
+ * @brief Set a firmware image held in one contiguous memory area (memory-mapped flash, mmap)
+ * 
+ * @param target OTA engine
+ * @param image Firmware image start address
+ * @param fw_size Firmware size
+ * @return int 0-sucess -1-failed
+ */
+int rbf_ota_map_set_image(rbf_ota_target_t target, const unsigned char* image, uint32_t fw_size);
+
+
+/**
+ * @brief Get a pointer to the firmware data, without copying it
+ * 
+ * @param target OTA engine
+ * @param offset Firmware offset address
+ * @param len Returned number of contiguous bytes readable from the returned pointer
+ * @return const unsigned char* Pointer to the firmware data at offset, NULL-failed
+ */
+const unsigned char* rbf_ota_map_get(rbf_ota_target_t target, unsigned int offset, unsigned int* len);
+
+
+/**
+ * @brief Hub OTA data handle reading from the memory-mapped source
+ * @note Set it as rbf_ota_request_upgrade_data_handle. The data is copied once, straight from
+ * the image into the OTA engine packet, there is no need for an application buffer. The library
+ * data handles only take a buffer to fill, so that copy and the library packet buffers remain:
+ * framing and CRC straight from the image need a pointer based handle in the library.
+ * rbf_ota_map_get() gives the application the zero-copy view, e.g. to verify the image.
+ * A request running past the image end is served with its tail padded with zeros.
+ */
+int rbf_ota_map_hub_data_handle(unsigned int offset, unsigned int size, unsigned char* data);
+
+
+/**
+ * @brief Sub-device OTA data handle reading from the memory-mapped source
+ * @note Set it as rbf_subdev_ota_request_upgrade_data_handle, see rbf_ota_map_hub_data_handle()
+ */
+int rbf_ota_map_subdev_data_handle(unsigned int offset, unsigned int size, unsigned char* data);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
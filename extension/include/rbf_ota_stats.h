@@ -0,0 +1,162 @@
+/**
+ * @file rbf_ota_stats.h
+ * @brief OTA throughput and ETA instrumentation
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+#ifndef RBF_OTA_STATS_H
+#define RBF_OTA_STATS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "rbf_ota_ex.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @brief OTA transfer statistics
+ * 
+ * A page time is split into the time spent in the application data handle (fetch) and the
+ * time between two data requests (link: UART for hub OTA, RF for sub-device OTA).
+ */
+typedef struct 
+{
+    bool upgrading;                 /**< Is upgrading */
+    uint8_t percent;                /**< Upgrade Progress: 0-100 */
+    uint32_t fw_size;               /**< Firmware size */
+    uint32_t bytes_transferred;     /**< Firmware bytes sent at least once */
+    uint32_t bytes_requested;       /**< Firmware bytes requested, including retransmissions */
+    uint32_t pages;                 /**< Data requests */
+    uint32_t retransmitted_pages;   /**< Data requests for firmware data already sent */
+    uint32_t fetch_last_ms;         /**< Time spent in the data handle for the last page */
+    uint32_t fetch_avg_ms;          /**< Average time spent in the data handle per page */
+    uint32_t fetch_max_ms;          /**< Maximum time spent in the data handle */
+    uint32_t link_last_ms;          /**< Round trip of the last page: from data returned to next data request */
+    uint32_t link_avg_ms;           /**< Average page round trip */
+    uint32_t link_max_ms;           /**< Maximum page round trip */
+    uint32_t bytes_per_s;           /**< Effective throughput: bytes_transferred per second */
+    uint32_t elapsed_s;             /**< Seconds since the upgrade started */
+    uint32_t eta_s;                 /**< Projected seconds to completion */
+}rbf_ota_stats_t;
+
+
+/**
+ * @brief Outcome of one sub-device of a sub-device upgrade
+ * 
+ * Pages are broadcast to every device of the upgrade and the data requests do not tell which
+ * device asked, so the transfer statistics exist per upgrade only, see rbf_ota_stats_get().
+ */
+typedef struct
+{
+    uint8_t no;                             /**< Sub-device registration number */
+    bool ended;                             /**< The upgrade of the device ended */
+    bool failed;                            /**< The device was reported in the failure responses */
+    RBF_subdev_ota_err_code_t err_code;     /**< Failure reason, when failed */
+    uint32_t elapsed_s;                     /**< Seconds from the upgrade start to its end */
+}rbf_ota_stats_dev_t;
+
+
+/**
+ * @brief Statistics reporting, called each time the progress percent changes and when the upgrade ends
+ * @param target OTA engine
+ * @param stats OTA transfer statistics
+ */
+typedef void (*rbf_ota_stats_evt_handle_t)(rbf_ota_target_t target, const rbf_ota_stats_t* stats);
+
+
+/**
+ * @brief Add instrumentation to the hub OTA callback cluster
+ * 
+ * @param cbs OTA callback function cluster, modified in place
+ * @return int 0-sucess -1-failed
+ * @note Wrap it last so that the time spent in other data handle wrappers counts as fetch time
+ */
+int rbf_ota_stats_wrap_hub(RBF_ota_evt_callbacks_t* cbs);
+
+
+/**
+ * @brief Add instrumentation to the sub-device OTA callback cluster
+ * 
+ * @param cbs Sub-device OTA callback function cluster, modified in place
+ * @return int 0-sucess -1-failed
+ * @note The upgrade ends on RBF_SUBDEV_OTA_EVT_UPGRADE_COMPLETE or RBF_SUBDEV_OTA_EVT_UPGRADE_FAIL.
+ * A RBF_SUBDEV_OTA_EVT_UPGRADE_REQUEST_TIMEOUT listing devices only ends those, and the upgrade
+ * once all the devices given to rbf_ota_stats_subdev_start() have ended.
+ */
+int rbf_ota_stats_wrap_subdev(RBF_subdev_ota_evt_callbacks_t* cbs);
+
+
+/**
+ * @brief Set the statistics reporting callback
+ * 
+ * @param handle Statistics reporting callback, NULL to disable
+ * @return int 0-sucess -1-failed
+ */
+int rbf_ota_stats_set_evt_handle(rbf_ota_stats_evt_handle_t handle);
+
+
+/**
+ * @brief Give the firmware size of an upgrade started with rbf_ota_start() or rbf_subdev_ota_start() directly
+ * 
+ * Upgrades not started with rbf_ota_stats_start() or rbf_ota_stats_subdev_start(), e.g. by
+ * rbf_ota_checkpoint or rbf_subdev_ota_campaign, are detected from their first data request at
+ * offset 0 with an unknown size: percent and eta_s stay 0 until the size is given.
+ * 
+ * @param target OTA engine
+ * @param fw_size Firmware size
+ * @return int 0-sucess -1-failed
+ */
+int rbf_ota_stats_size_set(rbf_ota_target_t target, uint32_t fw_size);
+
+
+/**
+ * @brief Start statistics of a hub OTA update and start it, replaces rbf_ota_start()
+ * 
+ * @param fw_size Firmware size
+ * @return int 0-sucess -1-failed
+ */
+int rbf_ota_stats_start(uint32_t fw_size);
+
+
+/**
+ * @brief Start statistics of a sub-device OTA update and start it, replaces rbf_subdev_ota_start()
+ * 
+ * @param cat The subdev category
+ * @param no_list The list of subdev
+ * @param count The count of no_list, up to 12
+ * @param fw_size Firmware size
+ * @return int 0-sucess -1-failed
+ */
+int rbf_ota_stats_subdev_start(uint8_t cat, uint8_t* no_list, uint8_t count, uint32_t fw_size);
+
+
+/**
+ * @brief Get the statistics of the running or last upgrade
+ * 
+ * @param target OTA engine
+ * @param stats OTA transfer statistics
+ * @return int 0-sucess -1-failed
+ */
+int rbf_ota_stats_get(rbf_ota_target_t target, rbf_ota_stats_t* stats);
+
+
+/**
+ * @brief Get the outcome of one sub-device of the last upgrade started with rbf_ota_stats_subdev_start()
+ * 
+ * @param no Sub-device registration number
+ * @param dev Outcome of the device
+ * @return int 0-sucess -1-device not part of the upgrade
+ */
+int rbf_ota_stats_subdev_device_get(uint8_t no, rbf_ota_stats_dev_t* dev);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,145 @@
+/**
+ * @file rbf_output_batch.h
+ * @brief Batch control of relays, wall switches and smartplugs with output status confirmation
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+#ifndef RBF_OUTPUT_BATCH_H
+#define RBF_OUTPUT_BATCH_H
+
+#include <stdint.h>
+#include "rbf_api.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#ifndef RBF_OUTPUT_BATCH_MAX
+#define RBF_OUTPUT_BATCH_MAX                (64)     /**< Maximum number of devices in a batch */
+#endif
+
+#define RBF_OUTPUT_BATCH_WINDOW_DEFAULT     (4)      /**< Default number of unconfirmed devices */
+#define RBF_OUTPUT_BATCH_TIMEOUT_DEFAULT    (3000)   /**< Default confirmation timeout in milliseconds */
+
+
+/**
+ * @brief Batch action
+ * 
+ */
+typedef enum
+{
+    RBF_OUTPUT_BATCH_ON = 0,        /**< Switch on, confirmed by an output status on */
+    RBF_OUTPUT_BATCH_OFF,           /**< Switch off, confirmed by an output status off */
+    RBF_OUTPUT_BATCH_TOGGLE,        /**< Toggle: a device with an output status received since
+                                         rbf_output_batch_init() is switched to the opposite state, with retries.
+                                         Otherwise a toggle is sent once, never retried, and any output status
+                                         confirms it */
+}rbf_output_batch_action_t;
+
+
+/**
+ * @brief Device result
+ * 
+ */
+typedef enum
+{
+    RBF_OUTPUT_BATCH_PENDING = 0,   /**< Not sent yet */
+    RBF_OUTPUT_BATCH_SENT,          /**< Sent, waiting for the output status */
+    RBF_OUTPUT_BATCH_CONFIRMED,     /**< Output status received */
+    RBF_OUTPUT_BATCH_FAILED,        /**< No output status after all retries */
+}rbf_output_batch_state_t;
+
+
+/**
+ * @brief Batch device
+ * 
+ */
+typedef struct
+{
+    RBF_dev_type_t type;                /**< RBF_DEV_TYPE_RELAY, RBF_DEV_TYPE_WALL_SWITCH or RBF_DEV_TYPE_SMART_PLUG */
+    uint8_t no;                         /**< Device registration number */
+    rbf_output_batch_state_t state;     /**< Result, filled in by the batch */
+    uint8_t tries;                      /**< Control calls issued, filled in by the batch */
+    uint32_t latency_ms;                /**< First send to confirmation, filled in by the batch */
+}rbf_output_batch_dev_t;
+
+
+/**
+ * @brief Batch configuration
+ * 
+ */
+typedef struct
+{
+    uint8_t window;         /**< Devices sent and not confirmed at most, 0 - RBF_OUTPUT_BATCH_WINDOW_DEFAULT */
+    uint32_t timeout_ms;    /**< Confirmation timeout, 0 - RBF_OUTPUT_BATCH_TIMEOUT_DEFAULT */
+    uint8_t retries;        /**< Control calls repeated after a timeout, not for a toggle of unknown state */
+}rbf_output_batch_cfg_t;
+
+
+/**
+ * @brief Batch completion callback
+ * @param devs Devices with their results
+ * @param count Number of devices
+ */
+typedef void (*rbf_output_batch_done_t)(const rbf_output_batch_dev_t* devs, uint8_t count);
+
+
+/**
+ * @brief Initialize the batch control
+ * 
+ * @return int 0-sucess -1-failed
+ * @note Relies on rbf_observer: wrap the relay, wall switch and smartplug callback functions
+ * clusters with rbf_observer_wrap_*() before registering them.
+ */
+int rbf_output_batch_init(void);
+
+
+/**
+ * @brief Start a batch, the devices are controlled by rbf_output_batch_poll()
+ * 
+ * @param devs Devices, copied
+ * @param count Number of devices
+ * @param action Action applied to every device
+ * @param cfg Configuration, NULL for default
+ * @param done Completion callback, may be NULL
+ * @return int 0-sucess -1-failed or a batch is running
+ */
+int rbf_output_batch_start(const rbf_output_batch_dev_t* devs, uint8_t count, rbf_output_batch_action_t action,
+                           const rbf_output_batch_cfg_t* cfg, rbf_output_batch_done_t done);
+
+
+/**
+ * @brief Batch poll: sends the controls, handles timeouts and reports the completion
+ * 
+ * @return int Number of control calls issued
+ * @note Call it periodically from an application thread
+ */
+int rbf_output_batch_poll(void);
+
+
+/**
+ * @brief Cancel the running batch, devices not confirmed yet are reported failed
+ * 
+ * @return int 0-sucess -1-no batch running
+ */
+int rbf_output_batch_cancel(void);
+
+
+/**
+ * @brief Get the devices of the running or last batch with their results
+ * 
+ * @param devs Returned devices
+ * @param max_count Size of devs
+ * @return int Number of devices returned
+ */
+int rbf_output_batch_result_get(rbf_output_batch_dev_t* devs, uint8_t max_count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
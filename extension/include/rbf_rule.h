@@ -0,0 +1,168 @@
+/**
+ * @file rbf_rule.h
+ * @brief Local automation rules evaluated in the rbfsdk thread
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+#ifndef RBF_RULE_H
+#define RBF_RULE_H
+
+#include <stdint.h>
+#include "rbf_api.h"
+#include "rbf_sounder.h"
+#include "rbf_indoor_siren.h"
+#include "rbf_relay.h"
+#include "rbf_smartplug.h"
+#include "rbf_wall_switch.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#ifndef RBF_RULE_MAX
+#define RBF_RULE_MAX                    (64)     /**< Maximum number of rules */
+#endif
+
+#ifndef RBF_RULE_TARGETS_MAX
+#define RBF_RULE_TARGETS_MAX            (32)     /**< Maximum number of target devices of a rule */
+#endif
+
+#define RBF_RULE_ANY_NO                 (0xFF)   /**< Rule triggered by every device of the type */
+#define RBF_RULE_ANY_KEY                (0xFF)   /**< Rule triggered by every key */
+
+
+/**
+ * @brief Rule trigger
+ * 
+ * Status triggers are edge triggered: they fire when the reported status changes from the last
+ * report of the device, repeated reports of the same status fire nothing. Keypad alarm reports
+ * are status reports too. PIR motion, emergency button alarm and key fob events fire on every event.
+ */
+typedef enum
+{
+    RBF_RULE_TRIG_ALARM = 0,        /**< Magnetic open, smoke, water leak, temperature/humidity alarm, PIR motion,
+                                         emergency button alarm, keypad emergency/fire/medical alarm */
+    RBF_RULE_TRIG_ALARM_CLEAR,      /**< Alarm status back to normal */
+    RBF_RULE_TRIG_TAMPER,           /**< Tamper alarm */
+    RBF_RULE_TRIG_KEY,              /**< Key fob key press */
+    RBF_RULE_TRIG_MAX
+}rbf_rule_trigger_t;
+
+
+/**
+ * @brief Rule action
+ * 
+ */
+typedef enum
+{
+    RBF_RULE_ACTION_SOUNDER = 0,    /**< rbf_sounder_boardcast_control() on the targets */
+    RBF_RULE_ACTION_INDOOR_SIREN,   /**< rbf_indoor_siren_boardcast_control() on the targets */
+    RBF_RULE_ACTION_RELAY,          /**< rbf_relay_ctrl() on each target */
+    RBF_RULE_ACTION_SMARTPLUG,      /**< rbf_smartplug_ctrl() on each target */
+    RBF_RULE_ACTION_WALL_SWITCH,    /**< rbf_wall_switch_ctrl() on each target */
+}rbf_rule_action_t;
+
+
+/**
+ * @brief Rule: when trigger is reported by the device and the current mode is enabled, do action on the targets
+ * 
+ * @code
+ * uint8_t sirens[] = {1, 2, 3};
+ * rbf_rule_t rule = {0};
+ * rule.type = RBF_DEV_TYPE_SMOKE;
+ * rule.no = RBF_RULE_ANY_NO;
+ * rule.trigger = RBF_RULE_TRIG_ALARM;
+ * rule.action = RBF_RULE_ACTION_INDOOR_SIREN;
+ * rule.param.indoor_siren.mode = RBF_INDOOR_SIREN_MODE_FIRE_MIXED_ALARM;
+ * rule.targets = sirens;
+ * rule.target_count = 3;
+ * @endcode
+ */
+typedef struct
+{
+    RBF_dev_type_t type;            /**< Trigger device type, emergency buttons are RBF_DEV_TYPE_FIXED_PA */
+    uint8_t no;                     /**< Trigger device number, RBF_RULE_ANY_NO for any */
+    rbf_rule_trigger_t trigger;     /**< Trigger */
+    uint8_t key;                    /**< Key of RBF_RULE_TRIG_KEY, RBF_RULE_ANY_KEY for any */
+    uint32_t modes;                 /**< Bit n set: rule enabled in mode n, see rbf_rule_mode_set(). 0 - all modes */
+    rbf_rule_action_t action;       /**< Action */
+    union
+    {
+        RBF_sounder_param_t sounder;
+        RBF_indoor_siren_param_t indoor_siren;
+        rbf_relay_ctrl_t relay;
+        rbf_smartplug_ctrl_t smartplug;
+        rbf_wall_switch_ctrl_t wall_switch;
+    }param;                         /**< Action parameter */
+    const uint8_t* targets;         /**< Target device numbers, copied by rbf_rule_load() */
+    uint8_t target_count;           /**< Number of targets */
+    uint8_t consume;                /**< 1 - the trigger is not delivered to the application callback nor to the
+                                         observers added after the rule engine, see rbf_rule_init() */
+}rbf_rule_t;
+
+
+/**
+ * @brief Rule engine statistics
+ * 
+ */
+typedef struct
+{
+    uint32_t messages;      /**< Device messages looked up */
+    uint32_t fired;         /**< Rules fired */
+    uint32_t failed;        /**< Control calls that failed */
+}rbf_rule_stats_t;
+
+
+/**
+ * @brief Initialize the rule engine
+ * 
+ * @return int 0-sucess -1-failed
+ * @note Relies on rbf_observer: wrap the callback functions clusters of the trigger devices with
+ * rbf_observer_wrap_*() before registering them. A consuming rule drops the message from the
+ * observer chain: initialize the rule engine after the observer modules that must see every
+ * message (supervision, link, dedup...) and before rbf_rxq, which stays the last one.
+ * @note Actions are done in the rbfsdk thread after the rule engine lock is released, a slow
+ * control call never blocks rbf_rule_load() or rbf_rule_mode_set().
+ */
+int rbf_rule_init(void);
+
+
+/**
+ * @brief Replace the rule table
+ * 
+ * Rules are compiled into a table indexed by device type and trigger, so a device message only
+ * scans the rules it may fire.
+ * 
+ * @param rules Rules, copied
+ * @param count Number of rules, 0 to remove all rules
+ * @return int 0-sucess -1-failed, the previous table is kept
+ */
+int rbf_rule_load(const rbf_rule_t* rules, uint16_t count);
+
+
+/**
+ * @brief Set the current mode, e.g. 0-disarmed 1-armed away 2-armed home
+ * 
+ * @param mode Mode 0-31
+ * @return int 0-sucess -1-failed
+ */
+int rbf_rule_mode_set(uint8_t mode);
+
+
+/**
+ * @brief Get the rule engine statistics
+ * 
+ * @param stats Statistics
+ * @return int 0-sucess -1-failed
+ */
+int rbf_rule_stats_get(rbf_rule_stats_t* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
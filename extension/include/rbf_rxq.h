@@ -0,0 +1,131 @@
+/**
+ * @file rbf_rxq.h
+ * @brief Deferred receive queue: sub-device messages are delivered from the application thread, heartbeats are shed first when full
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+#ifndef RBF_RXQ_H
+#define RBF_RXQ_H
+
+#include <stdint.h>
+#include "rbf_observer.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#ifndef RBF_RXQ_MAX
+#define RBF_RXQ_MAX                     (32)        /**< Maximum number of queued messages */
+#endif
+
+
+/**
+ * @brief Message class, in shedding order
+ * 
+ */
+typedef enum
+{
+    RBF_RXQ_HEARTBEAT = 0,      /**< Heartbeats, shed first */
+    RBF_RXQ_STATUS,             /**< Output status and temperature humidity reports */
+    RBF_RXQ_ALARM,              /**< Input status and events, keypad alarms, keys: never dropped */
+    RBF_RXQ_CLASS_MAX
+}rbf_rxq_class_t;
+
+
+/**
+ * @brief Statistics of a message class
+ * 
+ */
+typedef struct
+{
+    uint32_t queued;            /**< Messages queued */
+    uint32_t delivered;         /**< Messages delivered by rbf_rxq_poll() */
+    uint32_t dropped;           /**< Messages shed, always 0 for RBF_RXQ_ALARM */
+    uint16_t pending;           /**< Messages queued now */
+    uint16_t high_water;        /**< Most messages queued at once */
+    uint32_t latency_avg_ms;    /**< Average delay from the rbfsdk callback to the application callback */
+    uint32_t latency_max_ms;    /**< Longest delay from the rbfsdk callback to the application callback */
+}rbf_rxq_class_stats_t;
+
+
+/**
+ * @brief Receive queue statistics
+ * 
+ */
+typedef struct
+{
+    rbf_rxq_class_stats_t classes[RBF_RXQ_CLASS_MAX];  /**< Statistics per class */
+    uint16_t pending;           /**< Messages queued now */
+    uint16_t high_water;        /**< Most messages queued at once */
+    uint32_t extra;             /**< Alarms queued in heap entries because the queue was full of alarms */
+    uint32_t direct;            /**< Alarms delivered from the rbfsdk thread because no heap entry could be allocated */
+}rbf_rxq_stats_t;
+
+
+/**
+ * @brief Initialize the receive queue
+ * 
+ * @return int 0-sucess -1-failed
+ * @note Relies on rbf_observer: wrap the callback functions clusters with rbf_observer_wrap_*() before
+ * registering them. Call it after the initialization of the other rbf_observer modules, the observers
+ * added after it do not see the messages. The application callbacks are then called by rbf_rxq_poll().
+ * 
+ * An alarm finding the queue full of alarms is queued in an entry allocated with rbf_malloc() and
+ * freed by rbf_rxq_poll(). Only when that allocation fails is the alarm handed to the application
+ * callback from the rbfsdk thread at once (counted in direct): it is then delivered ahead of the
+ * queued alarms, and possibly while rbf_rxq_poll() runs a callback in the application thread.
+ */
+int rbf_rxq_init(void);
+
+
+/**
+ * @brief Class of a message
+ * 
+ * @param msg Sub-device message
+ * @return rbf_rxq_class_t Message class
+ */
+rbf_rxq_class_t rbf_rxq_class(const rbf_observer_msg_t* msg);
+
+
+/**
+ * @brief Deliver the queued messages to the application callbacks
+ * 
+ * Alarms are delivered first, ahead of the heartbeats and status reports queued before them, then
+ * each class oldest first.
+ * 
+ * @param max_count Maximum number of messages to deliver, 0 for all
+ * @return int Messages delivered, -1-failed
+ * @note Call it periodically from the application thread. The latency measured starts when rbfsdk
+ * calls the callback: the UART reception, the decoding and the callbacks the library runs before,
+ * e.g. sub-device OTA data requests, are not included and not shortened. The queue only orders its
+ * own messages: an alarm waits at most one poll period whatever the backlog, but reaches the
+ * application no sooner than a callback called directly from the rbfsdk thread.
+ */
+int rbf_rxq_poll(uint16_t max_count);
+
+
+/**
+ * @brief Get the receive queue statistics
+ * 
+ * @param stats Statistics
+ * @return int 0-sucess -1-failed
+ */
+int rbf_rxq_stats_get(rbf_rxq_stats_t* stats);
+
+
+/**
+ * @brief Clear the counters, latencies and high-water marks, the queued messages are kept
+ * 
+ * @return int 0-sucess -1-failed
+ */
+int rbf_rxq_stats_clear(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
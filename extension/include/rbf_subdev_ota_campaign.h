@@ -0,0 +1,158 @@
+/**
+ * @file rbf_subdev_ota_campaign.h
+ * @brief Sub-device OTA campaign: wave scheduler for any number of devices across categories
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+#ifndef RBF_SUBDEV_OTA_CAMPAIGN_H
+#define RBF_SUBDEV_OTA_CAMPAIGN_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "rbf_api.h"
+#include "rbf_subdev_ota.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#ifndef RBF_SUBDEV_OTA_CAMPAIGN_MAX_DEVICES
+#define RBF_SUBDEV_OTA_CAMPAIGN_MAX_DEVICES        (256)   /**< Maximum number of devices in a campaign */
+#endif
+
+#define RBF_SUBDEV_OTA_WAVE_MAX_DEVICES            (12)    /**< RBF supports upgrading up to 12 sub-devices simultaneously */
+
+
+/**
+ * @brief Campaign event
+ * 
+ */
+typedef enum
+{
+    RBF_SUBDEV_OTA_CAMPAIGN_EVT_WAVE_START = 0,     /**< A wave has been started, ids lists the devices of the wave */
+    RBF_SUBDEV_OTA_CAMPAIGN_EVT_WAVE_END,           /**< A wave has ended, ids lists the devices that failed in the wave */
+    RBF_SUBDEV_OTA_CAMPAIGN_EVT_DEVICE_FAIL,        /**< ids lists the devices that failed after all retries */
+    RBF_SUBDEV_OTA_CAMPAIGN_EVT_COMPLETE,           /**< All devices of the campaign have been processed */
+}rbf_subdev_ota_campaign_evt_t;
+
+
+/**
+ * @brief Campaign configuration
+ * 
+ */
+typedef struct
+{
+    uint32_t fw_size[RBF_DEV_UNKNOW];   /**< Firmware size indexed by RBF_dev_cat_t, 0 for categories not upgraded */
+    uint8_t wave_size;                  /**< Devices per wave: 1-RBF_SUBDEV_OTA_WAVE_MAX_DEVICES */
+    uint8_t max_retries;                /**< Retries of a failed device before it is given up, a failed wave start counts as one */
+}rbf_subdev_ota_campaign_cfg_t;
+
+
+/**
+ * @brief Campaign status
+ * 
+ */
+typedef struct
+{
+    bool running;                   /**< Campaign is running */
+    RBF_dev_cat_t wave_cat;         /**< Category of the running wave */
+    uint8_t wave_count;             /**< Devices in the running wave, 0 - no wave is running */
+    uint16_t total;                 /**< Devices in the campaign */
+    uint16_t pending;               /**< Devices waiting for a wave, including retries */
+    uint16_t done;                  /**< Devices upgraded successfully */
+    uint16_t failed;                /**< Devices given up after all retries */
+    uint16_t waves;                 /**< Waves finished */
+    uint16_t retries;               /**< Device retries scheduled */
+    uint8_t percent;                /**< Campaign progress: 0-100 */
+    uint32_t elapsed_s;             /**< Seconds since the campaign started */
+    uint32_t avg_wave_s;            /**< Average wave duration in seconds */
+    uint32_t eta_s;                 /**< Projected seconds to completion */
+    uint32_t device_s_remaining;    /**< Projected device-seconds to completion (device-hours * 3600) */
+}rbf_subdev_ota_campaign_status_t;
+
+
+/**
+ * @brief Campaign event reporting
+ * @param evt Campaign event
+ * @param ids Devices concerned by the event
+ * @param count Number of ids
+ * @param status Campaign status
+ * @note Called from the rbfsdk thread or from rbf_subdev_ota_campaign_poll()
+ */
+typedef int (*rbf_subdev_ota_campaign_evt_handle_t)(rbf_subdev_ota_campaign_evt_t evt, const RBF_dev_id_t* ids,
+                                                    uint8_t count, rbf_subdev_ota_campaign_status_t* status);
+
+
+/**
+ * @brief Hook the campaign scheduler into a sub-device OTA callback cluster
+ * 
+ * The event handle of cbs is replaced with the scheduler handle which forwards to the
+ * original one. Register cbs with rbf_subdev_ota_register_evt_callback() afterwards.
+ * A wave ends on RBF_SUBDEV_OTA_EVT_UPGRADE_COMPLETE or RBF_SUBDEV_OTA_EVT_UPGRADE_FAIL.
+ * RBF_SUBDEV_OTA_EVT_UPGRADE_REQUEST_TIMEOUT marks the listed devices, all when none is listed,
+ * as failed in the wave, which only ends there once all its devices timed out.
+ * 
+ * @param cbs Sub-device OTA callback function cluster, modified in place
+ * @param evt_cb Campaign event callback, may be NULL
+ * @return int 0-sucess -1-failed
+ */
+int rbf_subdev_ota_campaign_wrap(RBF_subdev_ota_evt_callbacks_t* cbs, rbf_subdev_ota_campaign_evt_handle_t evt_cb);
+
+
+/**
+ * @brief Start a campaign
+ * 
+ * @param ids Devices to upgrade, any categories
+ * @param count Number of ids, up to RBF_SUBDEV_OTA_CAMPAIGN_MAX_DEVICES
+ * @param cfg Campaign configuration
+ * @return int 0-sucess -1-failed
+ * @note Waves are started by rbf_subdev_ota_campaign_poll(). A wave only contains devices of one
+ * category, the data handle serves the image of the category reported in RBF_SUBDEV_OTA_CAMPAIGN_EVT_WAVE_START.
+ */
+int rbf_subdev_ota_campaign_start(const RBF_dev_id_t* ids, uint16_t count, const rbf_subdev_ota_campaign_cfg_t* cfg);
+
+
+/**
+ * @brief Stop the campaign after the running wave
+ * 
+ * @return int 0-sucess -1-failed
+ * @note Devices failing in the last wave with retries left stay pending, rbf_subdev_ota_campaign_resume()
+ * continues with them and the devices not yet upgraded.
+ */
+int rbf_subdev_ota_campaign_stop(void);
+
+
+/**
+ * @brief Resume a stopped campaign with its pending devices
+ * 
+ * @return int 0-sucess -1-failed, running or no device pending
+ */
+int rbf_subdev_ota_campaign_resume(void);
+
+
+/**
+ * @brief Campaign poll, starts the next wave as soon as the previous one has ended
+ * 
+ * @return int 0-idle or waiting for the running wave, 1-a wave has been started, -1-failed to start a wave
+ * @note Call it periodically from the application thread, not from rbfsdk callbacks
+ */
+int rbf_subdev_ota_campaign_poll(void);
+
+
+/**
+ * @brief Get campaign status
+ * 
+ * @param status Campaign status
+ * @return int 0-sucess -1-failed
+ */
+int rbf_subdev_ota_campaign_status_get(rbf_subdev_ota_campaign_status_t* status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,139 @@
+/**
+ * @file rbf_supervision.h
+ * @brief Sub-device supervision: offline and online events from missed heartbeats
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+#ifndef RBF_SUPERVISION_H
+#define RBF_SUPERVISION_H
+
+#include <stdint.h>
+#include "rbf_api.h"
+#include "rbf_time.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#ifndef RBF_SUPERVISION_MAX
+#define RBF_SUPERVISION_MAX                 (256)       /**< Maximum number of supervised devices */
+#endif
+
+#ifndef RBF_SUPERVISION_TICK_MS
+#define RBF_SUPERVISION_TICK_MS             (1000)      /**< Timer wheel resolution */
+#endif
+
+#ifndef RBF_SUPERVISION_INTERVAL_DEFAULT
+#define RBF_SUPERVISION_INTERVAL_DEFAULT    (7200)      /**< Default supervision interval in seconds */
+#endif
+
+#define RBF_SUPERVISION_INTERVAL_MAX        (262143UL * RBF_SUPERVISION_TICK_MS / 1000)  /**< Longest interval in seconds */
+
+
+/**
+ * @brief Device supervision state
+ * 
+ */
+typedef enum
+{
+    RBF_SUPERVISION_UNKNOWN = 0,    /**< Added, nothing received yet */
+    RBF_SUPERVISION_ONLINE,         /**< Reported within its supervision interval */
+    RBF_SUPERVISION_OFFLINE,        /**< Missed its supervision interval */
+}rbf_supervision_state_t;
+
+
+/**
+ * @brief Supervision event reporting, called when the state of a device changes
+ * @param id Device
+ * @param type Device type
+ * @param state New state, RBF_SUPERVISION_ONLINE or RBF_SUPERVISION_OFFLINE
+ * @note Called from rbf_supervision_poll()
+ */
+typedef void (*rbf_supervision_evt_handle_t)(const RBF_dev_id_t* id, RBF_dev_type_t type, rbf_supervision_state_t state);
+
+
+/**
+ * @brief Initialize the supervision
+ * 
+ * @param handle Event reporting callback
+ * @return int 0-sucess -1-failed
+ * @note Relies on rbf_observer: wrap the callback functions clusters of the supervised devices with
+ * rbf_observer_wrap_*() before registering them. Any message of a device rearms its supervision.
+ */
+int rbf_supervision_init(rbf_supervision_evt_handle_t handle);
+
+
+/**
+ * @brief Set the supervision interval of a device type
+ * 
+ * Devices already armed keep their current expiry, the new interval applies from their next report.
+ * 
+ * @param type Device type
+ * @param seconds Interval, 0 disables the supervision of the type. Key fobs are not supervised by default
+ * @return int 0-sucess -1-failed
+ */
+int rbf_supervision_interval_set(RBF_dev_type_t type, uint32_t seconds);
+
+
+/**
+ * @brief Set the supervision interval of several device types at once, e.g. from rbf_heartbeat_supervision_get()
+ * 
+ * Every interval is checked before any is set: on failure no interval is changed.
+ * 
+ * @param seconds Interval per device type, 0 keeps the interval of the type
+ * @return int 0-sucess -1-failed, an interval is over RBF_SUPERVISION_INTERVAL_MAX
+ */
+int rbf_supervision_intervals_set(const uint32_t seconds[RBF_DEV_TYPE_UNKNOW]);
+
+
+/**
+ * @brief Supervise a device before it reports, it goes offline if nothing is received within its interval
+ * 
+ * Devices are also added on their first report.
+ * 
+ * @param id Device
+ * @param type Device type
+ * @return int 0-sucess -1-failed
+ * @note Call it for the devices returned by rbf_get_register_info() at startup
+ */
+int rbf_supervision_add(const RBF_dev_id_t* id, RBF_dev_type_t type);
+
+
+/**
+ * @brief Stop supervising a device, call it after rbf_device_delete()
+ * 
+ * @param id Device
+ * @return int 0-sucess -1-not found
+ */
+int rbf_supervision_remove(const RBF_dev_id_t* id);
+
+
+/**
+ * @brief Get the supervision state of a device
+ * 
+ * @param id Device
+ * @param state Supervision state
+ * @param last_ms Time of the last report, 0 if none. May be NULL
+ * @return int 0-sucess -1-not found
+ */
+int rbf_supervision_state_get(const RBF_dev_id_t* id, rbf_supervision_state_t* state, rbf_time_t* last_ms);
+
+
+/**
+ * @brief Supervision poll, advances the timer wheel and reports the state changes
+ * 
+ * @return int Number of events reported
+ * @note Call it periodically from an application thread, at least once per RBF_SUPERVISION_TICK_MS
+ * for an accurate expiry
+ */
+int rbf_supervision_poll(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
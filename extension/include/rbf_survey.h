@@ -0,0 +1,125 @@
+/**
+ * @file rbf_survey.h
+ * @brief Site survey: RSSI broadcast of the devices for a set duration and a per-device report
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+#ifndef RBF_SURVEY_H
+#define RBF_SURVEY_H
+
+#include <stdint.h>
+#include "rbf_api.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#ifndef RBF_SURVEY_MAX
+#define RBF_SURVEY_MAX                  (255)       /**< Maximum number of surveyed devices, about 48 bytes each */
+#endif
+
+#ifndef RBF_SURVEY_INFO_TIMEOUT_MS
+#define RBF_SURVEY_INFO_TIMEOUT_MS      (3000)      /**< Time to wait for the registration information */
+#endif
+
+#define RBF_SURVEY_LOSS_UNKNOW          (0xFF)      /**< Loss of a device with less than 2 samples and no period given */
+
+
+/**
+ * @brief Per-device survey report
+ * 
+ */
+typedef struct
+{
+    RBF_dev_id_t id;            /**< Device */
+    uint16_t samples;           /**< Heartbeats received */
+    int32_t mean;               /**< Mean RSSI */
+    int32_t worst;              /**< Lowest RSSI */
+    int32_t best;               /**< Highest RSSI */
+    uint8_t loss_percent;       /**< Heartbeats missed over the survey, 100 if none received */
+}rbf_survey_report_t;
+
+
+/**
+ * @brief Survey completion callback
+ * @param reports Per-device reports
+ * @param count Number of reports, 0 if the devices could not be listed or the RSSI broadcast could not be enabled
+ * @note Called from rbf_survey_poll()
+ */
+typedef void (*rbf_survey_done_t)(const rbf_survey_report_t* reports, uint8_t count);
+
+
+/**
+ * @brief Add the survey to the HUB event callback functions, needed to survey every enrolled device
+ * 
+ * The registration information is recorded, then given to the application callback. Register cbs
+ * with rbf_register_evt_callback() afterwards.
+ * 
+ * @param cbs HUB event callback functions, modified in place
+ * @return int 0-sucess -1-failed
+ * @note The heartbeats are collected through rbf_observer: wrap the callback functions clusters
+ * with rbf_observer_wrap_*() before registering them.
+ */
+int rbf_survey_wrap(RBF_evt_callbacks_t* cbs);
+
+
+/**
+ * @brief Start a survey
+ * 
+ * RSSI broadcast is enabled on the devices, the heartbeats are collected for duration_ms, then
+ * RSSI broadcast is disabled and the report is given to done.
+ * 
+ * @param ids Devices, NULL for every enrolled device from rbf_get_register_info()
+ * @param count Number of ids, at most RBF_SURVEY_MAX
+ * @param duration_ms Survey duration
+ * @param period_ms Heartbeat period in RSSI broadcast for the loss, 0 to use the shortest gap of each device
+ * @param done Completion callback, may be NULL
+ * @return int 0-sucess -1-failed or a survey is running
+ */
+int rbf_survey_start(const RBF_dev_id_t* ids, uint8_t count, uint32_t duration_ms, uint32_t period_ms,
+                     rbf_survey_done_t done);
+
+
+/**
+ * @brief Stop the running survey now, the report covers the samples collected so far
+ * 
+ * @return int 0-sucess -1-no survey running
+ */
+int rbf_survey_stop(void);
+
+
+/**
+ * @brief Survey poll, starts and ends the RSSI broadcast
+ * 
+ * @return int 0-sucess -1-failed, e.g. rbf_start_rssi() failed and the survey ended without report
+ * @note Call it periodically from an application thread
+ */
+int rbf_survey_poll(void);
+
+
+/**
+ * @brief Devices of the registration information left out of the survey
+ * 
+ * @return uint8_t Devices beyond RBF_SURVEY_MAX, 0 if every enrolled device is surveyed
+ */
+uint8_t rbf_survey_skipped(void);
+
+
+/**
+ * @brief Get the report of the last survey
+ * 
+ * @param reports Per-device reports
+ * @param max_count Size of reports
+ * @return int Number of reports returned
+ */
+int rbf_survey_report_get(rbf_survey_report_t* reports, uint8_t max_count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
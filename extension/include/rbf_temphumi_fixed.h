@@ -0,0 +1,86 @@
+/**
+ * @file rbf_temphumi_fixed.h
+ * @brief Fixed-point temperature and humidity path for FPU-less targets
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+#ifndef RBF_TEMP_HUMI_FIXED_H
+#define RBF_TEMP_HUMI_FIXED_H
+
+#include <stdint.h>
+#include "rbf_temphumi.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @brief Enable the fixed-point heartbeat path. Set it to 0 to keep only the float path of rbf_temphumi.h
+ * 
+ */
+#ifndef RBF_TEMP_HUMI_FIXED_POINT
+#define RBF_TEMP_HUMI_FIXED_POINT          1
+#endif
+
+/**
+ * @brief Convert a float to hundredths using integer arithmetic only, no soft-float routine is linked,
+ * available whatever RBF_TEMP_HUMI_FIXED_POINT
+ * 
+ * @param value Value, e.g. 21.5f
+ * @return int16_t Value * 100 rounded to nearest, saturated to INT16_MIN..INT16_MAX, e.g. 2150
+ */
+int16_t rbf_float_to_centi(float value);
+
+
+#if RBF_TEMP_HUMI_FIXED_POINT
+
+/**
+ * @brief Temperature and humidity sensor heartbeat in fixed point
+ */
+typedef struct 
+{
+    uint8_t power;  /**< Temperature and humidity sensor level 0-100 */
+    int16_t temp;   /**< Temperature in 0.01 degree, 2150 - 21.50 */
+    int16_t humi;   /**< Humidity in 0.01 %RH, 4525 - 45.25%RH */
+    int32_t rssi;   /**< Sensor RSSI */
+}rbf_temp_humi_heartbeat_fixed_t;
+
+
+/**
+ * @brief Callback function to handle temp humi device heartbeat events in fixed point.
+ */
+typedef int (*rbf_temp_humi_fixed_heartbeat_callback_t)(uint8_t no, rbf_temp_humi_heartbeat_fixed_t* heartbeat);
+
+
+/**
+ * @brief  Temperature and humidity sensor fixed-point callback functions cluster
+ * 
+ */
+typedef struct 
+{
+    rbf_temp_humi_fixed_heartbeat_callback_t hb_cb;
+    rbf_temp_humi_input_status_update_callback_t input_status_cb;  
+}rbf_temp_humi_fixed_callbacks_t;
+
+
+/**
+ * @brief Register Temperature and humidity sensor fixed-point callback functions cluster,
+ * used instead of rbf_temp_humi_register_callbacks()
+ * 
+ * @param cbs  Temperature and humidity sensor fixed-point callback functions cluster
+ * @return int 0 - Registration successful, 1 - Registration failed
+ * @note The callbacks are wrapped with rbf_observer_wrap_temp_humi(), do not wrap them again
+ */
+int rbf_temp_humi_fixed_register_callbacks(rbf_temp_humi_fixed_callbacks_t* cbs);
+
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
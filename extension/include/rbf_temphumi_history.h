@@ -0,0 +1,140 @@
+/**
+ * @file rbf_temphumi_history.h
+ * @brief Temperature and humidity history with min/max/avg downsampling
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+#ifndef RBF_TEMP_HUMI_HISTORY_H
+#define RBF_TEMP_HUMI_HISTORY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#ifndef RBF_TEMP_HUMI_HISTORY_SENSORS
+#define RBF_TEMP_HUMI_HISTORY_SENSORS               (8)      /**< Maximum number of sensors with history */
+#endif
+
+#ifndef RBF_TEMP_HUMI_HISTORY_FINE_S
+#define RBF_TEMP_HUMI_HISTORY_FINE_S                (300)    /**< Fine bucket duration in seconds */
+#endif
+
+#ifndef RBF_TEMP_HUMI_HISTORY_FINE_BUCKETS
+#define RBF_TEMP_HUMI_HISTORY_FINE_BUCKETS          (24)     /**< Fine buckets kept: 2 hours */
+#endif
+
+#ifndef RBF_TEMP_HUMI_HISTORY_COARSE_S
+#define RBF_TEMP_HUMI_HISTORY_COARSE_S              (1800)   /**< Coarse bucket duration in seconds, a multiple of the fine one */
+#endif
+
+#ifndef RBF_TEMP_HUMI_HISTORY_COARSE_BUCKETS
+#define RBF_TEMP_HUMI_HISTORY_COARSE_BUCKETS        (48)     /**< Coarse buckets kept: 24 hours */
+#endif
+
+
+/**
+ * @brief History resolution
+ * 
+ */
+typedef enum
+{
+    RBF_TEMP_HUMI_HISTORY_FINE = 0,     /**< RBF_TEMP_HUMI_HISTORY_FINE_S buckets */
+    RBF_TEMP_HUMI_HISTORY_COARSE,       /**< RBF_TEMP_HUMI_HISTORY_COARSE_S buckets */
+    RBF_TEMP_HUMI_HISTORY_TIER_MAX
+}rbf_temp_humi_history_tier_t;
+
+
+/**
+ * @brief History bucket
+ * 
+ * Values are in 0.01 degree / 0.01 %RH with a 0.1 resolution. A bucket whose average rose by
+ * more than 12.7 or fell by more than 12.6 from the previous one, or whose min/max is more than
+ * 25.5 from its average, is stored with its exact values in 3 records instead of 1, so fewer
+ * buckets are kept.
+ */
+typedef struct
+{
+    uint32_t time;      /**< Bucket start time in seconds */
+    bool valid;         /**< false - no sample in the bucket (sensor offline) */
+    int16_t temp_avg;   /**< Average temperature */
+    int16_t temp_min;   /**< Minimum temperature */
+    int16_t temp_max;   /**< Maximum temperature */
+    int16_t humi_avg;   /**< Average humidity */
+    int16_t humi_min;   /**< Minimum humidity */
+    int16_t humi_max;   /**< Maximum humidity */
+}rbf_temp_humi_history_point_t;
+
+
+/**
+ * @brief Time source of the history
+ * @return uint32_t Current time in seconds, e.g. UTC seconds for cloud backfill
+ */
+typedef uint32_t (*rbf_temp_humi_history_time_t)(void);
+
+
+/**
+ * @brief Initialize the history and record the heartbeats of all temperature and humidity sensors
+ * 
+ * @param now Time source, NULL to use the rbfsdk millisecond tick
+ * @return int 0-sucess -1-failed
+ * @note Relies on rbf_observer: wrap the temperature and humidity callback functions cluster with
+ * rbf_observer_wrap_temp_humi() before registering it.
+ */
+int rbf_temp_humi_history_init(rbf_temp_humi_history_time_t now);
+
+
+/**
+ * @brief Record a sample
+ * 
+ * @param no Temperature and humidity sensor number
+ * @param temp Temperature in 0.01 degree
+ * @param humi Humidity in 0.01 %RH
+ * @return int 0-sucess -1-no free sensor slot
+ */
+int rbf_temp_humi_history_add(uint8_t no, int16_t temp, int16_t humi);
+
+
+/**
+ * @brief Close the buckets whose time is over, so that offline sensors get empty buckets
+ * 
+ * @return int 0-sucess
+ * @note Call it at least once per fine bucket duration
+ */
+int rbf_temp_humi_history_poll(void);
+
+
+/**
+ * @brief Query the history of a sensor
+ * 
+ * @param no Temperature and humidity sensor number
+ * @param tier History resolution
+ * @param from Start time in seconds, buckets starting before are skipped
+ * @param to End time in seconds, buckets starting after are skipped
+ * @param points Returned buckets, oldest first. The bucket in progress is included.
+ * @param max_points Size of points
+ * @return int Number of buckets returned, -1-failed
+ */
+int rbf_temp_humi_history_query(uint8_t no, rbf_temp_humi_history_tier_t tier, uint32_t from, uint32_t to,
+                                rbf_temp_humi_history_point_t* points, uint16_t max_points);
+
+
+/**
+ * @brief Remove the history of a sensor, e.g. after the sensor has been deleted
+ * 
+ * @param no Temperature and humidity sensor number
+ * @return int 0-sucess -1-not found
+ */
+int rbf_temp_humi_history_clear(uint8_t no);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,241 @@
+/**
+ * @file rbf_airtime.c
+ * @brief Airtime accounting per traffic class and channel utilization over sliding windows
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+#include <string.h>
+#include "rbf_airtime.h"
+#include "rbf_observer.h"
+#include "rbf_mutex.h"
+#include "rbf_time.h"
+
+#define AIRTIME_FREQ_MAX        (RBF_FREQ_INRA_868 + 1)
+
+#define AIRTIME_LEN_ALARM       (8)         /**< Assumed received payload lengths per class */
+#define AIRTIME_LEN_P2P         (12)
+
+typedef struct
+{
+    uint32_t slot_no[RBF_AIRTIME_SLOTS];                        /**< Absolute slot number held by each slot */
+    uint32_t airtime_us[RBF_AIRTIME_SLOTS][RBF_AIRTIME_CLASS_MAX];
+}airtime_window_t;
+
+static rbf_mutex_t s_airtime_mutex;
+static RBF_Freq_t s_freq;
+/* Assumed rates, the library does not publish them: see rbf_airtime_rate_set() */
+static uint32_t s_rate_bps[AIRTIME_FREQ_MAX] = {
+    38400,      /* RBF_FREQ_868 */
+    38400,      /* RBF_FREQ_915 */
+    9600,       /* RBF_FREQ_433 */
+    38400,      /* RBF_FREQ_916 */
+    38400,      /* RBF_FREQ_WPC_868 */
+    38400,      /* RBF_FREQ_MAL_915 */
+    38400,      /* RBF_FREQ_INRA_868 */
+};
+static const uint32_t s_slot_ms[RBF_AIRTIME_WINDOW_MAX] = {RBF_AIRTIME_SHORT_SLOT_MS, RBF_AIRTIME_LONG_SLOT_MS};
+static airtime_window_t s_windows[RBF_AIRTIME_WINDOW_MAX];
+static uint32_t s_frames[RBF_AIRTIME_DIR_MAX][RBF_AIRTIME_CLASS_MAX];
+static RBF_subdev_ota_evt_callbacks_t s_subdev_user_cbs;
+
+
+static void airtime_add(rbf_airtime_dir_t dir, rbf_airtime_class_t cls, uint16_t len, rbf_time_t now)
+{
+    uint32_t us = rbf_airtime_frame_us(s_freq, len);
+    uint8_t w;
+
+    for (w = 0; w < RBF_AIRTIME_WINDOW_MAX; w++) {
+        airtime_window_t* window = &s_windows[w];
+        uint32_t slot_no = now / s_slot_ms[w];
+        uint8_t i = slot_no % RBF_AIRTIME_SLOTS;
+
+        if (window->slot_no[i] != slot_no) {
+            window->slot_no[i] = slot_no;
+            memset(window->airtime_us[i], 0, sizeof(window->airtime_us[i]));
+        }
+        window->airtime_us[i][cls] += us;
+    }
+    s_frames[dir][cls]++;
+}
+
+
+static int airtime_observer(const rbf_observer_msg_t* msg, void* arg)
+{
+    rbf_airtime_class_t cls;
+    uint16_t len;
+
+    (void)arg;
+    switch (msg->msg) {
+    case RBF_OBSERVER_MSG_HEARTBEAT:
+        cls = RBF_AIRTIME_HEARTBEAT;
+        len = RBF_OBSERVER_HEARTBEAT_LEN;
+        break;
+    case RBF_OBSERVER_MSG_OUTPUT_STATUS:
+        cls = RBF_AIRTIME_P2P;
+        len = AIRTIME_LEN_P2P;
+        break;
+    default:
+        cls = RBF_AIRTIME_ALARM;
+        len = AIRTIME_LEN_ALARM;
+        break;
+    }
+
+    rbf_mutex_lock(s_airtime_mutex);
+    airtime_add(RBF_AIRTIME_RX, cls, len, msg->time);
+    rbf_mutex_unlock(s_airtime_mutex);
+
+    return RBF_OBSERVER_PASS;
+}
+
+
+static void airtime_tx_handle(rbf_observer_tx_t tx, uint16_t len)
+{
+    rbf_airtime_record(RBF_AIRTIME_TX, tx == RBF_OBSERVER_TX_BROADCAST ? RBF_AIRTIME_BROADCAST : RBF_AIRTIME_P2P, len);
+}
+
+
+static uint32_t airtime_frame_us(uint16_t len)
+{
+    return rbf_airtime_frame_us(s_freq, len);
+}
+
+
+static int airtime_subdev_data_handle(unsigned int offset, unsigned int size, unsigned char* data)
+{
+    int ret;
+
+    if (s_subdev_user_cbs.rbf_subdev_ota_request_upgrade_data_handle == NULL) {
+        return -1;
+    }
+
+    ret = s_subdev_user_cbs.rbf_subdev_ota_request_upgrade_data_handle(offset, size, data);
+    if (ret == 0) {
+        rbf_airtime_record(RBF_AIRTIME_TX, RBF_AIRTIME_OTA, (uint16_t)size);
+    }
+    return ret;
+}
+
+
+int rbf_airtime_init(RBF_Freq_t freq)
+{
+    if (freq >= AIRTIME_FREQ_MAX) {
+        return -1;
+    }
+
+    if (s_airtime_mutex == NULL) {
+        s_airtime_mutex = rbf_mutex_create();
+        if (s_airtime_mutex == NULL) {
+            return -1;
+        }
+        if (0 != rbf_observer_add(airtime_observer, NULL)) {
+            return -1;
+        }
+        rbf_observer_tx_set(airtime_tx_handle);
+        rbf_observer_airtime_set(airtime_frame_us);
+    }
+
+    rbf_mutex_lock(s_airtime_mutex);
+    s_freq = freq;
+    rbf_mutex_unlock(s_airtime_mutex);
+
+    return 0;
+}
+
+
+int rbf_airtime_rate_set(RBF_Freq_t freq, uint32_t bps)
+{
+    if (freq >= AIRTIME_FREQ_MAX || bps == 0) {
+        return -1;
+    }
+
+    s_rate_bps[freq] = bps;
+    return 0;
+}
+
+
+uint32_t rbf_airtime_frame_us(RBF_Freq_t freq, uint16_t len)
+{
+    if (freq >= AIRTIME_FREQ_MAX) {
+        return 0;
+    }
+    return (uint32_t)((uint64_t)(len + RBF_AIRTIME_OVERHEAD_BYTES) * 8 * 1000000 / s_rate_bps[freq]);
+}
+
+
+int rbf_airtime_record(rbf_airtime_dir_t dir, rbf_airtime_class_t cls, uint16_t len)
+{
+    rbf_time_t now;
+
+    if (s_airtime_mutex == NULL || dir >= RBF_AIRTIME_DIR_MAX || cls >= RBF_AIRTIME_CLASS_MAX) {
+        return -1;
+    }
+
+    rbf_time_get_ms(&now);
+    rbf_mutex_lock(s_airtime_mutex);
+    airtime_add(dir, cls, len, now);
+    rbf_mutex_unlock(s_airtime_mutex);
+
+    return 0;
+}
+
+
+int rbf_airtime_wrap_subdev_ota(RBF_subdev_ota_evt_callbacks_t* cbs)
+{
+    if (cbs == NULL) {
+        return -1;
+    }
+
+    s_subdev_user_cbs = *cbs;
+    cbs->rbf_subdev_ota_request_upgrade_data_handle = airtime_subdev_data_handle;
+
+    return 0;
+}
+
+
+int rbf_airtime_stats_get(rbf_airtime_window_t window, rbf_airtime_stats_t* stats)
+{
+    const airtime_window_t* w;
+    uint64_t total_us[RBF_AIRTIME_CLASS_MAX];
+    uint64_t busy_us = 0;
+    uint32_t slot_no;
+    rbf_time_t now;
+    uint8_t i;
+    uint8_t c;
+
+    if (s_airtime_mutex == NULL || window >= RBF_AIRTIME_WINDOW_MAX || stats == NULL) {
+        return -1;
+    }
+
+    memset(stats, 0, sizeof(rbf_airtime_stats_t));
+    memset(total_us, 0, sizeof(total_us));
+    stats->window_ms = s_slot_ms[window] * RBF_AIRTIME_SLOTS;
+
+    rbf_time_get_ms(&now);
+    slot_no = now / s_slot_ms[window];
+    w = &s_windows[window];
+    rbf_mutex_lock(s_airtime_mutex);
+    for (i = 0; i < RBF_AIRTIME_SLOTS; i++) {
+        /* Slots not written during the window hold older data */
+        if (slot_no - w->slot_no[i] >= RBF_AIRTIME_SLOTS) {
+            continue;
+        }
+        for (c = 0; c < RBF_AIRTIME_CLASS_MAX; c++) {
+            total_us[c] += w->airtime_us[i][c];
+        }
+    }
+    memcpy(stats->frames, s_frames, sizeof(s_frames));
+    rbf_mutex_unlock(s_airtime_mutex);
+
+    /* Utilization in 0.1 %: airtime in us over the window length in ms */
+    for (c = 0; c < RBF_AIRTIME_CLASS_MAX; c++) {
+        stats->airtime_ms[c] = (uint32_t)(total_us[c] / 1000);
+        stats->class_permille[c] = (uint16_t)(total_us[c] / stats->window_ms);
+        busy_us += total_us[c];
+    }
+    stats->busy_permille = (uint16_t)(busy_us / stats->window_ms);
+
+    return 0;
+}
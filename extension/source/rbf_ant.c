@@ -0,0 +1,300 @@
+/**
+ * @file rbf_ant.c
+ * @brief Antenna diversity: antenna selection from surveyed device RSSI and noise
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+#include <string.h>
+#include "rbf_ant.h"
+#include "rbf_api_ex.h"
+#include "rbf_observer.h"
+#include "rbf_mutex.h"
+#include "rbf_time.h"
+
+typedef struct
+{
+    bool used;
+    RBF_dev_id_t id;
+    int32_t sum[RBF_ANT_COUNT];
+    uint16_t count[RBF_ANT_COUNT];
+}ant_dev_t;
+
+static rbf_mutex_t s_ant_mutex;
+static rbf_ant_cfg_t s_cfg;
+static rbf_ant_evt_handle_t s_handle;
+static RBF_ant_index_t s_current;
+static RBF_dev_id_t s_ids[RBF_ANT_DEVICES_MAX];
+static uint8_t s_id_count;
+static ant_dev_t s_devs[RBF_ANT_DEVICES_MAX];
+static bool s_surveying;
+static int8_t s_step;                   /**< Antenna being measured, -1 before the first one */
+static bool s_step_ok;                  /**< s_step is selected */
+static rbf_time_t s_step_ms;
+static rbf_time_t s_survey_ms;
+static bool s_surveyed;
+static rbf_ant_result_t s_result;
+
+
+static int ant_observer(const rbf_observer_msg_t* msg, void* arg)
+{
+    ant_dev_t* free_dev = NULL;
+    uint8_t i;
+
+    (void)arg;
+    if (msg->msg != RBF_OBSERVER_MSG_HEARTBEAT || !s_surveying) {
+        return RBF_OBSERVER_PASS;
+    }
+
+    rbf_mutex_lock(s_ant_mutex);
+    if (s_surveying && s_step_ok) {
+        for (i = 0; i < RBF_ANT_DEVICES_MAX; i++) {
+            ant_dev_t* dev = &s_devs[i];
+
+            if (!dev->used) {
+                if (free_dev == NULL) {
+                    free_dev = dev;
+                }
+                continue;
+            }
+            if (dev->id.cat == msg->id.cat && dev->id.no == msg->id.no) {
+                break;
+            }
+        }
+        if (i == RBF_ANT_DEVICES_MAX && free_dev != NULL) {
+            memset(free_dev, 0, sizeof(ant_dev_t));
+            free_dev->used = true;
+            free_dev->id = msg->id;
+            i = (uint8_t)(free_dev - s_devs);
+        }
+        if (i < RBF_ANT_DEVICES_MAX) {
+            s_devs[i].sum[s_step] += msg->rssi;
+            s_devs[i].count[s_step]++;
+        }
+    }
+    rbf_mutex_unlock(s_ant_mutex);
+
+    return RBF_OBSERVER_PASS;
+}
+
+
+static int8_t ant_next(int8_t step)
+{
+    do {
+        step++;
+    } while (step < RBF_ANT_COUNT && !(s_cfg.ants & RBF_ANT_MASK(step)));
+    return step;
+}
+
+
+static void ant_select(void)
+{
+    rbf_ant_result_t* result = &s_result;
+    int8_t best = -1;
+    uint8_t a;
+    uint8_t i;
+
+    result->previous = s_current;
+    result->devices = 0;
+    for (i = 0; i < RBF_ANT_DEVICES_MAX; i++) {
+        if (s_devs[i].used) {
+            result->devices++;
+        }
+    }
+
+    for (a = 0; a < RBF_ANT_COUNT; a++) {
+        int32_t sum = 0;
+
+        result->heard[a] = 0;
+        result->margin[a] = 0;
+        if (!result->valid[a]) {
+            continue;
+        }
+        for (i = 0; i < RBF_ANT_DEVICES_MAX; i++) {
+            if (s_devs[i].used && s_devs[i].count[a]) {
+                sum += s_devs[i].sum[a] * 10 / s_devs[i].count[a] - result->noise[a] * 10;
+                result->heard[a]++;
+            }
+        }
+        /* Devices heard on another antenna only count as no margin */
+        result->margin[a] = result->devices ? sum / result->devices : 0;
+        if (best < 0 || result->margin[a] > result->margin[best]) {
+            best = a;
+        }
+    }
+
+    result->selected = s_current;
+    if (best >= 0 && result->devices && best != (int8_t)s_current
+        && (!result->valid[s_current] || result->margin[best] >= result->margin[s_current] + s_cfg.hysteresis * 10)) {
+        result->selected = (RBF_ant_index_t)best;
+    }
+    result->switched = result->selected != result->previous;
+    s_current = result->selected;
+}
+
+
+int rbf_ant_init(const rbf_ant_cfg_t* cfg, rbf_ant_evt_handle_t handle)
+{
+    if (cfg == NULL || cfg->current >= RBF_ANT_COUNT || cfg->dwell_ms == 0
+        || (cfg->ants & ((1U << RBF_ANT_COUNT) - 1)) == 0) {
+        return -1;
+    }
+
+    if (s_ant_mutex == NULL) {
+        s_ant_mutex = rbf_mutex_create();
+        if (s_ant_mutex == NULL) {
+            return -1;
+        }
+        if (0 != rbf_observer_add(ant_observer, NULL)) {
+            return -1;
+        }
+    }
+
+    rbf_mutex_lock(s_ant_mutex);
+    s_cfg = *cfg;
+    s_handle = handle;
+    s_current = cfg->current;
+    rbf_mutex_unlock(s_ant_mutex);
+
+    return 0;
+}
+
+
+int rbf_ant_survey_start(const RBF_dev_id_t* ids, uint8_t count)
+{
+    if (s_ant_mutex == NULL || count > RBF_ANT_DEVICES_MAX || (ids == NULL && count)) {
+        return -1;
+    }
+
+    rbf_mutex_lock(s_ant_mutex);
+    if (s_surveying) {
+        rbf_mutex_unlock(s_ant_mutex);
+        return -1;
+    }
+    if (count && ids != s_ids) {
+        memcpy(s_ids, ids, sizeof(RBF_dev_id_t) * count);
+    }
+    s_id_count = count;
+    memset(s_devs, 0, sizeof(s_devs));
+    memset(s_result.valid, 0, sizeof(s_result.valid));
+    s_step = -1;
+    s_step_ok = false;
+    s_surveying = true;
+    rbf_time_get_ms(&s_survey_ms);
+    rbf_mutex_unlock(s_ant_mutex);
+
+    if (s_id_count) {
+        rbf_start_rssi(s_ids, s_id_count);
+    }
+    return 0;
+}
+
+
+int rbf_ant_survey_cancel(void)
+{
+    RBF_ant_index_t current;
+
+    if (s_ant_mutex == NULL) {
+        return -1;
+    }
+
+    rbf_mutex_lock(s_ant_mutex);
+    if (!s_surveying) {
+        rbf_mutex_unlock(s_ant_mutex);
+        return -1;
+    }
+    s_surveying = false;
+    current = s_current;
+    rbf_mutex_unlock(s_ant_mutex);
+
+    if (s_id_count) {
+        rbf_stop_rssi(s_ids, s_id_count);
+    }
+    return rbf_change_ant(current);
+}
+
+
+int rbf_ant_poll(void)
+{
+    rbf_ant_evt_handle_t handle = NULL;
+    rbf_ant_result_t result;
+    rbf_time_t now;
+    int8_t step;
+    int avg;
+    int real;
+
+    if (s_ant_mutex == NULL) {
+        return -1;
+    }
+
+    rbf_time_get_ms(&now);
+    if (!s_surveying) {
+        if (s_cfg.period_ms && s_surveyed && now - s_survey_ms >= s_cfg.period_ms) {
+            return rbf_ant_survey_start(s_id_count ? s_ids : NULL, s_id_count);
+        }
+        return 0;
+    }
+    if (s_step >= 0 && now - s_step_ms < s_cfg.dwell_ms) {
+        return 0;
+    }
+
+    /* End of the dwell: the hub noise average covers the antenna being measured */
+    if (s_step >= 0 && s_step_ok && 0 == rbf_get_hub_rssi_ex(&avg, &real)) {
+        rbf_mutex_lock(s_ant_mutex);
+        s_result.noise[s_step] = avg;
+        s_result.valid[s_step] = true;
+        rbf_mutex_unlock(s_ant_mutex);
+    }
+
+    step = ant_next(s_step);
+    if (step < RBF_ANT_COUNT) {
+        bool ok;
+
+        rbf_mutex_lock(s_ant_mutex);
+        s_step_ok = false;
+        rbf_mutex_unlock(s_ant_mutex);
+        ok = 0 == rbf_change_ant((RBF_ant_index_t)step);
+
+        /* An antenna that cannot be selected is skipped by the next poll */
+        rbf_mutex_lock(s_ant_mutex);
+        s_step = step;
+        s_step_ok = ok;
+        s_step_ms = ok ? now : now - s_cfg.dwell_ms;
+        rbf_mutex_unlock(s_ant_mutex);
+        return ok ? 0 : -1;
+    }
+
+    rbf_mutex_lock(s_ant_mutex);
+    ant_select();
+    s_surveying = false;
+    s_surveyed = true;
+    s_survey_ms = now;
+    result = s_result;
+    handle = s_handle;
+    rbf_mutex_unlock(s_ant_mutex);
+
+    if (s_id_count) {
+        rbf_stop_rssi(s_ids, s_id_count);
+    }
+    rbf_change_ant(result.selected);
+    if (handle != NULL) {
+        handle(&result);
+    }
+    return 0;
+}
+
+
+int rbf_ant_result_get(rbf_ant_result_t* result)
+{
+    if (s_ant_mutex == NULL || result == NULL || !s_surveyed) {
+        return -1;
+    }
+
+    rbf_mutex_lock(s_ant_mutex);
+    *result = s_result;
+    rbf_mutex_unlock(s_ant_mutex);
+
+    return 0;
+}
@@ -0,0 +1,458 @@
+/**
+ * @file rbf_cmd_queue.c
+ * @brief Coalescing downlink command queue: only the latest command per device and kind is sent
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+#include <string.h>
+#include <stdbool.h>
+#include "rbf_cmd_queue.h"
+#include "rbf_observer.h"
+#include "rbf_mutex.h"
+#include "rbf_time.h"
+
+typedef struct
+{
+    bool pending;
+    bool in_flight;
+    bool delivered;         /**< The command in flight was sent, its device can end it */
+    uint8_t tries;          /**< Failed sends of the pending command */
+    uint32_t seq;           /**< Queue order of the pending command */
+    uint32_t sent_seq;      /**< Queue order of the command in flight */
+    rbf_time_t sent_ms;
+    rbf_cmd_t next;         /**< Pending command */
+    rbf_cmd_t sent;         /**< Command in flight */
+}cmd_slot_t;
+
+static rbf_mutex_t s_queue_mutex;
+static cmd_slot_t s_slots[RBF_CMD_QUEUE_MAX];
+static uint32_t s_seq;
+static rbf_cmd_queue_stats_t s_stats;
+
+
+static uint32_t cmd_param_size(rbf_cmd_kind_t kind)
+{
+    switch (kind) {
+    case RBF_CMD_RELAY_CTRL:
+        return sizeof(rbf_relay_ctrl_t);
+    case RBF_CMD_WALL_SWITCH_CTRL:
+        return sizeof(rbf_wall_switch_ctrl_t);
+    case RBF_CMD_SMARTPLUG_CTRL:
+        return sizeof(rbf_smartplug_ctrl_t);
+    case RBF_CMD_KEYPAD_SET:
+        return sizeof(rbf_keypad_settings_t);
+    case RBF_CMD_PIR_SET:
+        return sizeof(rbf_pir_config_t);
+    case RBF_CMD_TEMP_HUMI_SET:
+        return sizeof(rbf_temp_humi_config_t);
+    case RBF_CMD_SOUNDER_VOLUME:
+        return sizeof(RBF_sounder_volume_t);
+    case RBF_CMD_INDOOR_SIREN_VOLUME:
+        return sizeof(RBF_indoor_siren_volume_t);
+    default:
+        return sizeof(RBF_led_indicate_t);
+    }
+}
+
+
+/* Same parameters, compared field by field: the padding of the structures is not compared */
+static bool cmd_param_equal(rbf_cmd_kind_t kind, const rbf_cmd_t* a, const rbf_cmd_t* b)
+{
+    switch (kind) {
+    case RBF_CMD_RELAY_CTRL:
+        return a->param.relay.action == b->param.relay.action;
+    case RBF_CMD_WALL_SWITCH_CTRL:
+        return a->param.wall_switch.action == b->param.wall_switch.action;
+    case RBF_CMD_SMARTPLUG_CTRL:
+        return a->param.smartplug.action == b->param.smartplug.action
+               && a->param.smartplug.lock == b->param.smartplug.lock;
+    case RBF_CMD_KEYPAD_SET:
+        return a->param.keypad.alarm_tone_play == b->param.keypad.alarm_tone_play
+               && a->param.keypad.err_led_state == b->param.keypad.err_led_state
+               && a->param.keypad.arm_led_state == b->param.keypad.arm_led_state
+               && a->param.keypad.warn_led_state == b->param.keypad.warn_led_state
+               && a->param.keypad.enable_key_tone == b->param.keypad.enable_key_tone
+               && a->param.keypad.backlight_time == b->param.keypad.backlight_time
+               && a->param.keypad.lock_state == b->param.keypad.lock_state;
+    case RBF_CMD_PIR_SET:
+        return a->param.pir.tamper_enable == b->param.pir.tamper_enable
+               && a->param.pir.sensitivity == b->param.pir.sensitivity;
+    case RBF_CMD_TEMP_HUMI_SET:
+        return a->param.temp_humi.temp_units == b->param.temp_humi.temp_units
+               && a->param.temp_humi.temp_threshold == b->param.temp_humi.temp_threshold
+               && a->param.temp_humi.humi_threshold == b->param.temp_humi.humi_threshold;
+    case RBF_CMD_SOUNDER_VOLUME:
+        return a->param.sounder_volume == b->param.sounder_volume;
+    case RBF_CMD_INDOOR_SIREN_VOLUME:
+        return a->param.indoor_siren_volume == b->param.indoor_siren_volume;
+    default:
+        return a->param.led_indicate.mode == b->param.led_indicate.mode
+               && a->param.led_indicate.duration == b->param.led_indicate.duration;
+    }
+}
+
+
+/* Category of the target device */
+static RBF_dev_cat_t cmd_cat(const rbf_cmd_t* cmd)
+{
+    switch (cmd->kind) {
+    case RBF_CMD_KEYPAD_SET:
+        return RBF_DEV_KEYPAD;
+    case RBF_CMD_SOUNDER_VOLUME:
+    case RBF_CMD_INDOOR_SIREN_VOLUME:
+        return RBF_DEV_SOUNDER;
+    case RBF_CMD_LED_INDICATE:
+        return cmd->id.cat;
+    default:
+        return RBF_DEV_IO;
+    }
+}
+
+
+static bool cmd_same_target(const rbf_cmd_t* a, const rbf_cmd_t* b)
+{
+    if (a->kind != b->kind || a->id.no != b->id.no) {
+        return false;
+    }
+    return a->kind != RBF_CMD_LED_INDICATE || a->id.cat == b->id.cat;
+}
+
+
+static bool cmd_is_toggle(const rbf_cmd_t* cmd)
+{
+    switch (cmd->kind) {
+    case RBF_CMD_RELAY_CTRL:
+        return cmd->param.relay.action == RBF_RELAY_ACTION_TOOGLE;
+    case RBF_CMD_WALL_SWITCH_CTRL:
+        return cmd->param.wall_switch.action == RBF_WALL_SWITCH_ACTION_TOOGLE;
+    case RBF_CMD_SMARTPLUG_CTRL:
+        return cmd->param.smartplug.action == RBF_SMARTPLUG_ACTION_TOOGLE;
+    default:
+        return false;
+    }
+}
+
+
+/**
+ * Merge the command queued after first into first. A toggle is relative: it inverts an on/off
+ * and cancels another toggle, any other command replaces first.
+ * Returns false when nothing is left to send.
+ */
+static bool cmd_merge(rbf_cmd_t* first, const rbf_cmd_t* then)
+{
+    if (!cmd_is_toggle(then)) {
+        *first = *then;
+        return true;
+    }
+    if (cmd_is_toggle(first)) {
+        return false;
+    }
+
+    switch (then->kind) {
+    case RBF_CMD_RELAY_CTRL: {
+        rbf_relay_action_t action = first->param.relay.action;
+        first->param.relay = then->param.relay;
+        first->param.relay.action = action == RBF_RELAY_ACTION_ON ? RBF_RELAY_ACTION_OFF
+                                    : (action == RBF_RELAY_ACTION_OFF ? RBF_RELAY_ACTION_ON : RBF_RELAY_ACTION_TOOGLE);
+        break;
+    }
+    case RBF_CMD_WALL_SWITCH_CTRL: {
+        rbf_wall_switch_action_t action = first->param.wall_switch.action;
+        first->param.wall_switch = then->param.wall_switch;
+        first->param.wall_switch.action = action == RBF_WALL_SWITCH_ACTION_ON ? RBF_WALL_SWITCH_ACTION_OFF
+                                          : (action == RBF_WALL_SWITCH_ACTION_OFF ? RBF_WALL_SWITCH_ACTION_ON
+                                             : RBF_WALL_SWITCH_ACTION_TOOGLE);
+        break;
+    }
+    default: {
+        rbf_smartplug_action_t action = first->param.smartplug.action;
+        first->param.smartplug = then->param.smartplug;
+        first->param.smartplug.action = action == RBF_SMARTPLUG_ACTION_ON ? RBF_SMARTPLUG_ACTION_OFF
+                                        : (action == RBF_SMARTPLUG_ACTION_OFF ? RBF_SMARTPLUG_ACTION_ON
+                                           : RBF_SMARTPLUG_ACTION_TOOGLE);
+        break;
+    }
+    }
+    return true;
+}
+
+
+int rbf_cmd_send(const rbf_cmd_t* cmd)
+{
+    rbf_cmd_t c;
+    int ret;
+
+    if (cmd == NULL) {
+        return -1;
+    }
+
+    /* The SDK calls take non-const parameters */
+    c = *cmd;
+    switch (c.kind) {
+    case RBF_CMD_RELAY_CTRL:
+        ret = rbf_relay_ctrl(c.id.no, &c.param.relay);
+        break;
+    case RBF_CMD_WALL_SWITCH_CTRL:
+        ret = rbf_wall_switch_ctrl(c.id.no, &c.param.wall_switch);
+        break;
+    case RBF_CMD_SMARTPLUG_CTRL:
+        ret = rbf_smartplug_ctrl(c.id.no, &c.param.smartplug);
+        break;
+    case RBF_CMD_KEYPAD_SET:
+        ret = rbf_keypad_set(c.id.no, &c.param.keypad);
+        break;
+    case RBF_CMD_PIR_SET:
+        ret = rbf_pir_set(c.id.no, &c.param.pir);
+        break;
+    case RBF_CMD_TEMP_HUMI_SET:
+        ret = rbf_temp_humi_set(c.id.no, &c.param.temp_humi);
+        break;
+    case RBF_CMD_SOUNDER_VOLUME:
+        ret = rbf_sounder_volume_set(c.id.no, c.param.sounder_volume);
+        break;
+    case RBF_CMD_INDOOR_SIREN_VOLUME:
+        ret = rbf_indoor_siren_volume_set(c.id.no, c.param.indoor_siren_volume);
+        break;
+    case RBF_CMD_LED_INDICATE:
+        ret = rbf_device_led_indicate_set(&c.id, &c.param.led_indicate);
+        break;
+    default:
+        return -1;
+    }
+
+    if (ret == 0) {
+        rbf_observer_tx(RBF_OBSERVER_TX_P2P, (uint16_t)cmd_param_size(c.kind));
+    }
+    return ret;
+}
+
+
+static int cmd_queue_observer(const rbf_observer_msg_t* msg, void* arg)
+{
+    rbf_cmd_kind_t kind = RBF_CMD_KIND_MAX;
+    uint8_t i;
+
+    (void)arg;
+    if (msg->msg == RBF_OBSERVER_MSG_OUTPUT_STATUS) {
+        switch (msg->type) {
+        case RBF_DEV_TYPE_RELAY:
+            kind = RBF_CMD_RELAY_CTRL;
+            break;
+        case RBF_DEV_TYPE_WALL_SWITCH:
+            kind = RBF_CMD_WALL_SWITCH_CTRL;
+            break;
+        case RBF_DEV_TYPE_SMART_PLUG:
+            kind = RBF_CMD_SMARTPLUG_CTRL;
+            break;
+        default:
+            return RBF_OBSERVER_PASS;
+        }
+    } else if (msg->msg != RBF_OBSERVER_MSG_HEARTBEAT) {
+        return RBF_OBSERVER_PASS;
+    }
+
+    /*
+     * The device was seen after the send: an output status ends the output control of its
+     * kind, a heartbeat ends every command of the device. The next command for it can go.
+     */
+    rbf_mutex_lock(s_queue_mutex);
+    for (i = 0; i < RBF_CMD_QUEUE_MAX; i++) {
+        cmd_slot_t* slot = &s_slots[i];
+
+        if (slot->in_flight && slot->delivered && slot->sent.id.no == msg->id.no && cmd_cat(&slot->sent) == msg->id.cat
+            && (kind == RBF_CMD_KIND_MAX || slot->sent.kind == kind)) {
+            slot->in_flight = false;
+            s_stats.confirmed++;
+        }
+    }
+    rbf_mutex_unlock(s_queue_mutex);
+
+    return RBF_OBSERVER_PASS;
+}
+
+
+int rbf_cmd_queue_init(void)
+{
+    if (s_queue_mutex != NULL) {
+        return 0;
+    }
+
+    s_queue_mutex = rbf_mutex_create();
+    if (s_queue_mutex == NULL) {
+        return -1;
+    }
+    return rbf_observer_add(cmd_queue_observer, NULL);
+}
+
+
+int rbf_cmd_queue_put(const rbf_cmd_t* cmd)
+{
+    cmd_slot_t* free_slot = NULL;
+    cmd_slot_t* slot = NULL;
+    uint8_t i;
+
+    if (s_queue_mutex == NULL || cmd == NULL || cmd->kind >= RBF_CMD_KIND_MAX) {
+        return -1;
+    }
+
+    rbf_mutex_lock(s_queue_mutex);
+    for (i = 0; i < RBF_CMD_QUEUE_MAX; i++) {
+        cmd_slot_t* s = &s_slots[i];
+
+        if (!s->pending && !s->in_flight) {
+            if (free_slot == NULL) {
+                free_slot = s;
+            }
+            continue;
+        }
+        if (cmd_same_target(s->pending ? &s->next : &s->sent, cmd)) {
+            slot = s;
+            break;
+        }
+    }
+
+    if (slot == NULL) {
+        slot = free_slot;
+        if (slot == NULL) {
+            rbf_mutex_unlock(s_queue_mutex);
+            return -1;
+        }
+    }
+
+    s_stats.queued++;
+    if (slot->pending) {
+        /* Keep the queue position of the replaced command */
+        if (cmd_merge(&slot->next, cmd)) {
+            s_stats.superseded++;
+        } else {
+            slot->pending = false;
+            s_stats.pending--;
+            s_stats.cancelled += 2;
+        }
+    } else if (slot->in_flight && !cmd_is_toggle(cmd) && cmd_param_equal(cmd->kind, &slot->sent, cmd)) {
+        /* Same as the command in flight */
+        s_stats.superseded++;
+    } else {
+        slot->next = *cmd;
+        slot->pending = true;
+        slot->tries = 0;
+        slot->seq = s_seq++;
+        s_stats.pending++;
+    }
+    rbf_mutex_unlock(s_queue_mutex);
+
+    return 0;
+}
+
+
+/* Put a command that could not be sent back in front of the one queued since */
+static void cmd_requeue(cmd_slot_t* slot)
+{
+    rbf_cmd_t cmd = slot->sent;
+
+    slot->in_flight = false;
+    if (++slot->tries > RBF_CMD_QUEUE_RETRIES) {
+        s_stats.dropped++;
+        return;
+    }
+
+    if (slot->pending) {
+        if (!cmd_merge(&cmd, &slot->next)) {
+            slot->pending = false;
+            s_stats.pending--;
+            s_stats.cancelled += 2;
+            return;
+        }
+    } else {
+        slot->pending = true;
+        s_stats.pending++;
+    }
+    slot->next = cmd;
+    slot->seq = slot->sent_seq;
+}
+
+
+int rbf_cmd_queue_poll(void)
+{
+    rbf_cmd_t cmds[RBF_CMD_QUEUE_BURST];
+    cmd_slot_t* slots[RBF_CMD_QUEUE_BURST];
+    uint8_t count = 0;
+    rbf_time_t now;
+    uint8_t i;
+
+    if (s_queue_mutex == NULL) {
+        return 0;
+    }
+
+    rbf_time_get_ms(&now);
+    rbf_mutex_lock(s_queue_mutex);
+#if RBF_CMD_QUEUE_HOLD_MS > 0
+    for (i = 0; i < RBF_CMD_QUEUE_MAX; i++) {
+        if (s_slots[i].in_flight && s_slots[i].delivered && now - s_slots[i].sent_ms >= RBF_CMD_QUEUE_HOLD_MS) {
+            s_slots[i].in_flight = false;
+            s_stats.expired++;
+        }
+    }
+#endif
+
+    while (count < RBF_CMD_QUEUE_BURST) {
+        cmd_slot_t* oldest = NULL;
+
+        for (i = 0; i < RBF_CMD_QUEUE_MAX; i++) {
+            cmd_slot_t* s = &s_slots[i];
+
+            if (s->pending && !s->in_flight && (oldest == NULL || (int32_t)(s->seq - oldest->seq) < 0)) {
+                oldest = s;
+            }
+        }
+        if (oldest == NULL) {
+            break;
+        }
+
+        oldest->pending = false;
+        oldest->in_flight = true;
+        oldest->delivered = false;
+        oldest->sent = oldest->next;
+        oldest->sent_seq = oldest->seq;
+        s_stats.pending--;
+        slots[count] = oldest;
+        cmds[count++] = oldest->next;
+    }
+    rbf_mutex_unlock(s_queue_mutex);
+
+    for (i = 0; i < count; i++) {
+        int ret = rbf_cmd_send(&cmds[i]);
+
+        rbf_time_get_ms(&now);
+        rbf_mutex_lock(s_queue_mutex);
+        s_stats.sent++;
+        if (ret != 0) {
+            s_stats.failed++;
+            cmd_requeue(slots[i]);
+        } else {
+            slots[i]->tries = 0;
+            slots[i]->delivered = true;
+            slots[i]->sent_ms = now;
+        }
+        rbf_mutex_unlock(s_queue_mutex);
+    }
+
+    return count;
+}
+
+
+int rbf_cmd_queue_stats_get(rbf_cmd_queue_stats_t* stats)
+{
+    if (stats == NULL || s_queue_mutex == NULL) {
+        return -1;
+    }
+
+    rbf_mutex_lock(s_queue_mutex);
+    *stats = s_stats;
+    rbf_mutex_unlock(s_queue_mutex);
+
+    return 0;
+}
@@ -0,0 +1,177 @@
+/**
+ * @file rbf_dedup.c
+ * @brief Duplicate suppression of the input status and event retransmissions of the sub-devices
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+#include <string.h>
+#include "rbf_dedup.h"
+#include "rbf_observer.h"
+#include "rbf_mutex.h"
+
+#define DEDUP_MASK              (RBF_DEDUP_MAX - 1)
+#define DEDUP_FNV_OFFSET        (2166136261u)
+#define DEDUP_FNV_PRIME         (16777619u)
+
+typedef struct
+{
+    uint32_t key;               /**< Device and message type, 0 for a free entry */
+    uint32_t hash;              /**< Hash of the last message */
+    rbf_time_t time;            /**< Arrival of the first copy of the last message */
+}dedup_entry_t;
+
+static rbf_mutex_t s_dedup_mutex;
+static dedup_entry_t s_entries[RBF_DEDUP_MAX];
+static uint32_t s_window_ms;
+static uint32_t s_evt_window_ms = RBF_DEDUP_EVT_WINDOW_MS;
+static rbf_dedup_stats_t s_stats;
+
+
+static uint32_t dedup_fnv(uint32_t hash, const uint8_t* data, uint32_t size)
+{
+    uint32_t i;
+
+    for (i = 0; i < size; i++) {
+        hash = (hash ^ data[i]) * DEDUP_FNV_PRIME;
+    }
+    return hash;
+}
+
+
+static uint32_t dedup_hash(const rbf_observer_msg_t* msg)
+{
+    uint32_t hash = dedup_fnv(DEDUP_FNV_OFFSET, (const uint8_t*)&msg->value, sizeof(msg->value));
+
+    return dedup_fnv(hash, msg->payload, rbf_observer_payload_size(msg));
+}
+
+
+static uint32_t dedup_window(uint32_t key)
+{
+    return (key & 0xFF) == RBF_OBSERVER_MSG_INPUT_EVT ? s_evt_window_ms : s_window_ms;
+}
+
+
+/* Entry of the key, or the entry to reuse for it */
+static dedup_entry_t* dedup_lookup(uint32_t key, rbf_time_t now)
+{
+    dedup_entry_t* free_entry = NULL;
+    dedup_entry_t* oldest = NULL;
+    uint32_t i;
+
+    for (i = 0; i < RBF_DEDUP_MAX; i++) {
+        dedup_entry_t* entry = &s_entries[(key * DEDUP_FNV_PRIME + i) & DEDUP_MASK];
+
+        if (entry->key == key) {
+            return entry;
+        }
+        if (entry->key == 0) {
+            return free_entry != NULL ? free_entry : entry;
+        }
+        if (free_entry == NULL && now - entry->time >= dedup_window(entry->key)) {
+            free_entry = entry;
+        }
+        if (oldest == NULL || (long)(entry->time - oldest->time) < 0) {
+            oldest = entry;
+        }
+    }
+
+    if (free_entry != NULL) {
+        return free_entry;
+    }
+    s_stats.evicted++;
+    return oldest;
+}
+
+
+static int dedup_observer(const rbf_observer_msg_t* msg, void* arg)
+{
+    dedup_entry_t* entry;
+    uint32_t key;
+    uint32_t hash;
+    uint32_t window_ms;
+    int ret = RBF_OBSERVER_PASS;
+
+    (void)arg;
+    if (msg->msg != RBF_OBSERVER_MSG_INPUT_STATUS && msg->msg != RBF_OBSERVER_MSG_INPUT_EVT) {
+        return RBF_OBSERVER_PASS;
+    }
+
+    key = ((uint32_t)msg->id.cat << 16) | ((uint32_t)msg->id.no << 8) | (uint32_t)msg->msg;
+    hash = dedup_hash(msg);
+
+    rbf_mutex_lock(s_dedup_mutex);
+    window_ms = dedup_window(key);
+    if (window_ms == 0) {
+        /* Event suppression not enabled: a repeated event is a new press or detection */
+        rbf_mutex_unlock(s_dedup_mutex);
+        return RBF_OBSERVER_PASS;
+    }
+    s_stats.checked++;
+    entry = dedup_lookup(key, msg->time);
+    if (entry->key == key && entry->hash == hash && msg->time - entry->time < window_ms) {
+        if (msg->msg == RBF_OBSERVER_MSG_INPUT_STATUS) {
+            s_stats.suppressed_status++;
+        } else {
+            s_stats.suppressed_evt++;
+        }
+        ret = RBF_OBSERVER_DROP;
+    } else {
+        entry->key = key;
+        entry->hash = hash;
+        entry->time = msg->time;
+    }
+    rbf_mutex_unlock(s_dedup_mutex);
+
+    return ret;
+}
+
+
+int rbf_dedup_init(uint32_t window_ms)
+{
+    s_window_ms = window_ms ? window_ms : RBF_DEDUP_WINDOW_MS;
+    if (s_dedup_mutex != NULL) {
+        return 0;
+    }
+
+    s_dedup_mutex = rbf_mutex_create();
+    if (s_dedup_mutex == NULL) {
+        return -1;
+    }
+    return rbf_observer_add(dedup_observer, NULL);
+}
+
+
+int rbf_dedup_evt_window_set(uint32_t window_ms)
+{
+    if (window_ms > RBF_DEDUP_EVT_WINDOW_MAX_MS) {
+        return -1;
+    }
+
+    if (s_dedup_mutex != NULL) {
+        rbf_mutex_lock(s_dedup_mutex);
+    }
+    s_evt_window_ms = window_ms;
+    if (s_dedup_mutex != NULL) {
+        rbf_mutex_unlock(s_dedup_mutex);
+    }
+
+    return 0;
+}
+
+
+int rbf_dedup_stats_get(rbf_dedup_stats_t* stats)
+{
+    if (s_dedup_mutex == NULL || stats == NULL) {
+        return -1;
+    }
+
+    rbf_mutex_lock(s_dedup_mutex);
+    *stats = s_stats;
+    rbf_mutex_unlock(s_dedup_mutex);
+
+    return 0;
+}
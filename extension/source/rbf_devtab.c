@@ -0,0 +1,241 @@
+/**
+ * @file rbf_devtab.c
+ * @brief Registered device table, kept in step with the registrations and deletions
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+#include <string.h>
+#include "rbf_devtab.h"
+#include "rbf_mutex.h"
+
+#define DEVTAB_NONE             (0xFF)
+
+#if RBF_DEVTAB_MAX > 254
+#error "RBF_DEVTAB_MAX is at most 254"
+#endif
+
+static rbf_mutex_t s_devtab_mutex;
+static RBF_evt_callbacks_t s_user_cbs;
+static uint8_t s_map[RBF_DEV_UNKNOW - RBF_DEV_IO][256];    /**< (cat, no) to entry */
+static rbf_devtab_entry_t s_entries[RBF_DEVTAB_MAX];       /**< Dense, in registration order */
+static uint8_t s_count;
+
+
+static uint8_t* devtab_map(RBF_dev_cat_t cat, uint8_t no)
+{
+    if (cat < RBF_DEV_IO || cat >= RBF_DEV_UNKNOW) {
+        return NULL;
+    }
+    return &s_map[cat - RBF_DEV_IO][no];
+}
+
+
+static rbf_devtab_entry_t* devtab_add(RBF_dev_cat_t cat, uint8_t no)
+{
+    uint8_t* map = devtab_map(cat, no);
+    rbf_devtab_entry_t* entry;
+
+    if (map == NULL) {
+        return NULL;
+    }
+    if (*map != DEVTAB_NONE) {
+        return &s_entries[*map];
+    }
+    if (s_count == RBF_DEVTAB_MAX) {
+        return NULL;
+    }
+
+    *map = s_count++;
+    entry = &s_entries[*map];
+    memset(entry, 0, sizeof(rbf_devtab_entry_t));
+    entry->id.cat = cat;
+    entry->id.no = no;
+    entry->type = RBF_DEV_TYPE_UNKNOW;
+    return entry;
+}
+
+
+/* The last entry moves into the hole */
+static int devtab_remove(RBF_dev_cat_t cat, uint8_t no)
+{
+    uint8_t* map = devtab_map(cat, no);
+    uint8_t index;
+
+    if (map == NULL || *map == DEVTAB_NONE) {
+        return -1;
+    }
+
+    index = *map;
+    *map = DEVTAB_NONE;
+    s_count--;
+    if (index != s_count) {
+        s_entries[index] = s_entries[s_count];
+        *devtab_map(s_entries[index].id.cat, s_entries[index].id.no) = index;
+    }
+    return 0;
+}
+
+
+static int devtab_register_reponse_handle(RBF_register_response_t* reponse)
+{
+    if (reponse != NULL && reponse->err == 0) {
+        rbf_devtab_entry_t* entry;
+
+        rbf_mutex_lock(s_devtab_mutex);
+        entry = devtab_add(reponse->cat, reponse->no);
+        if (entry != NULL) {
+            /* The number may have belonged to a deleted device */
+            entry->type = reponse->type;
+            memcpy(entry->ver, reponse->ver, sizeof(entry->ver));
+            memcpy(entry->sn, reponse->sn, sizeof(entry->sn));
+            memcpy(entry->mac, reponse->mac, sizeof(entry->mac));
+        }
+        rbf_mutex_unlock(s_devtab_mutex);
+    }
+
+    if (s_user_cbs.rbf_dev_register_reponse_handle == NULL) {
+        return 0;
+    }
+    return s_user_cbs.rbf_dev_register_reponse_handle(reponse);
+}
+
+
+static int devtab_register_info_handle(RBF_dev_id_t* ids, int count)
+{
+    uint32_t registered[RBF_DEV_UNKNOW - RBF_DEV_IO][256 / 32];
+    int valid = ids != NULL ? count : 0;
+    uint8_t i;
+    int j;
+
+    memset(registered, 0, sizeof(registered));
+    for (j = 0; j < valid; j++) {
+        if (ids[j].cat >= RBF_DEV_IO && ids[j].cat < RBF_DEV_UNKNOW) {
+            registered[ids[j].cat - RBF_DEV_IO][ids[j].no / 32] |= 1UL << (ids[j].no % 32);
+        }
+    }
+
+    rbf_mutex_lock(s_devtab_mutex);
+    /* Remove first to make room. Walk down: removing moves the last entry, already checked, into the hole */
+    for (i = s_count; i > 0; i--) {
+        const RBF_dev_id_t* id = &s_entries[i - 1].id;
+
+        if (!(registered[id->cat - RBF_DEV_IO][id->no / 32] & (1UL << (id->no % 32)))) {
+            devtab_remove(id->cat, id->no);
+        }
+    }
+    for (j = 0; j < valid; j++) {
+        devtab_add(ids[j].cat, ids[j].no);
+    }
+    rbf_mutex_unlock(s_devtab_mutex);
+
+    if (s_user_cbs.rbf_dev_register_info_handle == NULL) {
+        return 0;
+    }
+    return s_user_cbs.rbf_dev_register_info_handle(ids, count);
+}
+
+
+int rbf_devtab_wrap(RBF_evt_callbacks_t* cbs)
+{
+    if (cbs == NULL) {
+        return -1;
+    }
+
+    if (s_devtab_mutex == NULL) {
+        s_devtab_mutex = rbf_mutex_create();
+        if (s_devtab_mutex == NULL) {
+            return -1;
+        }
+        memset(s_map, DEVTAB_NONE, sizeof(s_map));
+    }
+
+    s_user_cbs = *cbs;
+    cbs->rbf_dev_register_reponse_handle = devtab_register_reponse_handle;
+    cbs->rbf_dev_register_info_handle = devtab_register_info_handle;
+
+    return 0;
+}
+
+
+int rbf_devtab_index(const RBF_dev_id_t* id)
+{
+    const uint8_t* map;
+
+    if (s_devtab_mutex == NULL || id == NULL) {
+        return -1;
+    }
+
+    /* A single byte read, no lock needed */
+    map = devtab_map(id->cat, id->no);
+    return map != NULL && *map != DEVTAB_NONE ? *map : -1;
+}
+
+
+int rbf_devtab_get(const RBF_dev_id_t* id, rbf_devtab_entry_t* entry)
+{
+    const uint8_t* map;
+    int ret = -1;
+
+    if (s_devtab_mutex == NULL || id == NULL || entry == NULL) {
+        return -1;
+    }
+
+    rbf_mutex_lock(s_devtab_mutex);
+    map = devtab_map(id->cat, id->no);
+    if (map != NULL && *map != DEVTAB_NONE) {
+        *entry = s_entries[*map];
+        ret = 0;
+    }
+    rbf_mutex_unlock(s_devtab_mutex);
+
+    return ret;
+}
+
+
+int rbf_devtab_at(uint16_t index, rbf_devtab_entry_t* entry)
+{
+    int ret = -1;
+
+    if (s_devtab_mutex == NULL || entry == NULL) {
+        return -1;
+    }
+
+    rbf_mutex_lock(s_devtab_mutex);
+    if (index < s_count) {
+        *entry = s_entries[index];
+        ret = 0;
+    }
+    rbf_mutex_unlock(s_devtab_mutex);
+
+    return ret;
+}
+
+
+uint16_t rbf_devtab_count(void)
+{
+    return s_count;
+}
+
+
+int rbf_devtab_remove(const RBF_dev_id_t* id)
+{
+    int ret = 0;
+
+    if (s_devtab_mutex == NULL) {
+        return -1;
+    }
+
+    rbf_mutex_lock(s_devtab_mutex);
+    if (id == NULL) {
+        memset(s_map, DEVTAB_NONE, sizeof(s_map));
+        s_count = 0;
+    } else {
+        ret = devtab_remove(id->cat, id->no);
+    }
+    rbf_mutex_unlock(s_devtab_mutex);
+
+    return ret;
+}
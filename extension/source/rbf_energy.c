@@ -0,0 +1,341 @@
+/**
+ * @file rbf_energy.c
+ * @brief Energy aggregation of smartplug and wall switch heartbeats
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+#include <string.h>
+#include "rbf_energy.h"
+#include "rbf_observer.h"
+#include "rbf_mutex.h"
+#include "rbf_time.h"
+
+#define ENERGY_HOUR_S           (3600)
+#define ENERGY_DAY_S            (86400)
+#define ENERGY_WRAP_MARGIN      (0x10000)   /**< A cumu_power step back from this close to UINT32_MAX is a wrap */
+
+typedef struct
+{
+    bool used;
+    uint8_t no;
+    uint8_t type;
+    bool has_sample;
+    bool has_meter;
+    uint32_t last_time;
+    uint32_t last_power;
+    uint32_t last_cumu;
+    uint32_t meter;
+    uint64_t total;
+    uint32_t rem;               /**< Integration remainder in 1/36 of the energy unit */
+    uint32_t first_hour;
+    uint32_t hour_now;
+    uint32_t first_day;
+    uint32_t day_now;
+    uint32_t hour_energy[RBF_ENERGY_HOURS];
+    uint32_t hour_peak[RBF_ENERGY_HOURS];
+    uint32_t day_energy[RBF_ENERGY_DAYS];
+    uint32_t day_peak[RBF_ENERGY_DAYS];
+}energy_dev_t;
+
+static energy_dev_t s_devs[RBF_ENERGY_DEVICES];
+static rbf_energy_time_t s_energy_now;
+static rbf_mutex_t s_energy_mutex;
+
+
+static uint32_t energy_now(void)
+{
+    rbf_time_t ms;
+
+    if (s_energy_now != NULL) {
+        return s_energy_now();
+    }
+    rbf_time_get_ms(&ms);
+    return (uint32_t)(ms / 1000);
+}
+
+
+static void energy_advance(energy_dev_t* dev, uint32_t now)
+{
+    uint32_t hour = now / ENERGY_HOUR_S;
+    uint32_t day = now / ENERGY_DAY_S;
+    uint32_t n;
+
+    /* Clear the slots of the hours and days entered since the last call */
+    for (n = 0; dev->hour_now != hour && n < RBF_ENERGY_HOURS; n++) {
+        dev->hour_now++;
+        dev->hour_energy[dev->hour_now % RBF_ENERGY_HOURS] = 0;
+        dev->hour_peak[dev->hour_now % RBF_ENERGY_HOURS] = 0;
+    }
+    dev->hour_now = hour;
+
+    for (n = 0; dev->day_now != day && n < RBF_ENERGY_DAYS; n++) {
+        dev->day_now++;
+        dev->day_energy[dev->day_now % RBF_ENERGY_DAYS] = 0;
+        dev->day_peak[dev->day_now % RBF_ENERGY_DAYS] = 0;
+    }
+    dev->day_now = day;
+}
+
+
+static void energy_add(energy_dev_t* dev, uint32_t time, uint32_t energy)
+{
+    uint32_t hour = time / ENERGY_HOUR_S;
+    uint32_t day = time / ENERGY_DAY_S;
+
+    if (dev->hour_now - hour < RBF_ENERGY_HOURS) {
+        dev->hour_energy[hour % RBF_ENERGY_HOURS] += energy;
+    }
+    if (dev->day_now - day < RBF_ENERGY_DAYS) {
+        dev->day_energy[day % RBF_ENERGY_DAYS] += energy;
+    }
+    dev->total += energy;
+}
+
+
+/**
+ * Trapezoidal integration between two heartbeats, split at hour boundaries. The product is
+ * computed on 64 bits as the inst_power unit is device defined: the energy of one segment
+ * then fits 32 bits up to 34 million inst_power units with the default RBF_ENERGY_MAX_GAP_S.
+ */
+static void energy_integrate(energy_dev_t* dev, uint32_t from, uint32_t to, uint32_t power_sum)
+{
+    while (from < to) {
+        uint32_t end = (from / ENERGY_HOUR_S + 1) * ENERGY_HOUR_S;
+        uint64_t scaled;
+
+        if (end > to) {
+            end = to;
+        }
+
+        /* power_sum / 2 * s / 3600 * 1000 = power_sum * s * 5 / 36 */
+        scaled = (uint64_t)power_sum * (end - from) * 5 + dev->rem;
+        dev->rem = (uint32_t)(scaled % 36);
+        energy_add(dev, from, (uint32_t)(scaled / 36));
+        from = end;
+    }
+}
+
+
+static void energy_meter(energy_dev_t* dev, uint32_t cumu)
+{
+    if (dev->has_meter) {
+        if (cumu >= dev->last_cumu || dev->last_cumu > UINT32_MAX - ENERGY_WRAP_MARGIN) {
+            /* Unsigned difference also covers a counter wrap */
+            dev->meter += cumu - dev->last_cumu;
+        } else {
+            /* Counter cleared, with or without a device restart */
+            dev->meter += cumu;
+        }
+    }
+    dev->has_meter = true;
+    dev->last_cumu = cumu;
+}
+
+
+static energy_dev_t* energy_find(uint8_t no, bool create, uint32_t now)
+{
+    energy_dev_t* free_slot = NULL;
+    uint8_t i;
+
+    for (i = 0; i < RBF_ENERGY_DEVICES; i++) {
+        if (s_devs[i].used && s_devs[i].no == no) {
+            return &s_devs[i];
+        }
+        if (!s_devs[i].used && free_slot == NULL) {
+            free_slot = &s_devs[i];
+        }
+    }
+
+    if (!create || free_slot == NULL) {
+        return NULL;
+    }
+
+    memset(free_slot, 0, sizeof(energy_dev_t));
+    free_slot->used = true;
+    free_slot->no = no;
+    free_slot->first_hour = free_slot->hour_now = now / ENERGY_HOUR_S;
+    free_slot->first_day = free_slot->day_now = now / ENERGY_DAY_S;
+    return free_slot;
+}
+
+
+static void energy_sample(uint8_t no, RBF_dev_type_t type, uint32_t power, const rbf_smartplug_heartbeat_t* plug)
+{
+    energy_dev_t* dev;
+    uint32_t now = energy_now();
+
+    rbf_mutex_lock(s_energy_mutex);
+    dev = energy_find(no, true, now);
+    if (dev == NULL) {
+        rbf_mutex_unlock(s_energy_mutex);
+        return;
+    }
+
+    dev->type = (uint8_t)type;
+    energy_advance(dev, now);
+    if (dev->has_sample && now - dev->last_time <= RBF_ENERGY_MAX_GAP_S) {
+        energy_integrate(dev, dev->last_time, now, dev->last_power + power);
+    }
+    if (plug != NULL) {
+        energy_meter(dev, plug->cumu_power);
+    }
+
+    dev->has_sample = true;
+    dev->last_time = now;
+    dev->last_power = power;
+    if (power > dev->hour_peak[dev->hour_now % RBF_ENERGY_HOURS]) {
+        dev->hour_peak[dev->hour_now % RBF_ENERGY_HOURS] = power;
+    }
+    if (power > dev->day_peak[dev->day_now % RBF_ENERGY_DAYS]) {
+        dev->day_peak[dev->day_now % RBF_ENERGY_DAYS] = power;
+    }
+    rbf_mutex_unlock(s_energy_mutex);
+}
+
+
+static int energy_observer(const rbf_observer_msg_t* msg, void* arg)
+{
+    (void)arg;
+    if (msg->msg != RBF_OBSERVER_MSG_HEARTBEAT || msg->payload == NULL) {
+        return RBF_OBSERVER_PASS;
+    }
+
+    if (msg->type == RBF_DEV_TYPE_SMART_PLUG) {
+        const rbf_smartplug_heartbeat_t* heartbeat = msg->payload;
+        energy_sample(msg->id.no, msg->type, heartbeat->inst_power, heartbeat);
+    } else if (msg->type == RBF_DEV_TYPE_WALL_SWITCH) {
+        const rbf_wall_switch_heartbeat_t* heartbeat = msg->payload;
+        energy_sample(msg->id.no, msg->type, heartbeat->inst_power, NULL);
+    }
+    return RBF_OBSERVER_PASS;
+}
+
+
+int rbf_energy_init(rbf_energy_time_t now)
+{
+    if (s_energy_mutex == NULL) {
+        s_energy_mutex = rbf_mutex_create();
+        if (s_energy_mutex == NULL) {
+            return -1;
+        }
+        if (0 != rbf_observer_add(energy_observer, NULL)) {
+            return -1;
+        }
+    }
+
+    s_energy_now = now;
+    return 0;
+}
+
+
+int rbf_energy_summary_get(rbf_energy_summary_t* summaries, uint8_t max_summaries)
+{
+    uint32_t now = energy_now();
+    int count = 0;
+    uint8_t i;
+
+    if (s_energy_mutex == NULL || summaries == NULL) {
+        return 0;
+    }
+
+    rbf_mutex_lock(s_energy_mutex);
+    for (i = 0; i < RBF_ENERGY_DEVICES && count < max_summaries; i++) {
+        energy_dev_t* dev = &s_devs[i];
+        rbf_energy_summary_t* summary = &summaries[count];
+
+        if (!dev->used) {
+            continue;
+        }
+
+        energy_advance(dev, now);
+        summary->no = dev->no;
+        summary->type = (RBF_dev_type_t)dev->type;
+        summary->power = dev->last_power;
+        summary->hour.time = dev->hour_now * ENERGY_HOUR_S;
+        summary->hour.energy = dev->hour_energy[dev->hour_now % RBF_ENERGY_HOURS];
+        summary->hour.peak = dev->hour_peak[dev->hour_now % RBF_ENERGY_HOURS];
+        summary->day.time = dev->day_now * ENERGY_DAY_S;
+        summary->day.energy = dev->day_energy[dev->day_now % RBF_ENERGY_DAYS];
+        summary->day.peak = dev->day_peak[dev->day_now % RBF_ENERGY_DAYS];
+        summary->total = dev->total;
+        summary->meter = dev->meter;
+        count++;
+    }
+    rbf_mutex_unlock(s_energy_mutex);
+
+    return count;
+}
+
+
+static int energy_buckets_get(uint8_t no, rbf_energy_bucket_t* buckets, bool hours)
+{
+    energy_dev_t* dev;
+    uint32_t size = hours ? RBF_ENERGY_HOURS : RBF_ENERGY_DAYS;
+    uint32_t duration = hours ? ENERGY_HOUR_S : ENERGY_DAY_S;
+    uint32_t current;
+    uint32_t count;
+    uint32_t i;
+
+    if (s_energy_mutex == NULL || buckets == NULL) {
+        return -1;
+    }
+
+    rbf_mutex_lock(s_energy_mutex);
+    dev = energy_find(no, false, 0);
+    if (dev == NULL) {
+        rbf_mutex_unlock(s_energy_mutex);
+        return -1;
+    }
+
+    energy_advance(dev, energy_now());
+    current = hours ? dev->hour_now : dev->day_now;
+    count = current - (hours ? dev->first_hour : dev->first_day) + 1;
+    if (count > size) {
+        count = size;
+    }
+
+    for (i = 0; i < count; i++) {
+        uint32_t index = current - (count - 1) + i;
+
+        buckets[i].time = index * duration;
+        buckets[i].energy = hours ? dev->hour_energy[index % size] : dev->day_energy[index % size];
+        buckets[i].peak = hours ? dev->hour_peak[index % size] : dev->day_peak[index % size];
+    }
+    rbf_mutex_unlock(s_energy_mutex);
+
+    return (int)count;
+}
+
+
+int rbf_energy_hours_get(uint8_t no, rbf_energy_bucket_t* buckets)
+{
+    return energy_buckets_get(no, buckets, true);
+}
+
+
+int rbf_energy_days_get(uint8_t no, rbf_energy_bucket_t* buckets)
+{
+    return energy_buckets_get(no, buckets, false);
+}
+
+
+int rbf_energy_clear(uint8_t no)
+{
+    energy_dev_t* dev;
+
+    if (s_energy_mutex == NULL) {
+        return -1;
+    }
+
+    rbf_mutex_lock(s_energy_mutex);
+    dev = energy_find(no, false, 0);
+    if (dev != NULL) {
+        dev->used = false;
+    }
+    rbf_mutex_unlock(s_energy_mutex);
+
+    return dev != NULL ? 0 : -1;
+}
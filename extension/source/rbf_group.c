@@ -0,0 +1,489 @@
+/**
+ * @file rbf_group.c
+ * @brief Named sub-device groups with precomputed broadcast lists
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+#include <string.h>
+#include <stdbool.h>
+#include "rbf_group.h"
+#include "rbf_observer.h"
+#include "rbf_mutex.h"
+
+#define GROUP_BROADCAST_MAX         (255)   /**< Broadcast APIs take an unsigned char count */
+#define GROUP_BITMAP_WORDS          (RBF_GROUP_MEMBERS_MAX / 32)
+
+typedef enum
+{
+    GROUP_BROADCAST_SOUNDER = 0,
+    GROUP_BROADCAST_INDOOR_SIREN,
+    GROUP_BROADCAST_IO_ALARM,
+}group_broadcast_t;
+
+typedef struct
+{
+    bool used;
+    bool dirty;                                 /**< Changed since it was last saved */
+    RBF_dev_cat_t cat;
+    char name[RBF_GROUP_NAME_LEN];
+    uint32_t bitmap[GROUP_BITMAP_WORDS];
+    uint16_t count;
+    uint8_t no_list[RBF_GROUP_MEMBERS_MAX];     /**< Members in ascending order, rebuilt on change */
+}group_t;
+
+static group_t s_groups[RBF_GROUP_MAX];
+static rbf_mutex_t s_group_mutex;
+static rbf_mutex_t s_store_mutex;               /**< Serializes the saves, held without s_group_mutex */
+static rbf_group_store_t s_store;
+static RBF_evt_callbacks_t s_user_cbs;
+
+
+static bool group_has(const group_t* group, uint8_t no)
+{
+    return (group->bitmap[no / 32] & (1UL << (no % 32))) != 0;
+}
+
+
+static void group_rebuild(group_t* group)
+{
+    uint16_t no;
+
+    group->count = 0;
+    for (no = 0; no < RBF_GROUP_MEMBERS_MAX; no++) {
+        if (group->bitmap[no / 32] == 0) {
+            no += 31;
+            continue;
+        }
+        if (group_has(group, (uint8_t)no)) {
+            group->no_list[group->count++] = (uint8_t)no;
+        }
+    }
+}
+
+
+/**
+ * Save the changed groups. Each group is copied under s_group_mutex and saved after unlocking,
+ * s_store_mutex keeps the saves in the order of the changes.
+ */
+static void group_save(void)
+{
+    rbf_group_record_t record;
+    bool dirty;
+    bool used;
+    uint8_t i;
+
+    if (s_store.save == NULL) {
+        return;
+    }
+
+    rbf_mutex_lock(s_store_mutex);
+    for (i = 0; i < RBF_GROUP_MAX; i++) {
+        group_t* group = &s_groups[i];
+
+        rbf_mutex_lock(s_group_mutex);
+        dirty = group->dirty;
+        used = group->used;
+        group->dirty = false;
+        if (dirty && used) {
+            memcpy(record.name, group->name, sizeof(record.name));
+            record.cat = group->cat;
+            memcpy(record.bitmap, group->bitmap, sizeof(record.bitmap));
+        }
+        rbf_mutex_unlock(s_group_mutex);
+
+        if (dirty) {
+            s_store.save(i, used ? &record : NULL);
+        }
+    }
+    rbf_mutex_unlock(s_store_mutex);
+}
+
+
+static group_t* group_get(int group)
+{
+    if (group < 0 || group >= RBF_GROUP_MAX || !s_groups[group].used) {
+        return NULL;
+    }
+    return &s_groups[group];
+}
+
+
+static void group_forget(RBF_dev_cat_t cat, uint8_t no)
+{
+    uint8_t i;
+
+    rbf_mutex_lock(s_group_mutex);
+    for (i = 0; i < RBF_GROUP_MAX; i++) {
+        group_t* group = &s_groups[i];
+
+        if (group->used && group->cat == cat && group_has(group, no)) {
+            group->bitmap[no / 32] &= ~(1UL << (no % 32));
+            group->dirty = true;
+            group_rebuild(group);
+        }
+    }
+    rbf_mutex_unlock(s_group_mutex);
+
+    group_save();
+}
+
+
+static int group_register_reponse_handle(RBF_register_response_t* reponse)
+{
+    /* The number may have belonged to a deleted device */
+    if (reponse != NULL && reponse->err == 0) {
+        group_forget(reponse->cat, reponse->no);
+    }
+
+    if (s_user_cbs.rbf_dev_register_reponse_handle == NULL) {
+        return 0;
+    }
+    return s_user_cbs.rbf_dev_register_reponse_handle(reponse);
+}
+
+
+static int group_register_info_handle(RBF_dev_id_t* ids, int count)
+{
+    uint32_t registered[GROUP_BITMAP_WORDS];
+    uint8_t i;
+    int j;
+
+    rbf_mutex_lock(s_group_mutex);
+    for (i = 0; i < RBF_GROUP_MAX; i++) {
+        group_t* group = &s_groups[i];
+        bool changed = false;
+        uint8_t w;
+
+        if (!group->used) {
+            continue;
+        }
+
+        memset(registered, 0, sizeof(registered));
+        for (j = 0; j < count; j++) {
+            if (ids[j].cat == group->cat) {
+                registered[ids[j].no / 32] |= 1UL << (ids[j].no % 32);
+            }
+        }
+        for (w = 0; w < GROUP_BITMAP_WORDS; w++) {
+            if (group->bitmap[w] & ~registered[w]) {
+                group->bitmap[w] &= registered[w];
+                changed = true;
+            }
+        }
+        if (changed) {
+            group->dirty = true;
+            group_rebuild(group);
+        }
+    }
+    rbf_mutex_unlock(s_group_mutex);
+
+    group_save();
+
+    if (s_user_cbs.rbf_dev_register_info_handle == NULL) {
+        return 0;
+    }
+    return s_user_cbs.rbf_dev_register_info_handle(ids, count);
+}
+
+
+int rbf_group_wrap(RBF_evt_callbacks_t* cbs)
+{
+    if (cbs == NULL) {
+        return -1;
+    }
+
+    if (s_group_mutex == NULL) {
+        s_group_mutex = rbf_mutex_create();
+        if (s_group_mutex == NULL) {
+            return -1;
+        }
+    }
+    if (s_store_mutex == NULL) {
+        s_store_mutex = rbf_mutex_create();
+        if (s_store_mutex == NULL) {
+            return -1;
+        }
+    }
+
+    s_user_cbs = *cbs;
+    cbs->rbf_dev_register_reponse_handle = group_register_reponse_handle;
+    cbs->rbf_dev_register_info_handle = group_register_info_handle;
+
+    return 0;
+}
+
+
+static bool group_record_valid(const rbf_group_record_t* record)
+{
+    return memchr(record->name, '\0', sizeof(record->name)) != NULL && record->name[0] != '\0'
+           && record->cat < RBF_DEV_UNKNOW;
+}
+
+
+int rbf_group_restore(const rbf_group_store_t* store)
+{
+    rbf_group_record_t record;
+    bool loaded;
+    uint8_t i;
+
+    if (s_group_mutex == NULL || store == NULL || store->load == NULL || store->save == NULL) {
+        return -1;
+    }
+
+    rbf_mutex_lock(s_store_mutex);
+    s_store = *store;
+    for (i = 0; i < RBF_GROUP_MAX; i++) {
+        group_t* group = &s_groups[i];
+
+        loaded = store->load(i, &record) == 0 && group_record_valid(&record);
+
+        rbf_mutex_lock(s_group_mutex);
+        memset(group, 0, sizeof(group_t));
+        if (loaded) {
+            group->used = true;
+            group->cat = record.cat;
+            strcpy(group->name, record.name);
+            memcpy(group->bitmap, record.bitmap, sizeof(group->bitmap));
+            group_rebuild(group);
+        }
+        rbf_mutex_unlock(s_group_mutex);
+    }
+    rbf_mutex_unlock(s_store_mutex);
+
+    return 0;
+}
+
+
+int rbf_group_create(const char* name, RBF_dev_cat_t cat)
+{
+    int group = -1;
+    int i;
+
+    if (s_group_mutex == NULL || name == NULL || strlen(name) >= RBF_GROUP_NAME_LEN || cat >= RBF_DEV_UNKNOW) {
+        return -1;
+    }
+
+    rbf_mutex_lock(s_group_mutex);
+    for (i = 0; i < RBF_GROUP_MAX; i++) {
+        if (s_groups[i].used && strcmp(s_groups[i].name, name) == 0) {
+            rbf_mutex_unlock(s_group_mutex);
+            return -1;
+        }
+        if (!s_groups[i].used && group < 0) {
+            group = i;
+        }
+    }
+
+    if (group >= 0) {
+        memset(&s_groups[group], 0, sizeof(group_t));
+        s_groups[group].used = true;
+        s_groups[group].dirty = true;
+        s_groups[group].cat = cat;
+        strcpy(s_groups[group].name, name);
+    }
+    rbf_mutex_unlock(s_group_mutex);
+
+    group_save();
+    return group;
+}
+
+
+int rbf_group_find(const char* name)
+{
+    int group = -1;
+    int i;
+
+    if (s_group_mutex == NULL || name == NULL) {
+        return -1;
+    }
+
+    rbf_mutex_lock(s_group_mutex);
+    for (i = 0; i < RBF_GROUP_MAX; i++) {
+        if (s_groups[i].used && strcmp(s_groups[i].name, name) == 0) {
+            group = i;
+            break;
+        }
+    }
+    rbf_mutex_unlock(s_group_mutex);
+
+    return group;
+}
+
+
+int rbf_group_destroy(int group)
+{
+    group_t* g;
+
+    if (s_group_mutex == NULL) {
+        return -1;
+    }
+
+    rbf_mutex_lock(s_group_mutex);
+    g = group_get(group);
+    if (g != NULL) {
+        g->used = false;
+        g->dirty = true;
+    }
+    rbf_mutex_unlock(s_group_mutex);
+
+    group_save();
+    return g != NULL ? 0 : -1;
+}
+
+
+static int group_member_set(int group, uint8_t no, bool member)
+{
+    group_t* g;
+
+    if (s_group_mutex == NULL) {
+        return -1;
+    }
+
+    rbf_mutex_lock(s_group_mutex);
+    g = group_get(group);
+    if (g == NULL) {
+        rbf_mutex_unlock(s_group_mutex);
+        return -1;
+    }
+
+    if (group_has(g, no) != member) {
+        g->bitmap[no / 32] ^= 1UL << (no % 32);
+        g->dirty = true;
+        group_rebuild(g);
+    }
+    rbf_mutex_unlock(s_group_mutex);
+
+    group_save();
+    return 0;
+}
+
+
+int rbf_group_add(int group, uint8_t no)
+{
+    return group_member_set(group, no, true);
+}
+
+
+int rbf_group_remove(int group, uint8_t no)
+{
+    return group_member_set(group, no, false);
+}
+
+
+int rbf_group_members_get(int group, uint8_t* no_list, uint16_t max_count)
+{
+    group_t* g;
+    uint16_t count;
+
+    if (s_group_mutex == NULL || no_list == NULL) {
+        return -1;
+    }
+
+    rbf_mutex_lock(s_group_mutex);
+    g = group_get(group);
+    if (g == NULL) {
+        rbf_mutex_unlock(s_group_mutex);
+        return -1;
+    }
+
+    count = g->count < max_count ? g->count : max_count;
+    memcpy(no_list, g->no_list, count);
+    rbf_mutex_unlock(s_group_mutex);
+
+    return count;
+}
+
+
+int rbf_group_forget(const RBF_dev_id_t* id)
+{
+    if (s_group_mutex == NULL || id == NULL) {
+        return -1;
+    }
+
+    group_forget(id->cat, id->no);
+    return 0;
+}
+
+
+/* The member list is copied under the lock, the broadcasts are sent after unlocking */
+static int group_broadcast(int group, RBF_dev_cat_t cat, group_broadcast_t kind, void* param)
+{
+    uint8_t no_list[RBF_GROUP_MEMBERS_MAX];
+    group_t* g;
+    uint16_t count = 0;
+    uint16_t offset;
+    uint16_t size;
+    int ret = 0;
+
+    if (s_group_mutex == NULL) {
+        return -1;
+    }
+
+    rbf_mutex_lock(s_group_mutex);
+    g = group_get(group);
+    if (g != NULL && g->cat == cat) {
+        count = g->count;
+        memcpy(no_list, g->no_list, count);
+    }
+    rbf_mutex_unlock(s_group_mutex);
+
+    if (count == 0) {
+        return -1;
+    }
+
+    for (offset = 0; offset < count && ret == 0; offset += GROUP_BROADCAST_MAX) {
+        uint16_t chunk = count - offset;
+
+        if (chunk > GROUP_BROADCAST_MAX) {
+            chunk = GROUP_BROADCAST_MAX;
+        }
+
+        switch (kind) {
+        case GROUP_BROADCAST_SOUNDER:
+            ret = rbf_sounder_boardcast_control(&no_list[offset], (unsigned char)chunk, param);
+            size = sizeof(RBF_sounder_param_t);
+            break;
+        case GROUP_BROADCAST_INDOOR_SIREN:
+            ret = rbf_indoor_siren_boardcast_control(&no_list[offset], (unsigned char)chunk, param);
+            size = sizeof(RBF_indoor_siren_param_t);
+            break;
+        default:
+            ret = rbf_device_io_alarm_set(&no_list[offset], (unsigned char)chunk, *(RBF_io_alarm_status_t*)param);
+            size = sizeof(RBF_io_alarm_status_t);
+            break;
+        }
+        if (ret == 0) {
+            /* One frame carrying the number list and the parameters */
+            rbf_observer_tx(RBF_OBSERVER_TX_BROADCAST, (uint16_t)(chunk + size));
+        }
+    }
+
+    return ret == 0 ? 0 : -1;
+}
+
+
+int rbf_group_sounder_control(int group, RBF_sounder_param_t* param)
+{
+    if (param == NULL) {
+        return -1;
+    }
+    return group_broadcast(group, RBF_DEV_SOUNDER, GROUP_BROADCAST_SOUNDER, param);
+}
+
+
+int rbf_group_indoor_siren_control(int group, RBF_indoor_siren_param_t* param)
+{
+    if (param == NULL) {
+        return -1;
+    }
+    return group_broadcast(group, RBF_DEV_SOUNDER, GROUP_BROADCAST_INDOOR_SIREN, param);
+}
+
+
+int rbf_group_io_alarm_set(int group, RBF_io_alarm_status_t status)
+{
+    return group_broadcast(group, RBF_DEV_IO, GROUP_BROADCAST_IO_ALARM, &status);
+}
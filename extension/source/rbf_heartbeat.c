@@ -0,0 +1,211 @@
+/**
+ * @file rbf_heartbeat.c
+ * @brief Heartbeat load: measured and planned heartbeat intervals, channel utilization estimate
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+#include <string.h>
+#include "rbf_heartbeat.h"
+#include "rbf_observer.h"
+#include "rbf_mutex.h"
+
+#define HEARTBEAT_NONE          (0xFF)
+#define HEARTBEAT_GAP_MIN_MS    (1000)      /**< Closer heartbeats are retransmissions */
+
+typedef struct
+{
+    RBF_dev_type_t type;
+    rbf_time_t last_ms;
+    uint32_t gap_ms;            /**< Heartbeat gap moving average, weight 1/4 */
+    uint32_t planned_s;         /**< Device plan, 0 for the type plan */
+}heartbeat_dev_t;
+
+static rbf_mutex_t s_heartbeat_mutex;
+static uint8_t s_map[RBF_DEV_UNKNOW - RBF_DEV_IO][256];    /**< (cat, no) to device */
+static heartbeat_dev_t s_devs[RBF_HEARTBEAT_MAX];
+static uint8_t s_dev_count;
+static uint32_t s_planned_s[RBF_DEV_TYPE_UNKNOW];
+
+
+static uint8_t* heartbeat_map(const RBF_dev_id_t* id)
+{
+    if (id->cat < RBF_DEV_IO || id->cat >= RBF_DEV_UNKNOW) {
+        return NULL;
+    }
+    return &s_map[id->cat - RBF_DEV_IO][id->no];
+}
+
+
+static int heartbeat_observer(const rbf_observer_msg_t* msg, void* arg)
+{
+    uint8_t* map = heartbeat_map(&msg->id);
+    heartbeat_dev_t* dev;
+
+    (void)arg;
+    if (msg->msg != RBF_OBSERVER_MSG_HEARTBEAT || map == NULL || msg->type >= RBF_DEV_TYPE_UNKNOW) {
+        return RBF_OBSERVER_PASS;
+    }
+
+    rbf_mutex_lock(s_heartbeat_mutex);
+    if (*map == HEARTBEAT_NONE) {
+        if (s_dev_count == RBF_HEARTBEAT_MAX) {
+            rbf_mutex_unlock(s_heartbeat_mutex);
+            return RBF_OBSERVER_PASS;
+        }
+        *map = s_dev_count++;
+        memset(&s_devs[*map], 0, sizeof(heartbeat_dev_t));
+    } else {
+        uint32_t gap = (uint32_t)(msg->time - s_devs[*map].last_ms);
+
+        dev = &s_devs[*map];
+        if (gap >= HEARTBEAT_GAP_MIN_MS) {
+            dev->gap_ms = dev->gap_ms ? dev->gap_ms - dev->gap_ms / 4 + gap / 4 : gap;
+        }
+    }
+    dev = &s_devs[*map];
+    dev->type = msg->type;
+    dev->last_ms = msg->time;
+    rbf_mutex_unlock(s_heartbeat_mutex);
+
+    return RBF_OBSERVER_PASS;
+}
+
+
+int rbf_heartbeat_init(void)
+{
+    if (s_heartbeat_mutex != NULL) {
+        return 0;
+    }
+
+    s_heartbeat_mutex = rbf_mutex_create();
+    if (s_heartbeat_mutex == NULL) {
+        return -1;
+    }
+    memset(s_map, HEARTBEAT_NONE, sizeof(s_map));
+    return rbf_observer_add(heartbeat_observer, NULL);
+}
+
+
+int rbf_heartbeat_plan_set(RBF_dev_type_t type, uint32_t seconds)
+{
+    if (s_heartbeat_mutex == NULL || type >= RBF_DEV_TYPE_UNKNOW) {
+        return -1;
+    }
+
+    rbf_mutex_lock(s_heartbeat_mutex);
+    s_planned_s[type] = seconds;
+    rbf_mutex_unlock(s_heartbeat_mutex);
+
+    return 0;
+}
+
+
+int rbf_heartbeat_device_plan_set(const RBF_dev_id_t* id, uint32_t seconds)
+{
+    uint8_t* map;
+    int ret = -1;
+
+    if (s_heartbeat_mutex == NULL || id == NULL) {
+        return -1;
+    }
+
+    rbf_mutex_lock(s_heartbeat_mutex);
+    map = heartbeat_map(id);
+    if (map != NULL && *map != HEARTBEAT_NONE) {
+        s_devs[*map].planned_s = seconds;
+        ret = 0;
+    }
+    rbf_mutex_unlock(s_heartbeat_mutex);
+
+    return ret;
+}
+
+
+int rbf_heartbeat_load_get(rbf_heartbeat_load_t* load)
+{
+    uint64_t measured_load[RBF_DEV_TYPE_UNKNOW];
+    uint64_t planned_load[RBF_DEV_TYPE_UNKNOW];
+    uint64_t gap_total[RBF_DEV_TYPE_UNKNOW];
+    uint16_t gap_count[RBF_DEV_TYPE_UNKNOW];
+    uint64_t measured_all = 0;
+    uint64_t planned_all = 0;
+    uint32_t airtime_us = rbf_observer_airtime_us(RBF_OBSERVER_HEARTBEAT_LEN);
+    uint8_t i;
+
+    if (s_heartbeat_mutex == NULL || load == NULL) {
+        return -1;
+    }
+
+    memset(load, 0, sizeof(rbf_heartbeat_load_t));
+    memset(measured_load, 0, sizeof(measured_load));
+    memset(planned_load, 0, sizeof(planned_load));
+    memset(gap_total, 0, sizeof(gap_total));
+    memset(gap_count, 0, sizeof(gap_count));
+    if (airtime_us == 0) {
+        airtime_us = RBF_HEARTBEAT_AIRTIME_US;
+    }
+
+    /* Utilization in 0.1 % scaled by 1000000: airtime per heartbeat over its interval, summed over the devices */
+    rbf_mutex_lock(s_heartbeat_mutex);
+    for (i = 0; i < s_dev_count; i++) {
+        const heartbeat_dev_t* dev = &s_devs[i];
+        uint32_t planned_s = dev->planned_s ? dev->planned_s : s_planned_s[dev->type];
+        uint64_t measured = dev->gap_ms ? (uint64_t)airtime_us * 1000000 / dev->gap_ms : 0;
+
+        load->types[dev->type].devices++;
+        load->frames_per_hour += dev->gap_ms ? 3600000 / dev->gap_ms : 0;
+        if (dev->gap_ms) {
+            gap_total[dev->type] += dev->gap_ms;
+            gap_count[dev->type]++;
+        }
+        measured_load[dev->type] += measured;
+        planned_load[dev->type] += planned_s ? (uint64_t)airtime_us * 1000 / planned_s : measured;
+    }
+    load->devices = s_dev_count;
+    for (i = 0; i < RBF_DEV_TYPE_UNKNOW; i++) {
+        load->types[i].planned_s = s_planned_s[i];
+    }
+    rbf_mutex_unlock(s_heartbeat_mutex);
+
+    for (i = 0; i < RBF_DEV_TYPE_UNKNOW; i++) {
+        rbf_heartbeat_type_load_t* type = &load->types[i];
+
+        type->measured_ms = gap_count[i] ? (uint32_t)(gap_total[i] / gap_count[i]) : 0;
+        type->measured_permille = (uint16_t)(measured_load[i] / 1000000);
+        type->planned_permille = (uint16_t)(planned_load[i] / 1000000);
+        measured_all += measured_load[i];
+        planned_all += planned_load[i];
+    }
+    load->measured_permille = (uint16_t)(measured_all / 1000000);
+    load->planned_permille = (uint16_t)(planned_all / 1000000);
+
+    return 0;
+}
+
+
+int rbf_heartbeat_supervision_get(uint8_t misses, uint32_t seconds[RBF_DEV_TYPE_UNKNOW])
+{
+    uint32_t planned_s[RBF_DEV_TYPE_UNKNOW];
+    uint8_t i;
+
+    if (s_heartbeat_mutex == NULL || misses == 0 || seconds == NULL) {
+        return -1;
+    }
+
+    rbf_mutex_lock(s_heartbeat_mutex);
+    memcpy(planned_s, s_planned_s, sizeof(planned_s));
+    rbf_mutex_unlock(s_heartbeat_mutex);
+
+    for (i = 0; i < RBF_DEV_TYPE_UNKNOW; i++) {
+        if (planned_s[i] > UINT32_MAX / misses) {
+            return -1;
+        }
+    }
+    for (i = 0; i < RBF_DEV_TYPE_UNKNOW; i++) {
+        seconds[i] = planned_s[i] * misses;
+    }
+    return 0;
+}
@@ -0,0 +1,369 @@
+/**
+ * @file rbf_link.c
+ * @brief Per-device link quality: RSSI statistics and heartbeat loss estimate
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+#include <string.h>
+#include <stdbool.h>
+#include "rbf_link.h"
+#include "rbf_observer.h"
+#include "rbf_mutex.h"
+
+#define LINK_WINDOW             (16)        /**< Heartbeat gaps per period learning window */
+#define LINK_EWMA_WEIGHT        (8)         /**< EWMA weight 1/8 */
+#define LINK_EWMA_SCALE         (16)        /**< EWMA fixed point scale */
+#define LINK_RETRANSMIT_MS      (1000)      /**< Heartbeats closer than this are retransmissions */
+#define LINK_NO_WORDS           (256 / 32)
+
+typedef struct
+{
+    bool used;
+    RBF_dev_id_t id;
+    RBF_dev_type_t type;
+    int32_t last;
+    int32_t ewma;               /**< Scaled by LINK_EWMA_SCALE */
+    int32_t min;
+    int32_t max;
+    uint16_t hist[RBF_LINK_BUCKETS];
+    uint32_t received;
+    uint32_t missed;
+    uint32_t period_ms;         /**< Learned period */
+    uint32_t window_min_ms;     /**< Shortest gap of the current learning window */
+    uint8_t window_count;
+    rbf_time_t last_ms;
+}link_entry_t;
+
+static rbf_mutex_t s_link_mutex;
+static link_entry_t s_links[RBF_LINK_MAX];
+static uint32_t s_period_ms[RBF_DEV_TYPE_UNKNOW];
+static uint32_t s_untracked[RBF_DEV_UNKNOW][LINK_NO_WORDS];    /**< Devices heard while the table was full */
+static uint16_t s_untracked_count;
+
+
+static link_entry_t* link_find(const RBF_dev_id_t* id)
+{
+    uint8_t i;
+
+    for (i = 0; i < RBF_LINK_MAX; i++) {
+        if (s_links[i].used && s_links[i].id.cat == id->cat && s_links[i].id.no == id->no) {
+            return &s_links[i];
+        }
+    }
+    return NULL;
+}
+
+
+/* Set or clear the untracked bit of a device */
+static void link_untracked_set(const RBF_dev_id_t* id, bool untracked)
+{
+    uint32_t mask = 1UL << (id->no % 32);
+    uint32_t* word;
+
+    if (id->cat >= RBF_DEV_UNKNOW) {
+        return;
+    }
+    word = &s_untracked[id->cat][id->no / 32];
+    if (((*word & mask) != 0) == untracked) {
+        return;
+    }
+    *word ^= mask;
+    if (untracked) {
+        s_untracked_count++;
+    } else {
+        s_untracked_count--;
+    }
+}
+
+
+static uint32_t link_period(const link_entry_t* link)
+{
+    return s_period_ms[link->type] ? s_period_ms[link->type] : link->period_ms;
+}
+
+
+static void link_hist_add(link_entry_t* link, int32_t rssi)
+{
+    int32_t b = (rssi - RBF_LINK_BUCKET_MIN) / RBF_LINK_BUCKET_DBM;
+    uint8_t i;
+
+    if (b < 0) {
+        b = 0;
+    } else if (b >= RBF_LINK_BUCKETS) {
+        b = RBF_LINK_BUCKETS - 1;
+    }
+
+    /* Halve the counts on overflow, older samples weigh less */
+    if (link->hist[b] == 0xFFFF) {
+        for (i = 0; i < RBF_LINK_BUCKETS; i++) {
+            link->hist[i] >>= 1;
+        }
+    }
+    link->hist[b]++;
+}
+
+
+static int32_t link_percentile(const link_entry_t* link, uint8_t percent)
+{
+    uint32_t total = 0;
+    uint32_t target;
+    uint32_t sum = 0;
+    int32_t value;
+    uint8_t i;
+
+    for (i = 0; i < RBF_LINK_BUCKETS; i++) {
+        total += link->hist[i];
+    }
+    target = (total * percent + 99) / 100;
+
+    for (i = 0; i < RBF_LINK_BUCKETS; i++) {
+        sum += link->hist[i];
+        if (sum >= target && sum) {
+            break;
+        }
+    }
+    if (i == RBF_LINK_BUCKETS) {
+        i--;
+    }
+
+    /* Bucket center, clamped to the values actually seen */
+    value = RBF_LINK_BUCKET_MIN + i * RBF_LINK_BUCKET_DBM + RBF_LINK_BUCKET_DBM / 2;
+    if (value < link->min) {
+        value = link->min;
+    } else if (value > link->max) {
+        value = link->max;
+    }
+    return value;
+}
+
+
+static void link_gap(link_entry_t* link, uint32_t gap)
+{
+    uint32_t period;
+
+    if (link->window_count == 0 || gap < link->window_min_ms) {
+        link->window_min_ms = gap;
+    }
+    if (++link->window_count == LINK_WINDOW) {
+        link->period_ms = link->window_min_ms;
+        link->window_count = 0;
+    }
+
+    period = link_period(link);
+    if (period) {
+        uint32_t periods = (gap + period / 2) / period;
+
+        if (periods > 1 && periods <= RBF_LINK_GAP_MAX) {
+            link->missed += periods - 1;
+        }
+    }
+}
+
+
+static int link_observer(const rbf_observer_msg_t* msg, void* arg)
+{
+    link_entry_t* link;
+    uint8_t i;
+
+    (void)arg;
+    if (msg->msg != RBF_OBSERVER_MSG_HEARTBEAT || msg->type >= RBF_DEV_TYPE_UNKNOW) {
+        return RBF_OBSERVER_PASS;
+    }
+
+    rbf_mutex_lock(s_link_mutex);
+    link = link_find(&msg->id);
+    if (link == NULL) {
+        i = 0;
+        while (i < RBF_LINK_MAX && s_links[i].used) {
+            i++;
+        }
+        if (i == RBF_LINK_MAX) {
+            link_untracked_set(&msg->id, true);
+            rbf_mutex_unlock(s_link_mutex);
+            return RBF_OBSERVER_PASS;
+        }
+        link_untracked_set(&msg->id, false);
+        link = &s_links[i];
+        memset(link, 0, sizeof(link_entry_t));
+        link->used = true;
+        link->id = msg->id;
+        link->min = msg->rssi;
+        link->max = msg->rssi;
+        link->ewma = msg->rssi * LINK_EWMA_SCALE;
+    } else if ((uint32_t)(msg->time - link->last_ms) < LINK_RETRANSMIT_MS) {
+        /* A retransmission of the heartbeat already counted */
+        rbf_mutex_unlock(s_link_mutex);
+        return RBF_OBSERVER_PASS;
+    } else {
+        link_gap(link, (uint32_t)(msg->time - link->last_ms));
+    }
+
+    link->type = msg->type;
+    link->last = msg->rssi;
+    link->last_ms = msg->time;
+    link->received++;
+    link->ewma += (msg->rssi * LINK_EWMA_SCALE - link->ewma) / LINK_EWMA_WEIGHT;
+    if (msg->rssi < link->min) {
+        link->min = msg->rssi;
+    }
+    if (msg->rssi > link->max) {
+        link->max = msg->rssi;
+    }
+    link_hist_add(link, msg->rssi);
+    rbf_mutex_unlock(s_link_mutex);
+
+    return RBF_OBSERVER_PASS;
+}
+
+
+static void link_stats(const link_entry_t* link, rbf_link_stats_t* stats)
+{
+    uint32_t total = link->received + link->missed;
+
+    stats->id = link->id;
+    stats->type = link->type;
+    stats->last = link->last;
+    stats->ewma = link->ewma / LINK_EWMA_SCALE;
+    stats->min = link->min;
+    stats->max = link->max;
+    stats->p10 = link_percentile(link, 10);
+    stats->p50 = link_percentile(link, 50);
+    stats->p90 = link_percentile(link, 90);
+    stats->received = link->received;
+    stats->missed = link->missed;
+    stats->loss_percent = total ? (uint8_t)((uint64_t)link->missed * 100 / total) : 0;
+    stats->period_ms = link_period(link);
+    stats->last_ms = link->last_ms;
+}
+
+
+int rbf_link_init(void)
+{
+    if (s_link_mutex != NULL) {
+        return 0;
+    }
+
+    s_link_mutex = rbf_mutex_create();
+    if (s_link_mutex == NULL) {
+        return -1;
+    }
+    return rbf_observer_add(link_observer, NULL);
+}
+
+
+int rbf_link_period_set(RBF_dev_type_t type, uint32_t seconds)
+{
+    if (s_link_mutex == NULL || type >= RBF_DEV_TYPE_UNKNOW) {
+        return -1;
+    }
+
+    rbf_mutex_lock(s_link_mutex);
+    s_period_ms[type] = seconds * 1000;
+    rbf_mutex_unlock(s_link_mutex);
+
+    return 0;
+}
+
+
+int rbf_link_get(const RBF_dev_id_t* id, rbf_link_stats_t* stats)
+{
+    link_entry_t* link;
+
+    if (s_link_mutex == NULL || id == NULL || stats == NULL) {
+        return -1;
+    }
+
+    rbf_mutex_lock(s_link_mutex);
+    link = link_find(id);
+    if (link != NULL) {
+        link_stats(link, stats);
+    }
+    rbf_mutex_unlock(s_link_mutex);
+
+    return link != NULL ? 0 : -1;
+}
+
+
+int rbf_link_weak_get(int32_t rssi_threshold, uint8_t loss_threshold, rbf_link_stats_t* stats, uint8_t max_count)
+{
+    uint8_t count = 0;
+    uint8_t i;
+
+    if (s_link_mutex == NULL || stats == NULL || max_count == 0) {
+        return 0;
+    }
+
+    rbf_mutex_lock(s_link_mutex);
+    for (i = 0; i < RBF_LINK_MAX; i++) {
+        rbf_link_stats_t s;
+        uint8_t j;
+
+        if (!s_links[i].used) {
+            continue;
+        }
+        link_stats(&s_links[i], &s);
+        if (s.ewma >= rssi_threshold && (loss_threshold == 0 || s.loss_percent < loss_threshold)) {
+            continue;
+        }
+
+        /* Insertion by average RSSI, the strongest falls off when full */
+        j = count < max_count ? count++ : max_count;
+        while (j > 0 && stats[j - 1].ewma > s.ewma) {
+            if (j < max_count) {
+                stats[j] = stats[j - 1];
+            }
+            j--;
+        }
+        if (j < max_count) {
+            stats[j] = s;
+        }
+    }
+    rbf_mutex_unlock(s_link_mutex);
+
+    return count;
+}
+
+
+int rbf_link_clear(const RBF_dev_id_t* id)
+{
+    link_entry_t* link = NULL;
+
+    if (s_link_mutex == NULL) {
+        return -1;
+    }
+
+    rbf_mutex_lock(s_link_mutex);
+    if (id == NULL) {
+        memset(s_links, 0, sizeof(s_links));
+        memset(s_untracked, 0, sizeof(s_untracked));
+        s_untracked_count = 0;
+    } else {
+        link = link_find(id);
+        if (link != NULL) {
+            link->used = false;
+        }
+        link_untracked_set(id, false);
+    }
+    rbf_mutex_unlock(s_link_mutex);
+
+    return (id == NULL || link != NULL) ? 0 : -1;
+}
+
+
+int rbf_link_untracked_get(void)
+{
+    int count;
+
+    if (s_link_mutex == NULL) {
+        return 0;
+    }
+
+    rbf_mutex_lock(s_link_mutex);
+    count = s_untracked_count;
+    rbf_mutex_unlock(s_link_mutex);
+
+    return count;
+}
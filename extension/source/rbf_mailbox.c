@@ -0,0 +1,225 @@
+/**
+ * @file rbf_mailbox.c
+ * @brief Sleepy device mailbox: downlinks are sent when the device reports
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+#include <string.h>
+#include <stdbool.h>
+#include "rbf_mailbox.h"
+#include "rbf_observer.h"
+#include "rbf_mutex.h"
+#include "rbf_time.h"
+
+typedef struct
+{
+    bool used;
+    uint8_t gen;                /**< Changed on every staging, detects a replacement during the send */
+    RBF_dev_cat_t cat;
+    rbf_time_t staged_ms;
+    rbf_cmd_t cmd;
+}mailbox_entry_t;
+
+static rbf_mutex_t s_mailbox_mutex;
+static mailbox_entry_t s_entries[RBF_MAILBOX_MAX];
+static rbf_mailbox_stats_t s_stats;
+static uint64_t s_delay_total_ms;
+
+
+static RBF_dev_cat_t mailbox_cat(const rbf_cmd_t* cmd)
+{
+    switch (cmd->kind) {
+    case RBF_CMD_KEYPAD_SET:
+        return RBF_DEV_KEYPAD;
+    case RBF_CMD_SOUNDER_VOLUME:
+    case RBF_CMD_INDOOR_SIREN_VOLUME:
+        return RBF_DEV_SOUNDER;
+    case RBF_CMD_LED_INDICATE:
+        return cmd->id.cat;
+    default:
+        return RBF_DEV_IO;
+    }
+}
+
+
+static mailbox_entry_t* mailbox_find(const rbf_cmd_t* cmd)
+{
+    RBF_dev_cat_t cat = mailbox_cat(cmd);
+    uint8_t i;
+
+    for (i = 0; i < RBF_MAILBOX_MAX; i++) {
+        mailbox_entry_t* entry = &s_entries[i];
+
+        if (entry->used && entry->cmd.kind == cmd->kind && entry->cat == cat && entry->cmd.id.no == cmd->id.no) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+
+static void mailbox_expire(rbf_time_t now)
+{
+    uint8_t i;
+
+    for (i = 0; i < RBF_MAILBOX_MAX; i++) {
+        if (s_entries[i].used && now - s_entries[i].staged_ms >= RBF_MAILBOX_TTL_MS) {
+            s_entries[i].used = false;
+            s_stats.expired++;
+            s_stats.pending--;
+        }
+    }
+}
+
+
+static int mailbox_observer(const rbf_observer_msg_t* msg, void* arg)
+{
+    uint8_t index[RBF_MAILBOX_MAX];
+    uint8_t gen[RBF_MAILBOX_MAX];
+    rbf_cmd_t cmds[RBF_MAILBOX_MAX];
+    uint8_t count = 0;
+    uint8_t i;
+
+    (void)arg;
+    if (s_stats.pending == 0 || msg->msg == RBF_OBSERVER_MSG_OUTPUT_STATUS) {
+        return RBF_OBSERVER_PASS;
+    }
+
+    rbf_mutex_lock(s_mailbox_mutex);
+    mailbox_expire(msg->time);
+    for (i = 0; i < RBF_MAILBOX_MAX; i++) {
+        mailbox_entry_t* entry = &s_entries[i];
+
+        if (entry->used && entry->cat == msg->id.cat && entry->cmd.id.no == msg->id.no) {
+            index[count] = i;
+            gen[count] = entry->gen;
+            cmds[count] = entry->cmd;
+            count++;
+        }
+    }
+    if (count) {
+        s_stats.windows++;
+    }
+    rbf_mutex_unlock(s_mailbox_mutex);
+
+    /* The device listens right after its report: send now, from the rbfsdk thread */
+    for (i = 0; i < count; i++) {
+        int ret = rbf_cmd_send(&cmds[i]);
+        mailbox_entry_t* entry = &s_entries[index[i]];
+
+        rbf_mutex_lock(s_mailbox_mutex);
+        if (ret != 0) {
+            s_stats.failed++;
+        } else if (entry->used && entry->gen == gen[i]) {
+            uint32_t delay = (uint32_t)(msg->time - entry->staged_ms);
+
+            entry->used = false;
+            s_stats.pending--;
+            s_stats.delivered++;
+            s_delay_total_ms += delay;
+            s_stats.delay_avg_ms = (uint32_t)(s_delay_total_ms / s_stats.delivered);
+            if (delay > s_stats.delay_max_ms) {
+                s_stats.delay_max_ms = delay;
+            }
+        }
+        rbf_mutex_unlock(s_mailbox_mutex);
+    }
+
+    return RBF_OBSERVER_PASS;
+}
+
+
+int rbf_mailbox_init(void)
+{
+    if (s_mailbox_mutex != NULL) {
+        return 0;
+    }
+
+    s_mailbox_mutex = rbf_mutex_create();
+    if (s_mailbox_mutex == NULL) {
+        return -1;
+    }
+    return rbf_observer_add(mailbox_observer, NULL);
+}
+
+
+int rbf_mailbox_stage(const rbf_cmd_t* cmd)
+{
+    mailbox_entry_t* entry;
+    uint8_t i;
+
+    if (s_mailbox_mutex == NULL || cmd == NULL || cmd->kind >= RBF_CMD_KIND_MAX) {
+        return -1;
+    }
+
+    rbf_mutex_lock(s_mailbox_mutex);
+    entry = mailbox_find(cmd);
+    if (entry != NULL) {
+        s_stats.superseded++;
+    } else {
+        i = 0;
+        while (i < RBF_MAILBOX_MAX && s_entries[i].used) {
+            i++;
+        }
+        if (i == RBF_MAILBOX_MAX) {
+            rbf_mutex_unlock(s_mailbox_mutex);
+            return -1;
+        }
+        entry = &s_entries[i];
+        entry->used = true;
+        entry->cat = mailbox_cat(cmd);
+        s_stats.pending++;
+    }
+
+    entry->gen++;
+    entry->cmd = *cmd;
+    rbf_time_get_ms(&entry->staged_ms);
+    s_stats.staged++;
+    rbf_mutex_unlock(s_mailbox_mutex);
+
+    return 0;
+}
+
+
+int rbf_mailbox_cancel(const rbf_cmd_t* cmd)
+{
+    mailbox_entry_t* entry;
+
+    if (s_mailbox_mutex == NULL || cmd == NULL) {
+        return -1;
+    }
+
+    rbf_mutex_lock(s_mailbox_mutex);
+    entry = mailbox_find(cmd);
+    if (entry != NULL) {
+        entry->used = false;
+        s_stats.pending--;
+    }
+    rbf_mutex_unlock(s_mailbox_mutex);
+
+    return entry != NULL ? 0 : -1;
+}
+
+
+int rbf_mailbox_stats_get(rbf_mailbox_stats_t* stats)
+{
+    rbf_time_t now;
+    uint32_t done;
+
+    if (stats == NULL || s_mailbox_mutex == NULL) {
+        return -1;
+    }
+
+    rbf_time_get_ms(&now);
+    rbf_mutex_lock(s_mailbox_mutex);
+    mailbox_expire(now);
+    done = s_stats.delivered + s_stats.expired;
+    s_stats.hit_percent = done ? (uint8_t)((uint64_t)s_stats.delivered * 100 / done) : 0;
+    *stats = s_stats;
+    rbf_mutex_unlock(s_mailbox_mutex);
+
+    return 0;
+}
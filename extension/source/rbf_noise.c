@@ -0,0 +1,271 @@
+/**
+ * @file rbf_noise.c
+ * @brief Background noise sampling, noise history and jamming confidence
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+#include <string.h>
+#include "rbf_noise.h"
+#include "rbf_mutex.h"
+
+#define NOISE_TIMEOUT_MS        (2000)      /**< A request without response after this is lost */
+
+static rbf_mutex_t s_noise_mutex;
+static RBF_evt_callbacks_t s_user_cbs;
+static uint32_t s_period_ms = RBF_NOISE_PERIOD_DEFAULT;
+static int32_t s_jamming_rssi = RBF_NOISE_JAMMING_DEFAULT;
+static bool s_requested;
+static bool s_pending;
+static rbf_time_t s_req_ms;
+static rbf_noise_bucket_t s_buckets[RBF_NOISE_BUCKETS];
+static int32_t s_sums[RBF_NOISE_BUCKETS];
+static uint8_t s_cur;
+static uint8_t s_bucket_count;
+static uint32_t s_window;               /**< One bit per sample, set when jammed, newest in bit 0 */
+static uint8_t s_window_count;
+static rbf_noise_summary_t s_summary;
+
+
+static uint8_t noise_popcount(uint32_t bits)
+{
+    uint8_t count = 0;
+
+    while (bits) {
+        bits &= bits - 1;
+        count++;
+    }
+    return count;
+}
+
+
+static void noise_bucket_open(uint8_t i, rbf_time_t time)
+{
+    memset(&s_buckets[i], 0, sizeof(rbf_noise_bucket_t));
+    s_buckets[i].time = time;
+    s_sums[i] = 0;
+}
+
+
+static void noise_sample_add(int32_t realtime, int32_t avg, rbf_time_t now)
+{
+    rbf_noise_bucket_t* bucket;
+    bool jammed = realtime >= s_jamming_rssi;
+
+    if (s_bucket_count == 0 || now - s_buckets[s_cur].time >= (rbf_time_t)RBF_NOISE_BUCKET_MS * RBF_NOISE_BUCKETS) {
+        /* First sample or the whole history is stale */
+        s_cur = 0;
+        s_bucket_count = 1;
+        noise_bucket_open(0, now - now % RBF_NOISE_BUCKET_MS);
+    }
+    while (now - s_buckets[s_cur].time >= RBF_NOISE_BUCKET_MS) {
+        rbf_time_t time = s_buckets[s_cur].time + RBF_NOISE_BUCKET_MS;
+
+        s_cur = (s_cur + 1) % RBF_NOISE_BUCKETS;
+        noise_bucket_open(s_cur, time);
+        if (s_bucket_count < RBF_NOISE_BUCKETS) {
+            s_bucket_count++;
+        }
+    }
+
+    bucket = &s_buckets[s_cur];
+    if (bucket->count == 0 || realtime < bucket->min) {
+        bucket->min = (int16_t)realtime;
+    }
+    if (bucket->count == 0 || realtime > bucket->max) {
+        bucket->max = (int16_t)realtime;
+    }
+    bucket->count++;
+    s_sums[s_cur] += realtime;
+    bucket->avg = (int16_t)(s_sums[s_cur] / bucket->count);
+    if (jammed) {
+        bucket->jammed++;
+    }
+
+    s_window = (s_window << 1) | (jammed ? 1 : 0);
+    if (s_window_count < RBF_NOISE_WINDOW) {
+        s_window_count++;
+    }
+
+    s_summary.samples++;
+    s_summary.realtime = realtime;
+    s_summary.avg = avg;
+    s_summary.last_ms = now;
+}
+
+
+static int noise_hub_noise_handle(RBF_hub_noise_t* noise)
+{
+    rbf_time_t now;
+
+    if (noise != NULL) {
+        rbf_time_get_ms(&now);
+        rbf_mutex_lock(s_noise_mutex);
+        s_pending = false;
+        noise_sample_add(noise->realtime_rssi, noise->avg_rssi, now);
+        rbf_mutex_unlock(s_noise_mutex);
+    }
+
+    if (s_user_cbs.rbf_get_hub_noise == NULL) {
+        return 0;
+    }
+    return s_user_cbs.rbf_get_hub_noise(noise);
+}
+
+
+static int noise_jamming_handle(bool jamming)
+{
+    rbf_mutex_lock(s_noise_mutex);
+    if (jamming && !s_summary.hub_jamming) {
+        s_summary.hub_jamming_count++;
+    }
+    s_summary.hub_jamming = jamming;
+    rbf_mutex_unlock(s_noise_mutex);
+
+    if (s_user_cbs.rbf_jamming_handle == NULL) {
+        return 0;
+    }
+    return s_user_cbs.rbf_jamming_handle(jamming);
+}
+
+
+int rbf_noise_wrap(RBF_evt_callbacks_t* cbs)
+{
+    if (cbs == NULL) {
+        return -1;
+    }
+
+    if (s_noise_mutex == NULL) {
+        s_noise_mutex = rbf_mutex_create();
+        if (s_noise_mutex == NULL) {
+            return -1;
+        }
+    }
+
+    s_user_cbs = *cbs;
+    cbs->rbf_get_hub_noise = noise_hub_noise_handle;
+    cbs->rbf_jamming_handle = noise_jamming_handle;
+
+    return 0;
+}
+
+
+int rbf_noise_config_set(uint32_t period_ms, int32_t jamming_rssi)
+{
+    if (s_noise_mutex == NULL) {
+        return -1;
+    }
+
+    rbf_mutex_lock(s_noise_mutex);
+    s_period_ms = period_ms;
+    s_jamming_rssi = jamming_rssi;
+    rbf_mutex_unlock(s_noise_mutex);
+
+    return 0;
+}
+
+
+int rbf_noise_poll(void)
+{
+    rbf_time_t now;
+
+    if (s_noise_mutex == NULL) {
+        return 0;
+    }
+
+    rbf_time_get_ms(&now);
+    rbf_mutex_lock(s_noise_mutex);
+    if (s_pending && now - s_req_ms >= NOISE_TIMEOUT_MS) {
+        s_pending = false;
+        s_summary.lost++;
+    }
+    if (s_period_ms == 0 || s_pending || (s_requested && now - s_req_ms < s_period_ms)) {
+        rbf_mutex_unlock(s_noise_mutex);
+        return 0;
+    }
+    s_requested = true;
+    s_pending = true;
+    s_req_ms = now;
+    rbf_mutex_unlock(s_noise_mutex);
+
+    if (0 != rbf_get_hub_noise()) {
+        rbf_mutex_lock(s_noise_mutex);
+        s_pending = false;
+        s_summary.lost++;
+        rbf_mutex_unlock(s_noise_mutex);
+        return 0;
+    }
+    return 1;
+}
+
+
+int rbf_noise_summary_get(rbf_noise_summary_t* summary)
+{
+    int64_t n = 0, sx = 0, sy = 0, sxy = 0, sxx = 0;
+    int64_t sum = 0;
+    uint32_t count = 0;
+    uint8_t i;
+
+    if (s_noise_mutex == NULL || summary == NULL) {
+        return -1;
+    }
+
+    rbf_mutex_lock(s_noise_mutex);
+    *summary = s_summary;
+    summary->confidence = s_window_count ? (uint8_t)(noise_popcount(s_window) * 100 / s_window_count) : 0;
+
+    /* Least squares slope of the bucket averages, x in buckets from the oldest */
+    for (i = 0; i < s_bucket_count; i++) {
+        uint8_t index = (s_cur + RBF_NOISE_BUCKETS - s_bucket_count + 1 + i) % RBF_NOISE_BUCKETS;
+        const rbf_noise_bucket_t* bucket = &s_buckets[index];
+        int64_t y = bucket->avg * 10;
+
+        if (bucket->count == 0) {
+            continue;
+        }
+        if (count == 0 || bucket->min < summary->min) {
+            summary->min = bucket->min;
+        }
+        if (count == 0 || bucket->max > summary->max) {
+            summary->max = bucket->max;
+        }
+        count += bucket->count;
+        sum += s_sums[index];
+        n++;
+        sx += i;
+        sy += y;
+        sxy += i * y;
+        sxx += i * i;
+    }
+    rbf_mutex_unlock(s_noise_mutex);
+
+    summary->history_avg = count ? (int32_t)(sum / count) : 0;
+    summary->trend = 0;
+    if (n >= 2 && n * sxx != sx * sx) {
+        summary->trend = (int32_t)((n * sxy - sx * sy) * 3600000 / ((n * sxx - sx * sx) * RBF_NOISE_BUCKET_MS));
+    }
+
+    return 0;
+}
+
+
+int rbf_noise_buckets_get(rbf_noise_bucket_t* buckets, uint8_t max_count)
+{
+    uint8_t count;
+    uint8_t i;
+
+    if (s_noise_mutex == NULL || buckets == NULL) {
+        return 0;
+    }
+
+    rbf_mutex_lock(s_noise_mutex);
+    count = s_bucket_count < max_count ? s_bucket_count : max_count;
+    for (i = 0; i < count; i++) {
+        buckets[i] = s_buckets[(s_cur + RBF_NOISE_BUCKETS - count + 1 + i) % RBF_NOISE_BUCKETS];
+    }
+    rbf_mutex_unlock(s_noise_mutex);
+
+    return count;
+}
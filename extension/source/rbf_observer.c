@@ -0,0 +1,751 @@
+/**
+ * @file rbf_observer.c
+ * @brief Sub-device message observer: lets extension modules see every device callback
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+#include <string.h>
+#include <stdbool.h>
+#include "rbf_observer.h"
+
+typedef struct 
+{
+    rbf_observer_handle_t handle;
+    void* arg;
+}observer_t;
+
+static observer_t s_observers[RBF_OBSERVER_MAX];
+static uint8_t s_observer_count;
+
+static rbf_magnetic_callbacks_t s_magnetic_cbs;
+static rbf_pir_callbacks_t s_pir_cbs;
+static rbf_water_leak_callbacks_t s_water_leak_cbs;
+static rbf_emergency_button_callbacks_t s_emergency_button_cbs;
+static rbf_smoke_callbacks_t s_smoke_cbs;
+static rbf_temp_humi_callbacks_t s_temp_humi_cbs;
+static rbf_smartplug_callbacks_t s_smartplug_cbs;
+static rbf_relay_callbacks_t s_relay_cbs;
+static rbf_wall_switch_callbacks_t s_wall_switch_cbs;
+static rbf_sounder_callbacks_t s_sounder_cbs;
+static rbf_indoor_siren_callbacks_t s_indoor_siren_cbs;
+static rbf_keypad_callbacks_t s_keypad_cbs;
+static rbf_keyfob_callbacks_t s_keyfob_cbs;
+static rbf_observer_tx_handle_t s_tx_handle;
+static rbf_observer_airtime_t s_airtime;
+
+
+static bool observer_notify(rbf_observer_msg_type_t type, RBF_dev_type_t dev_type, RBF_dev_cat_t cat, uint8_t no,
+                            int32_t rssi, const void* payload, uint32_t value)
+{
+    rbf_observer_msg_t msg;
+    uint8_t i;
+
+    if (s_observer_count == 0) {
+        return false;
+    }
+
+    msg.msg = type;
+    msg.type = dev_type;
+    msg.id.cat = cat;
+    msg.id.no = no;
+    msg.rssi = rssi;
+    msg.payload = payload;
+    msg.value = value;
+    rbf_time_get_ms(&msg.time);
+
+    for (i = 0; i < s_observer_count; i++) {
+        if (s_observers[i].handle(&msg, s_observers[i].arg) != RBF_OBSERVER_PASS) {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+int rbf_observer_add(rbf_observer_handle_t handle, void* arg)
+{
+    if (handle == NULL || s_observer_count >= RBF_OBSERVER_MAX) {
+        return -1;
+    }
+
+    s_observers[s_observer_count].handle = handle;
+    s_observers[s_observer_count].arg = arg;
+    s_observer_count++;
+
+    return 0;
+}
+
+
+int rbf_observer_remove(rbf_observer_handle_t handle, void* arg)
+{
+    uint8_t i;
+
+    for (i = 0; i < s_observer_count; i++) {
+        if (s_observers[i].handle == handle && s_observers[i].arg == arg) {
+            memmove(&s_observers[i], &s_observers[i + 1], (s_observer_count - i - 1) * sizeof(observer_t));
+            s_observer_count--;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+
+int rbf_observer_tx_set(rbf_observer_tx_handle_t handle)
+{
+    s_tx_handle = handle;
+    return 0;
+}
+
+
+void rbf_observer_tx(rbf_observer_tx_t tx, uint16_t len)
+{
+    rbf_observer_tx_handle_t handle = s_tx_handle;
+
+    if (handle != NULL) {
+        handle(tx, len);
+    }
+}
+
+
+int rbf_observer_airtime_set(rbf_observer_airtime_t airtime)
+{
+    s_airtime = airtime;
+    return 0;
+}
+
+
+uint32_t rbf_observer_airtime_us(uint16_t len)
+{
+    rbf_observer_airtime_t airtime = s_airtime;
+
+    return airtime != NULL ? airtime(len) : 0;
+}
+
+
+static int observer_magnetic_heartbeat(uint8_t no, rbf_magnetic_heartbeat_t* heartbeat)
+{
+    if (observer_notify(RBF_OBSERVER_MSG_HEARTBEAT, RBF_DEV_TYPE_MC, RBF_DEV_IO, no, heartbeat->rssi, heartbeat, 0)) {
+        return 0;
+    }
+    return s_magnetic_cbs.hb_cb ? s_magnetic_cbs.hb_cb(no, heartbeat) : 0;
+}
+
+
+static int observer_magnetic_input_status(uint8_t no, rbf_magnetic_input_status_t* input_status)
+{
+    if (observer_notify(RBF_OBSERVER_MSG_INPUT_STATUS, RBF_DEV_TYPE_MC, RBF_DEV_IO, no, 0, input_status, 0)) {
+        return 0;
+    }
+    return s_magnetic_cbs.input_status_cb ? s_magnetic_cbs.input_status_cb(no, input_status) : 0;
+}
+
+
+int rbf_observer_wrap_magnetic(rbf_magnetic_callbacks_t* cbs)
+{
+    if (cbs == NULL) {
+        return -1;
+    }
+
+    s_magnetic_cbs = *cbs;
+    cbs->hb_cb = observer_magnetic_heartbeat;
+    cbs->input_status_cb = observer_magnetic_input_status;
+
+    return 0;
+}
+
+
+static int observer_pir_heartbeat(uint8_t no, rbf_pir_heartbeat_t* heartbeat)
+{
+    if (observer_notify(RBF_OBSERVER_MSG_HEARTBEAT, RBF_DEV_TYPE_PIR, RBF_DEV_IO, no, heartbeat->rssi, heartbeat, 0)) {
+        return 0;
+    }
+    return s_pir_cbs.hb_cb ? s_pir_cbs.hb_cb(no, heartbeat) : 0;
+}
+
+
+static int observer_pir_input_evt(uint8_t no, rbf_pir_input_evt_t evt)
+{
+    if (observer_notify(RBF_OBSERVER_MSG_INPUT_EVT, RBF_DEV_TYPE_PIR, RBF_DEV_IO, no, 0, NULL, (uint32_t)evt)) {
+        return 0;
+    }
+    return s_pir_cbs.input_evt_cb ? s_pir_cbs.input_evt_cb(no, evt) : 0;
+}
+
+
+static int observer_pir_input_status(uint8_t no, rbf_pir_input_status_t* input_status)
+{
+    if (observer_notify(RBF_OBSERVER_MSG_INPUT_STATUS, RBF_DEV_TYPE_PIR, RBF_DEV_IO, no, 0, input_status, 0)) {
+        return 0;
+    }
+    return s_pir_cbs.input_status_cb ? s_pir_cbs.input_status_cb(no, input_status) : 0;
+}
+
+
+int rbf_observer_wrap_pir(rbf_pir_callbacks_t* cbs)
+{
+    if (cbs == NULL) {
+        return -1;
+    }
+
+    s_pir_cbs = *cbs;
+    cbs->hb_cb = observer_pir_heartbeat;
+    cbs->input_evt_cb = observer_pir_input_evt;
+    cbs->input_status_cb = observer_pir_input_status;
+
+    return 0;
+}
+
+
+static int observer_water_leak_heartbeat(uint8_t no, rbf_water_leak_heartbeat_t* heartbeat)
+{
+    if (observer_notify(RBF_OBSERVER_MSG_HEARTBEAT, RBF_DEV_TYPE_WATERT_LEAK, RBF_DEV_IO, no, heartbeat->rssi, heartbeat, 0)) {
+        return 0;
+    }
+    return s_water_leak_cbs.hb_cb ? s_water_leak_cbs.hb_cb(no, heartbeat) : 0;
+}
+
+
+static int observer_water_leak_input_status(uint8_t no, rbf_water_leak_input_status_t* input_status)
+{
+    if (observer_notify(RBF_OBSERVER_MSG_INPUT_STATUS, RBF_DEV_TYPE_WATERT_LEAK, RBF_DEV_IO, no, 0, input_status, 0)) {
+        return 0;
+    }
+    return s_water_leak_cbs.input_status_cb ? s_water_leak_cbs.input_status_cb(no, input_status) : 0;
+}
+
+
+int rbf_observer_wrap_water_leak(rbf_water_leak_callbacks_t* cbs)
+{
+    if (cbs == NULL) {
+        return -1;
+    }
+
+    s_water_leak_cbs = *cbs;
+    cbs->hb_cb = observer_water_leak_heartbeat;
+    cbs->input_status_cb = observer_water_leak_input_status;
+
+    return 0;
+}
+
+
+static int observer_emergency_button_heartbeat(uint8_t no, rbf_emergency_button_heartbeat_t* heartbeat)
+{
+    if (observer_notify(RBF_OBSERVER_MSG_HEARTBEAT, RBF_DEV_TYPE_FIXED_PA, RBF_DEV_IO, no, heartbeat->rssi, heartbeat, 0)) {
+        return 0;
+    }
+    return s_emergency_button_cbs.hb_cb ? s_emergency_button_cbs.hb_cb(no, heartbeat) : 0;
+}
+
+
+static int observer_emergency_button_input_evt(uint8_t no, rbf_emergency_button_input_evt_t evt)
+{
+    if (observer_notify(RBF_OBSERVER_MSG_INPUT_EVT, RBF_DEV_TYPE_FIXED_PA, RBF_DEV_IO, no, 0, NULL, (uint32_t)evt)) {
+        return 0;
+    }
+    return s_emergency_button_cbs.input_evt_cb ? s_emergency_button_cbs.input_evt_cb(no, evt) : 0;
+}
+
+
+int rbf_observer_wrap_emergency_button(rbf_emergency_button_callbacks_t* cbs)
+{
+    if (cbs == NULL) {
+        return -1;
+    }
+
+    s_emergency_button_cbs = *cbs;
+    cbs->hb_cb = observer_emergency_button_heartbeat;
+    cbs->input_evt_cb = observer_emergency_button_input_evt;
+
+    return 0;
+}
+
+
+static int observer_smoke_heartbeat(uint8_t no, rbf_smoke_heartbeat_t* heartbeat)
+{
+    if (observer_notify(RBF_OBSERVER_MSG_HEARTBEAT, RBF_DEV_TYPE_SMOKE, RBF_DEV_IO, no, heartbeat->rssi, heartbeat, 0)) {
+        return 0;
+    }
+    return s_smoke_cbs.hb_cb ? s_smoke_cbs.hb_cb(no, heartbeat) : 0;
+}
+
+
+static int observer_smoke_input_status(uint8_t no, rbf_smoke_input_status_t* input_status)
+{
+    if (observer_notify(RBF_OBSERVER_MSG_INPUT_STATUS, RBF_DEV_TYPE_SMOKE, RBF_DEV_IO, no, 0, input_status, 0)) {
+        return 0;
+    }
+    return s_smoke_cbs.input_status_cb ? s_smoke_cbs.input_status_cb(no, input_status) : 0;
+}
+
+
+int rbf_observer_wrap_smoke(rbf_smoke_callbacks_t* cbs)
+{
+    if (cbs == NULL) {
+        return -1;
+    }
+
+    s_smoke_cbs = *cbs;
+    cbs->hb_cb = observer_smoke_heartbeat;
+    cbs->input_status_cb = observer_smoke_input_status;
+
+    return 0;
+}
+
+
+static int observer_temp_humi_heartbeat(uint8_t no, rbf_temp_humi_heartbeat_t* heartbeat)
+{
+    if (observer_notify(RBF_OBSERVER_MSG_HEARTBEAT, RBF_DEV_TYPE_TEMP_HUMI, RBF_DEV_IO, no, heartbeat->rssi, heartbeat, 0)) {
+        return 0;
+    }
+    return s_temp_humi_cbs.hb_cb ? s_temp_humi_cbs.hb_cb(no, heartbeat) : 0;
+}
+
+
+static int observer_temp_humi_input_status(uint8_t no, rbf_temp_humi_status_t* input_status)
+{
+    if (observer_notify(RBF_OBSERVER_MSG_INPUT_STATUS, RBF_DEV_TYPE_TEMP_HUMI, RBF_DEV_IO, no, 0, input_status, 0)) {
+        return 0;
+    }
+    return s_temp_humi_cbs.input_status_cb ? s_temp_humi_cbs.input_status_cb(no, input_status) : 0;
+}
+
+
+int rbf_observer_wrap_temp_humi(rbf_temp_humi_callbacks_t* cbs)
+{
+    if (cbs == NULL) {
+        return -1;
+    }
+
+    s_temp_humi_cbs = *cbs;
+    cbs->hb_cb = observer_temp_humi_heartbeat;
+    cbs->input_status_cb = observer_temp_humi_input_status;
+
+    return 0;
+}
+
+
+static int observer_smartplug_heartbeat(uint8_t no, rbf_smartplug_heartbeat_t* heartbeat)
+{
+    if (observer_notify(RBF_OBSERVER_MSG_HEARTBEAT, RBF_DEV_TYPE_SMART_PLUG, RBF_DEV_IO, no, heartbeat->rssi, heartbeat, 0)) {
+        return 0;
+    }
+    return s_smartplug_cbs.hb_cb ? s_smartplug_cbs.hb_cb(no, heartbeat) : 0;
+}
+
+
+static int observer_smartplug_output_status(uint8_t no, rbf_smartplug_output_status_t* status)
+{
+    if (observer_notify(RBF_OBSERVER_MSG_OUTPUT_STATUS, RBF_DEV_TYPE_SMART_PLUG, RBF_DEV_IO, no, 0, status, 0)) {
+        return 0;
+    }
+    return s_smartplug_cbs.output_status_cb ? s_smartplug_cbs.output_status_cb(no, status) : 0;
+}
+
+
+int rbf_observer_wrap_smartplug(rbf_smartplug_callbacks_t* cbs)
+{
+    if (cbs == NULL) {
+        return -1;
+    }
+
+    s_smartplug_cbs = *cbs;
+    cbs->hb_cb = observer_smartplug_heartbeat;
+    cbs->output_status_cb = observer_smartplug_output_status;
+
+    return 0;
+}
+
+
+static int observer_relay_heartbeat(uint8_t no, rbf_relay_heartbeat_t* heartbeat)
+{
+    if (observer_notify(RBF_OBSERVER_MSG_HEARTBEAT, RBF_DEV_TYPE_RELAY, RBF_DEV_IO, no, heartbeat->rssi, heartbeat, 0)) {
+        return 0;
+    }
+    return s_relay_cbs.hb_cb ? s_relay_cbs.hb_cb(no, heartbeat) : 0;
+}
+
+
+static int observer_relay_output_status(uint8_t no, rbf_relay_output_status_t* status)
+{
+    if (observer_notify(RBF_OBSERVER_MSG_OUTPUT_STATUS, RBF_DEV_TYPE_RELAY, RBF_DEV_IO, no, 0, status, 0)) {
+        return 0;
+    }
+    return s_relay_cbs.output_status_cb ? s_relay_cbs.output_status_cb(no, status) : 0;
+}
+
+
+int rbf_observer_wrap_relay(rbf_relay_callbacks_t* cbs)
+{
+    if (cbs == NULL) {
+        return -1;
+    }
+
+    s_relay_cbs = *cbs;
+    cbs->hb_cb = observer_relay_heartbeat;
+    cbs->output_status_cb = observer_relay_output_status;
+
+    return 0;
+}
+
+
+static int observer_wall_switch_heartbeat(uint8_t no, rbf_wall_switch_heartbeat_t* heartbeat)
+{
+    if (observer_notify(RBF_OBSERVER_MSG_HEARTBEAT, RBF_DEV_TYPE_WALL_SWITCH, RBF_DEV_IO, no, heartbeat->rssi, heartbeat, 0)) {
+        return 0;
+    }
+    return s_wall_switch_cbs.hb_cb ? s_wall_switch_cbs.hb_cb(no, heartbeat) : 0;
+}
+
+
+static int observer_wall_switch_output_status(uint8_t no, rbf_wall_switch_output_status_t* status)
+{
+    if (observer_notify(RBF_OBSERVER_MSG_OUTPUT_STATUS, RBF_DEV_TYPE_WALL_SWITCH, RBF_DEV_IO, no, 0, status, 0)) {
+        return 0;
+    }
+    return s_wall_switch_cbs.output_status_cb ? s_wall_switch_cbs.output_status_cb(no, status) : 0;
+}
+
+
+int rbf_observer_wrap_wall_switch(rbf_wall_switch_callbacks_t* cbs)
+{
+    if (cbs == NULL) {
+        return -1;
+    }
+
+    s_wall_switch_cbs = *cbs;
+    cbs->hb_cb = observer_wall_switch_heartbeat;
+    cbs->output_status_cb = observer_wall_switch_output_status;
+
+    return 0;
+}
+
+
+static int observer_sounder_heartbeat(uint8_t no, rbf_sounder_heartbeat_t* heartbeat)
+{
+    if (observer_notify(RBF_OBSERVER_MSG_HEARTBEAT, RBF_DEV_TYPE_OUT_SOUND, RBF_DEV_SOUNDER, no, heartbeat->rssi, heartbeat, 0)) {
+        return 0;
+    }
+    return s_sounder_cbs.hb_cb ? s_sounder_cbs.hb_cb(no, heartbeat) : 0;
+}
+
+
+static int observer_sounder_input_status(uint8_t no, rbf_sounder_input_status_t* input_status)
+{
+    if (observer_notify(RBF_OBSERVER_MSG_INPUT_STATUS, RBF_DEV_TYPE_OUT_SOUND, RBF_DEV_SOUNDER, no, 0, input_status, 0)) {
+        return 0;
+    }
+    return s_sounder_cbs.input_status_cb ? s_sounder_cbs.input_status_cb(no, input_status) : 0;
+}
+
+
+int rbf_observer_wrap_sounder(rbf_sounder_callbacks_t* cbs)
+{
+    if (cbs == NULL) {
+        return -1;
+    }
+
+    s_sounder_cbs = *cbs;
+    cbs->hb_cb = observer_sounder_heartbeat;
+    cbs->input_status_cb = observer_sounder_input_status;
+
+    return 0;
+}
+
+
+static int observer_indoor_siren_heartbeat(uint8_t no, rbf_indoor_siren_heartbeat_t* heartbeat)
+{
+    if (observer_notify(RBF_OBSERVER_MSG_HEARTBEAT, RBF_DEV_TYPE_INDOOR_SIREN, RBF_DEV_SOUNDER, no, heartbeat->rssi, heartbeat, 0)) {
+        return 0;
+    }
+    return s_indoor_siren_cbs.hb_cb ? s_indoor_siren_cbs.hb_cb(no, heartbeat) : 0;
+}
+
+
+static int observer_indoor_siren_input_status(uint8_t no, rbf_indoor_siren_input_status_t* input_status)
+{
+    if (observer_notify(RBF_OBSERVER_MSG_INPUT_STATUS, RBF_DEV_TYPE_INDOOR_SIREN, RBF_DEV_SOUNDER, no, 0, input_status, 0)) {
+        return 0;
+    }
+    return s_indoor_siren_cbs.input_status_cb ? s_indoor_siren_cbs.input_status_cb(no, input_status) : 0;
+}
+
+
+int rbf_observer_wrap_indoor_siren(rbf_indoor_siren_callbacks_t* cbs)
+{
+    if (cbs == NULL) {
+        return -1;
+    }
+
+    s_indoor_siren_cbs = *cbs;
+    cbs->hb_cb = observer_indoor_siren_heartbeat;
+    cbs->input_status_cb = observer_indoor_siren_input_status;
+
+    return 0;
+}
+
+
+static int observer_keypad_heartbeat(uint8_t no, rbf_keypad_heartbeat_t* heartbeat)
+{
+    if (observer_notify(RBF_OBSERVER_MSG_HEARTBEAT, RBF_DEV_TYPE_LED_KEYPAD, RBF_DEV_KEYPAD, no, heartbeat->rssi, heartbeat, 0)) {
+        return 0;
+    }
+    return s_keypad_cbs.hb_cb ? s_keypad_cbs.hb_cb(no, heartbeat) : 0;
+}
+
+
+static int observer_keypad_alarm(uint8_t no, rbf_keypad_alarm_status_t* alarm_status)
+{
+    if (observer_notify(RBF_OBSERVER_MSG_ALARM, RBF_DEV_TYPE_LED_KEYPAD, RBF_DEV_KEYPAD, no, 0, alarm_status, 0)) {
+        return 0;
+    }
+    return s_keypad_cbs.alarm_cb ? s_keypad_cbs.alarm_cb(no, alarm_status) : 0;
+}
+
+
+static int observer_keypad_key_input(uint8_t no, uint8_t input_keys[32], uint8_t input_count)
+{
+    if (observer_notify(RBF_OBSERVER_MSG_KEY, RBF_DEV_TYPE_LED_KEYPAD, RBF_DEV_KEYPAD, no, 0, input_keys, input_count)) {
+        return 0;
+    }
+    return s_keypad_cbs.key_input_cb ? s_keypad_cbs.key_input_cb(no, input_keys, input_count) : 0;
+}
+
+
+int rbf_observer_wrap_keypad(rbf_keypad_callbacks_t* cbs)
+{
+    if (cbs == NULL) {
+        return -1;
+    }
+
+    s_keypad_cbs = *cbs;
+    cbs->hb_cb = observer_keypad_heartbeat;
+    cbs->alarm_cb = observer_keypad_alarm;
+    cbs->key_input_cb = observer_keypad_key_input;
+
+    return 0;
+}
+
+
+static int observer_keyfob_heartbeat(uint8_t no, rbf_keyfob_heartbeat_t* heartbeat)
+{
+    if (observer_notify(RBF_OBSERVER_MSG_HEARTBEAT, RBF_DEV_TYPE_KEYFOB, RBF_DEV_KEYFOB, no, heartbeat->rssi, heartbeat, 0)) {
+        return 0;
+    }
+    return s_keyfob_cbs.hb_cb ? s_keyfob_cbs.hb_cb(no, heartbeat) : 0;
+}
+
+
+static int observer_keyfob_key_press(uint8_t no, uint8_t key)
+{
+    if (observer_notify(RBF_OBSERVER_MSG_KEY, RBF_DEV_TYPE_KEYFOB, RBF_DEV_KEYFOB, no, 0, NULL, key)) {
+        return 0;
+    }
+    return s_keyfob_cbs.key_press_cb ? s_keyfob_cbs.key_press_cb(no, key) : 0;
+}
+
+
+int rbf_observer_wrap_keyfob(rbf_keyfob_callbacks_t* cbs)
+{
+    if (cbs == NULL) {
+        return -1;
+    }
+
+    s_keyfob_cbs = *cbs;
+    cbs->hb_cb = observer_keyfob_heartbeat;
+    cbs->key_press_cb = observer_keyfob_key_press;
+
+    return 0;
+}
+
+
+uint32_t rbf_observer_payload_size(const rbf_observer_msg_t* msg)
+{
+    if (msg == NULL || msg->payload == NULL) {
+        return 0;
+    }
+
+    switch (msg->msg) {
+    case RBF_OBSERVER_MSG_HEARTBEAT:
+        switch (msg->type) {
+        case RBF_DEV_TYPE_MC:
+            return sizeof(rbf_magnetic_heartbeat_t);
+        case RBF_DEV_TYPE_PIR:
+            return sizeof(rbf_pir_heartbeat_t);
+        case RBF_DEV_TYPE_WATERT_LEAK:
+            return sizeof(rbf_water_leak_heartbeat_t);
+        case RBF_DEV_TYPE_FIXED_PA:
+            return sizeof(rbf_emergency_button_heartbeat_t);
+        case RBF_DEV_TYPE_SMOKE:
+            return sizeof(rbf_smoke_heartbeat_t);
+        case RBF_DEV_TYPE_TEMP_HUMI:
+            return sizeof(rbf_temp_humi_heartbeat_t);
+        case RBF_DEV_TYPE_SMART_PLUG:
+            return sizeof(rbf_smartplug_heartbeat_t);
+        case RBF_DEV_TYPE_RELAY:
+            return sizeof(rbf_relay_heartbeat_t);
+        case RBF_DEV_TYPE_WALL_SWITCH:
+            return sizeof(rbf_wall_switch_heartbeat_t);
+        case RBF_DEV_TYPE_OUT_SOUND:
+            return sizeof(rbf_sounder_heartbeat_t);
+        case RBF_DEV_TYPE_INDOOR_SIREN:
+            return sizeof(rbf_indoor_siren_heartbeat_t);
+        case RBF_DEV_TYPE_LED_KEYPAD:
+            return sizeof(rbf_keypad_heartbeat_t);
+        case RBF_DEV_TYPE_KEYFOB:
+            return sizeof(rbf_keyfob_heartbeat_t);
+        default:
+            return 0;
+        }
+    case RBF_OBSERVER_MSG_INPUT_STATUS:
+        switch (msg->type) {
+        case RBF_DEV_TYPE_MC:
+            return sizeof(rbf_magnetic_input_status_t);
+        case RBF_DEV_TYPE_PIR:
+            return sizeof(rbf_pir_input_status_t);
+        case RBF_DEV_TYPE_WATERT_LEAK:
+            return sizeof(rbf_water_leak_input_status_t);
+        case RBF_DEV_TYPE_SMOKE:
+            return sizeof(rbf_smoke_input_status_t);
+        case RBF_DEV_TYPE_TEMP_HUMI:
+            return sizeof(rbf_temp_humi_status_t);
+        case RBF_DEV_TYPE_OUT_SOUND:
+            return sizeof(rbf_sounder_input_status_t);
+        case RBF_DEV_TYPE_INDOOR_SIREN:
+            return sizeof(rbf_indoor_siren_input_status_t);
+        default:
+            return 0;
+        }
+    case RBF_OBSERVER_MSG_ALARM:
+        return sizeof(rbf_keypad_alarm_status_t);
+    case RBF_OBSERVER_MSG_KEY:
+        return msg->type == RBF_DEV_TYPE_LED_KEYPAD ? sizeof(((rbf_observer_payload_t*)0)->keypad_keys) : 0;
+    case RBF_OBSERVER_MSG_OUTPUT_STATUS:
+        switch (msg->type) {
+        case RBF_DEV_TYPE_SMART_PLUG:
+            return sizeof(rbf_smartplug_output_status_t);
+        case RBF_DEV_TYPE_RELAY:
+            return sizeof(rbf_relay_output_status_t);
+        case RBF_DEV_TYPE_WALL_SWITCH:
+            return sizeof(rbf_wall_switch_output_status_t);
+        default:
+            return 0;
+        }
+    default:
+        return 0;
+    }
+}
+
+
+static int observer_deliver_heartbeat(uint8_t no, RBF_dev_type_t type, void* payload)
+{
+    switch (type) {
+    case RBF_DEV_TYPE_MC:
+        return s_magnetic_cbs.hb_cb ? s_magnetic_cbs.hb_cb(no, payload) : 0;
+    case RBF_DEV_TYPE_PIR:
+        return s_pir_cbs.hb_cb ? s_pir_cbs.hb_cb(no, payload) : 0;
+    case RBF_DEV_TYPE_WATERT_LEAK:
+        return s_water_leak_cbs.hb_cb ? s_water_leak_cbs.hb_cb(no, payload) : 0;
+    case RBF_DEV_TYPE_FIXED_PA:
+        return s_emergency_button_cbs.hb_cb ? s_emergency_button_cbs.hb_cb(no, payload) : 0;
+    case RBF_DEV_TYPE_SMOKE:
+        return s_smoke_cbs.hb_cb ? s_smoke_cbs.hb_cb(no, payload) : 0;
+    case RBF_DEV_TYPE_TEMP_HUMI:
+        return s_temp_humi_cbs.hb_cb ? s_temp_humi_cbs.hb_cb(no, payload) : 0;
+    case RBF_DEV_TYPE_SMART_PLUG:
+        return s_smartplug_cbs.hb_cb ? s_smartplug_cbs.hb_cb(no, payload) : 0;
+    case RBF_DEV_TYPE_RELAY:
+        return s_relay_cbs.hb_cb ? s_relay_cbs.hb_cb(no, payload) : 0;
+    case RBF_DEV_TYPE_WALL_SWITCH:
+        return s_wall_switch_cbs.hb_cb ? s_wall_switch_cbs.hb_cb(no, payload) : 0;
+    case RBF_DEV_TYPE_OUT_SOUND:
+        return s_sounder_cbs.hb_cb ? s_sounder_cbs.hb_cb(no, payload) : 0;
+    case RBF_DEV_TYPE_INDOOR_SIREN:
+        return s_indoor_siren_cbs.hb_cb ? s_indoor_siren_cbs.hb_cb(no, payload) : 0;
+    case RBF_DEV_TYPE_LED_KEYPAD:
+        return s_keypad_cbs.hb_cb ? s_keypad_cbs.hb_cb(no, payload) : 0;
+    case RBF_DEV_TYPE_KEYFOB:
+        return s_keyfob_cbs.hb_cb ? s_keyfob_cbs.hb_cb(no, payload) : 0;
+    default:
+        return 0;
+    }
+}
+
+
+static int observer_deliver_input_status(uint8_t no, RBF_dev_type_t type, void* payload)
+{
+    switch (type) {
+    case RBF_DEV_TYPE_MC:
+        return s_magnetic_cbs.input_status_cb ? s_magnetic_cbs.input_status_cb(no, payload) : 0;
+    case RBF_DEV_TYPE_PIR:
+        return s_pir_cbs.input_status_cb ? s_pir_cbs.input_status_cb(no, payload) : 0;
+    case RBF_DEV_TYPE_WATERT_LEAK:
+        return s_water_leak_cbs.input_status_cb ? s_water_leak_cbs.input_status_cb(no, payload) : 0;
+    case RBF_DEV_TYPE_SMOKE:
+        return s_smoke_cbs.input_status_cb ? s_smoke_cbs.input_status_cb(no, payload) : 0;
+    case RBF_DEV_TYPE_TEMP_HUMI:
+        return s_temp_humi_cbs.input_status_cb ? s_temp_humi_cbs.input_status_cb(no, payload) : 0;
+    case RBF_DEV_TYPE_OUT_SOUND:
+        return s_sounder_cbs.input_status_cb ? s_sounder_cbs.input_status_cb(no, payload) : 0;
+    case RBF_DEV_TYPE_INDOOR_SIREN:
+        return s_indoor_siren_cbs.input_status_cb ? s_indoor_siren_cbs.input_status_cb(no, payload) : 0;
+    default:
+        return 0;
+    }
+}
+
+
+static int observer_deliver_output_status(uint8_t no, RBF_dev_type_t type, void* payload)
+{
+    switch (type) {
+    case RBF_DEV_TYPE_SMART_PLUG:
+        return s_smartplug_cbs.output_status_cb ? s_smartplug_cbs.output_status_cb(no, payload) : 0;
+    case RBF_DEV_TYPE_RELAY:
+        return s_relay_cbs.output_status_cb ? s_relay_cbs.output_status_cb(no, payload) : 0;
+    case RBF_DEV_TYPE_WALL_SWITCH:
+        return s_wall_switch_cbs.output_status_cb ? s_wall_switch_cbs.output_status_cb(no, payload) : 0;
+    default:
+        return 0;
+    }
+}
+
+
+int rbf_observer_deliver(const rbf_observer_msg_t* msg)
+{
+    /* The application callbacks take non-const parameters */
+    void* payload;
+    uint8_t no;
+
+    if (msg == NULL) {
+        return 0;
+    }
+
+    payload = (void*)msg->payload;
+    no = msg->id.no;
+    switch (msg->msg) {
+    case RBF_OBSERVER_MSG_HEARTBEAT:
+        return payload ? observer_deliver_heartbeat(no, msg->type, payload) : 0;
+    case RBF_OBSERVER_MSG_INPUT_STATUS:
+        return payload ? observer_deliver_input_status(no, msg->type, payload) : 0;
+    case RBF_OBSERVER_MSG_INPUT_EVT:
+        if (msg->type == RBF_DEV_TYPE_PIR) {
+            return s_pir_cbs.input_evt_cb ? s_pir_cbs.input_evt_cb(no, (rbf_pir_input_evt_t)msg->value) : 0;
+        }
+        return s_emergency_button_cbs.input_evt_cb ?
+               s_emergency_button_cbs.input_evt_cb(no, (rbf_emergency_button_input_evt_t)msg->value) : 0;
+    case RBF_OBSERVER_MSG_ALARM:
+        return s_keypad_cbs.alarm_cb && payload ? s_keypad_cbs.alarm_cb(no, payload) : 0;
+    case RBF_OBSERVER_MSG_KEY:
+        if (msg->type == RBF_DEV_TYPE_LED_KEYPAD) {
+            return s_keypad_cbs.key_input_cb && payload ? s_keypad_cbs.key_input_cb(no, payload, (uint8_t)msg->value) : 0;
+        }
+        return s_keyfob_cbs.key_press_cb ? s_keyfob_cbs.key_press_cb(no, (uint8_t)msg->value) : 0;
+    case RBF_OBSERVER_MSG_OUTPUT_STATUS:
+        return payload ? observer_deliver_output_status(no, msg->type, payload) : 0;
+    default:
+        return 0;
+    }
+}
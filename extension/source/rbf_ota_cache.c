@@ -0,0 +1,408 @@
+/**
+ * @file rbf_ota_cache.c
+ * @brief Read-ahead firmware cache for OTA data requests
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+#include <string.h>
+#include <stdbool.h>
+#include "rbf_ota_cache.h"
+#include "rbf_mem.h"
+#include "rbf_mutex.h"
+#include "rbf_thread.h"
+
+#define CACHE_LINE_INVALID          (0xFFFFFFFF)
+
+typedef struct
+{
+    uint32_t base;          /**< Firmware offset of the line, CACHE_LINE_INVALID when empty */
+    uint32_t len;           /**< Valid bytes in the line */
+    uint32_t stamp;         /**< Last use, for replacement */
+    bool filling;           /**< Being read from the data handle, outside the lock, base already set */
+    unsigned char* data;
+}cache_line_t;
+
+typedef struct
+{
+    rbf_ota_data_handle_t source;
+    rbf_mutex_t mutex;
+    cache_line_t* lines;
+    unsigned char* buffer;
+    uint32_t line_size;
+    uint8_t line_count;
+    uint32_t fw_size;
+    uint32_t stamp;
+    uint32_t gen;           /**< Changed on every invalidation, drops the fills started before */
+    uint32_t next_base;     /**< Line to read ahead, CACHE_LINE_INVALID when none */
+    rbf_ota_cache_stats_t stats;
+}ota_cache_t;
+
+static ota_cache_t s_caches[RBF_OTA_TARGET_MAX];
+static RBF_ota_evt_callbacks_t s_hub_user_cbs;
+static RBF_subdev_ota_evt_callbacks_t s_subdev_user_cbs;
+
+
+static void cache_invalidate(ota_cache_t* cache)
+{
+    uint8_t i;
+
+    for (i = 0; i < cache->line_count; i++) {
+        cache->lines[i].base = CACHE_LINE_INVALID;
+        cache->lines[i].len = 0;
+    }
+    cache->next_base = CACHE_LINE_INVALID;
+    cache->gen++;
+}
+
+
+static cache_line_t* cache_lookup(ota_cache_t* cache, uint32_t base)
+{
+    uint8_t i;
+
+    for (i = 0; i < cache->line_count; i++) {
+        if (!cache->lines[i].filling && cache->lines[i].base == base) {
+            return &cache->lines[i];
+        }
+    }
+    return NULL;
+}
+
+
+static cache_line_t* cache_busy(ota_cache_t* cache, uint32_t base)
+{
+    uint8_t i;
+
+    for (i = 0; i < cache->line_count; i++) {
+        if (cache->lines[i].filling && cache->lines[i].base == base) {
+            return &cache->lines[i];
+        }
+    }
+    return NULL;
+}
+
+
+static cache_line_t* cache_victim(ota_cache_t* cache, const cache_line_t* keep)
+{
+    cache_line_t* victim = NULL;
+    uint8_t i;
+
+    for (i = 0; i < cache->line_count; i++) {
+        cache_line_t* line = &cache->lines[i];
+
+        if (line == keep || line->filling) {
+            continue;
+        }
+        if (line->base == CACHE_LINE_INVALID) {
+            return line;
+        }
+        if (victim == NULL || (int32_t)(line->stamp - victim->stamp) < 0) {
+            victim = line;
+        }
+    }
+    return victim;
+}
+
+
+/*
+ * Called and returns with the lock held, the lock is released during the data handle call so the
+ * other thread is not stalled by a slow read. The data handle may then run in both threads at once.
+ */
+static cache_line_t* cache_fill(ota_cache_t* cache, uint32_t base, const cache_line_t* keep)
+{
+    cache_line_t* line;
+    uint32_t len = cache->line_size;
+    uint32_t gen = cache->gen;
+    int ret;
+
+    /* Without the image size a whole line could run past its end */
+    if (cache->fw_size == 0 || base >= cache->fw_size) {
+        return NULL;
+    }
+    if (base + len > cache->fw_size) {
+        len = cache->fw_size - base;
+    }
+
+    line = cache_victim(cache, keep);
+    if (line == NULL) {
+        return NULL;
+    }
+    /* Marked busy with its base, so the other thread waits for it instead of fetching it again */
+    line->filling = true;
+    line->base = base;
+    cache->stats.fetches++;
+
+    rbf_mutex_unlock(cache->mutex);
+    ret = cache->source(base, len, line->data);
+    rbf_mutex_lock(cache->mutex);
+
+    line->filling = false;
+    if (ret != 0 || gen != cache->gen) {
+        /* Failed, or the cache was reset for another image meanwhile */
+        line->base = CACHE_LINE_INVALID;
+        return NULL;
+    }
+
+    line->len = len;
+    line->stamp = ++cache->stamp;
+    return line;
+}
+
+
+static int cache_read(ota_cache_t* cache, unsigned int offset, unsigned int size, unsigned char* data)
+{
+    cache_line_t* line = NULL;
+    bool miss = false;
+    int ret = 0;
+
+    if (cache->source == NULL) {
+        return -1;
+    }
+
+    rbf_mutex_lock(cache->mutex);
+    cache->stats.requests++;
+
+    while (size > 0) {
+        uint32_t base = offset - offset % cache->line_size;
+        uint32_t pos = offset - base;
+        uint32_t chunk;
+
+        line = cache_lookup(cache, base);
+        if (line == NULL) {
+            miss = true;
+            /* Being read ahead by rbf_ota_cache_poll() */
+            while (cache_busy(cache, base) != NULL) {
+                rbf_mutex_unlock(cache->mutex);
+                rbf_thread_sleep(1);
+                rbf_mutex_lock(cache->mutex);
+            }
+            line = cache_lookup(cache, base);
+        }
+        if (line == NULL) {
+            line = cache_fill(cache, base, NULL);
+        }
+        if (line == NULL || pos >= line->len) {
+            /* Image size unknown, or past its end: pass the request through */
+            cache->stats.fetches++;
+            rbf_mutex_unlock(cache->mutex);
+            ret = cache->source(offset, size, data);
+            rbf_mutex_lock(cache->mutex);
+            line = NULL;
+            break;
+        }
+
+        chunk = line->len - pos;
+        if (chunk > size) {
+            chunk = size;
+        }
+        memcpy(data, line->data + pos, chunk);
+        line->stamp = ++cache->stamp;
+        offset += chunk;
+        data += chunk;
+        size -= chunk;
+    }
+
+    if (miss) {
+        cache->stats.misses++;
+    } else if (ret == 0) {
+        cache->stats.hits++;
+    }
+
+    /* Read ahead the line following the one the engine is reading */
+    if (line != NULL) {
+        uint32_t base = line->base + cache->line_size;
+        cache->next_base = cache_lookup(cache, base) ? CACHE_LINE_INVALID : base;
+    }
+    rbf_mutex_unlock(cache->mutex);
+
+    return ret;
+}
+
+
+static int cache_init(ota_cache_t* cache, rbf_ota_data_handle_t source, const rbf_ota_cache_cfg_t* cfg)
+{
+    uint32_t line_size = (cfg && cfg->line_size) ? cfg->line_size : RBF_OTA_CACHE_LINE_SIZE_DEFAULT;
+    uint8_t line_count = (cfg && cfg->line_count) ? cfg->line_count : RBF_OTA_CACHE_LINE_COUNT_DEFAULT;
+    uint8_t i;
+
+    if (source == NULL || line_count < 2 || cache->lines != NULL) {
+        return -1;
+    }
+
+    /* Kept on failure, a later call reuses it */
+    if (cache->mutex == NULL) {
+        cache->mutex = rbf_mutex_create();
+    }
+    cache->lines = rbf_malloc(sizeof(cache_line_t) * line_count);
+    cache->buffer = rbf_malloc(line_size * line_count);
+    if (cache->mutex == NULL || cache->lines == NULL || cache->buffer == NULL) {
+        if (cache->lines) {
+            rbf_free(cache->lines);
+            cache->lines = NULL;
+        }
+        if (cache->buffer) {
+            rbf_free(cache->buffer);
+            cache->buffer = NULL;
+        }
+        return -1;
+    }
+
+    for (i = 0; i < line_count; i++) {
+        cache->lines[i].data = cache->buffer + line_size * i;
+        cache->lines[i].filling = false;
+    }
+    cache->source = source;
+    cache->line_size = line_size;
+    cache->line_count = line_count;
+    cache->fw_size = 0;
+    memset(&cache->stats, 0, sizeof(cache->stats));
+    cache_invalidate(cache);
+
+    return 0;
+}
+
+
+/* Drop the lines, the image size set by rbf_ota_cache_reset() is kept */
+static void cache_drop(ota_cache_t* cache)
+{
+    rbf_mutex_lock(cache->mutex);
+    cache_invalidate(cache);
+    rbf_mutex_unlock(cache->mutex);
+}
+
+
+static int cache_hub_data_handle(unsigned int offset, unsigned int size, unsigned char* data)
+{
+    return cache_read(&s_caches[RBF_OTA_TARGET_HUB], offset, size, data);
+}
+
+
+static int cache_hub_evt_handle(RBF_ota_evt_t evt, RBF_ota_status_t* status)
+{
+    if (evt == RBF_OTA_EVT_UPGRADE_COMPLETE || evt == RBF_OTA_EVT_UPGRADE_FAIL) {
+        cache_drop(&s_caches[RBF_OTA_TARGET_HUB]);
+    }
+
+    if (s_hub_user_cbs.rbf_ota_evt_handle == NULL) {
+        return 0;
+    }
+    return s_hub_user_cbs.rbf_ota_evt_handle(evt, status);
+}
+
+
+static int cache_subdev_data_handle(unsigned int offset, unsigned int size, unsigned char* data)
+{
+    return cache_read(&s_caches[RBF_OTA_TARGET_SUBDEV], offset, size, data);
+}
+
+
+static int cache_subdev_evt_handle(RBF_subdev_ota_evt_t evt, RBF_subdev_ota_faild_response_t* responses, uint8_t response_count)
+{
+    /* The wave is over: the next one usually sends the same image, the size is kept. A request
+       timeout only ends some devices of the wave, the others go on reading */
+    if (evt != RBF_SUBDEV_OTA_EVT_UPGRADE_REQUEST_TIMEOUT) {
+        cache_drop(&s_caches[RBF_OTA_TARGET_SUBDEV]);
+    }
+
+    if (s_subdev_user_cbs.rbf_subdev_ota_evt_handle == NULL) {
+        return 0;
+    }
+    return s_subdev_user_cbs.rbf_subdev_ota_evt_handle(evt, responses, response_count);
+}
+
+
+int rbf_ota_cache_wrap_hub(RBF_ota_evt_callbacks_t* cbs, const rbf_ota_cache_cfg_t* cfg)
+{
+    if (cbs == NULL || 0 != cache_init(&s_caches[RBF_OTA_TARGET_HUB], cbs->rbf_ota_request_upgrade_data_handle, cfg)) {
+        return -1;
+    }
+
+    s_hub_user_cbs = *cbs;
+    cbs->rbf_ota_request_upgrade_data_handle = cache_hub_data_handle;
+    cbs->rbf_ota_evt_handle = cache_hub_evt_handle;
+
+    return 0;
+}
+
+
+int rbf_ota_cache_wrap_subdev(RBF_subdev_ota_evt_callbacks_t* cbs, const rbf_ota_cache_cfg_t* cfg)
+{
+    if (cbs == NULL || 0 != cache_init(&s_caches[RBF_OTA_TARGET_SUBDEV], cbs->rbf_subdev_ota_request_upgrade_data_handle, cfg)) {
+        return -1;
+    }
+
+    s_subdev_user_cbs = *cbs;
+    cbs->rbf_subdev_ota_request_upgrade_data_handle = cache_subdev_data_handle;
+    cbs->rbf_subdev_ota_evt_handle = cache_subdev_evt_handle;
+
+    return 0;
+}
+
+
+int rbf_ota_cache_reset(rbf_ota_target_t target, uint32_t fw_size)
+{
+    ota_cache_t* cache;
+
+    if (target >= RBF_OTA_TARGET_MAX || s_caches[target].lines == NULL) {
+        return -1;
+    }
+
+    cache = &s_caches[target];
+    rbf_mutex_lock(cache->mutex);
+    cache_invalidate(cache);
+    cache->fw_size = fw_size;
+    rbf_mutex_unlock(cache->mutex);
+
+    return 0;
+}
+
+
+int rbf_ota_cache_poll(void)
+{
+    int count = 0;
+    int i;
+
+    for (i = 0; i < RBF_OTA_TARGET_MAX; i++) {
+        ota_cache_t* cache = &s_caches[i];
+        cache_line_t* keep;
+
+        if (cache->lines == NULL) {
+            continue;
+        }
+
+        rbf_mutex_lock(cache->mutex);
+        /* Without the image size a read ahead could run past its end */
+        if (cache->fw_size && cache->next_base != CACHE_LINE_INVALID && cache_lookup(cache, cache->next_base) == NULL
+            && cache_busy(cache, cache->next_base) == NULL) {
+            /* Never evict the line the engine is currently reading */
+            keep = cache_lookup(cache, cache->next_base - cache->line_size);
+            if (cache_fill(cache, cache->next_base, keep) != NULL) {
+                cache->stats.prefetches++;
+                count++;
+            }
+        }
+        cache->next_base = CACHE_LINE_INVALID;
+        rbf_mutex_unlock(cache->mutex);
+    }
+
+    return count;
+}
+
+
+int rbf_ota_cache_stats_get(rbf_ota_target_t target, rbf_ota_cache_stats_t* stats)
+{
+    ota_cache_t* cache;
+
+    if (target >= RBF_OTA_TARGET_MAX || stats == NULL || s_caches[target].lines == NULL) {
+        return -1;
+    }
+
+    cache = &s_caches[target];
+    rbf_mutex_lock(cache->mutex);
+    *stats = cache->stats;
+    rbf_mutex_unlock(cache->mutex);
+
+    return 0;
+}
@@ -0,0 +1,147 @@
+/**
+ * @file rbf_ota_checkpoint.c
+ * @brief Resumable hub OTA: persists the offset confirmed by the bootloader and continues from it
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+#include <string.h>
+#include "rbf_ota_checkpoint.h"
+
+static RBF_ota_evt_callbacks_t s_user_cbs;
+static rbf_ota_checkpoint_store_t s_store;
+static uint32_t s_save_interval = RBF_OTA_CHECKPOINT_SAVE_INTERVAL;
+
+static rbf_ota_checkpoint_t s_checkpoint;
+static uint32_t s_saved_offset;
+static uint32_t s_base;             /**< Image offset of the first byte of the library transfer */
+static rbf_ota_checkpoint_info_t s_info;
+
+
+static void rbf_ota_checkpoint_save(void)
+{
+    if (s_store.save == NULL || s_checkpoint.confirmed_offset == s_saved_offset) {
+        return;
+    }
+
+    if (0 == s_store.save(&s_checkpoint)) {
+        s_saved_offset = s_checkpoint.confirmed_offset;
+    }
+}
+
+
+static void rbf_ota_checkpoint_clear(void)
+{
+    if (s_store.clear != NULL) {
+        s_store.clear();
+    }
+    s_checkpoint.confirmed_offset = 0;
+    s_saved_offset = 0;
+}
+
+
+static int rbf_ota_checkpoint_data_handle(unsigned int offset, unsigned int size, unsigned char* data)
+{
+    offset += s_base;
+
+    /* The bootloader requests a block only after the previous one has been accepted */
+    if (offset > s_checkpoint.confirmed_offset) {
+        s_checkpoint.confirmed_offset = offset;
+        if (s_checkpoint.confirmed_offset - s_saved_offset >= s_save_interval) {
+            rbf_ota_checkpoint_save();
+        }
+    }
+
+    if (s_user_cbs.rbf_ota_request_upgrade_data_handle == NULL) {
+        return -1;
+    }
+    return s_user_cbs.rbf_ota_request_upgrade_data_handle(offset, size, data);
+}
+
+
+static int rbf_ota_checkpoint_evt_handle(RBF_ota_evt_t evt, RBF_ota_status_t* status)
+{
+    switch (evt) {
+        case RBF_OTA_EVT_UPGRADE_COMPLETE:
+        case RBF_OTA_EVT_START_FAIL:
+            /* Image written, or refused by the bootloader: the next transfer starts at 0 */
+            rbf_ota_checkpoint_clear();
+            break;
+        case RBF_OTA_EVT_UPGRADE_FAIL:
+            rbf_ota_checkpoint_save();
+            break;
+        default:
+            break;
+    }
+
+    if (s_user_cbs.rbf_ota_evt_handle == NULL) {
+        return 0;
+    }
+    return s_user_cbs.rbf_ota_evt_handle(evt, status);
+}
+
+
+int rbf_ota_checkpoint_wrap(RBF_ota_evt_callbacks_t* cbs, rbf_ota_checkpoint_store_t* store, uint32_t save_interval)
+{
+    if (cbs == NULL || store == NULL) {
+        return -1;
+    }
+
+    s_user_cbs = *cbs;
+    s_store = *store;
+    s_save_interval = save_interval ? save_interval : RBF_OTA_CHECKPOINT_SAVE_INTERVAL;
+
+    cbs->rbf_ota_request_upgrade_data_handle = rbf_ota_checkpoint_data_handle;
+    cbs->rbf_ota_evt_handle = rbf_ota_checkpoint_evt_handle;
+
+    return 0;
+}
+
+
+int rbf_ota_checkpoint_start(uint32_t fw_size, uint32_t image_crc)
+{
+    rbf_ota_checkpoint_t saved;
+    int ret;
+
+    s_info.resumed = false;
+    s_info.checkpoint_offset = 0;
+    s_info.bytes_skipped = 0;
+
+    if (s_store.load != NULL && 0 == s_store.load(&saved)) {
+        if (saved.fw_size == fw_size && saved.image_crc == image_crc
+            && saved.confirmed_offset < fw_size) {
+            s_info.checkpoint_offset = saved.confirmed_offset;
+        } else {
+            /* Checkpoint belongs to another image */
+            rbf_ota_checkpoint_clear();
+        }
+    }
+
+    s_checkpoint.fw_size = fw_size;
+    s_checkpoint.image_crc = image_crc;
+    s_checkpoint.confirmed_offset = s_info.checkpoint_offset;
+    s_saved_offset = s_info.checkpoint_offset;
+    s_base = s_info.checkpoint_offset;
+
+    ret = rbf_ota_start(fw_size - s_base);
+    if (ret == 0 && s_base > 0) {
+        s_info.resumed = true;
+        s_info.bytes_skipped = s_base;
+        s_info.bytes_skipped_total += s_base;
+        s_info.resume_count++;
+    }
+    return ret;
+}
+
+
+int rbf_ota_checkpoint_info_get(rbf_ota_checkpoint_info_t* info)
+{
+    if (info == NULL) {
+        return -1;
+    }
+
+    memcpy(info, &s_info, sizeof(rbf_ota_checkpoint_info_t));
+    return 0;
+}
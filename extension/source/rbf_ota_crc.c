@@ -0,0 +1,175 @@
+/**
+ * @file rbf_ota_crc.c
+ * @brief Incremental CRC32 of the firmware image during OTA streaming
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+#include <string.h>
+#include "rbf_ota_crc.h"
+
+typedef struct 
+{
+    rbf_ota_crc_state_t state;
+    rbf_ota_data_handle_t source;
+    bool ended;
+}ota_crc_t;
+
+static ota_crc_t s_crcs[RBF_OTA_TARGET_MAX];
+static RBF_ota_evt_callbacks_t s_hub_user_cbs;
+static RBF_subdev_ota_evt_callbacks_t s_subdev_user_cbs;
+
+/* Nibble table: 64 bytes of flash instead of 1KB for the byte table */
+static const uint32_t s_crc32_table[16] = {
+    0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC,
+    0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+    0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C,
+    0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C,
+};
+
+
+uint32_t rbf_crc32_update(uint32_t crc, const unsigned char* data, uint32_t len)
+{
+    crc = ~crc;
+    while (len--) {
+        crc ^= *data++;
+        crc = (crc >> 4) ^ s_crc32_table[crc & 0x0F];
+        crc = (crc >> 4) ^ s_crc32_table[crc & 0x0F];
+    }
+    return ~crc;
+}
+
+
+static void crc_feed(ota_crc_t* ctx, unsigned int offset, unsigned int size, const unsigned char* data)
+{
+    rbf_ota_crc_state_t* state = &ctx->state;
+    uint32_t skip;
+
+    /* Only the bytes following the covered range extend the CRC, retransmissions are ignored */
+    if (offset > state->offset || offset + size <= state->offset) {
+        return;
+    }
+
+    skip = state->offset - offset;
+    size -= skip;
+    if (state->fw_size && state->offset + size > state->fw_size) {
+        size = state->fw_size - state->offset;
+    }
+
+    state->crc = rbf_crc32_update(state->crc, data + skip, size);
+    state->offset += size;
+    state->complete = (state->fw_size != 0 && state->offset == state->fw_size);
+}
+
+
+static int crc_data_handle(rbf_ota_target_t target, unsigned int offset, unsigned int size, unsigned char* data)
+{
+    ota_crc_t* ctx = &s_crcs[target];
+    int ret;
+
+    if (ctx->source == NULL) {
+        return -1;
+    }
+
+    if (ctx->ended) {
+        rbf_ota_crc_reset(target, ctx->state.fw_size);
+    }
+
+    ret = ctx->source(offset, size, data);
+    if (ret == 0) {
+        crc_feed(ctx, offset, size, data);
+    }
+    return ret;
+}
+
+
+static int crc_hub_data_handle(unsigned int offset, unsigned int size, unsigned char* data)
+{
+    return crc_data_handle(RBF_OTA_TARGET_HUB, offset, size, data);
+}
+
+
+static int crc_hub_evt_handle(RBF_ota_evt_t evt, RBF_ota_status_t* status)
+{
+    if (evt == RBF_OTA_EVT_UPGRADE_COMPLETE || evt == RBF_OTA_EVT_UPGRADE_FAIL) {
+        s_crcs[RBF_OTA_TARGET_HUB].ended = true;
+    }
+
+    if (s_hub_user_cbs.rbf_ota_evt_handle == NULL) {
+        return 0;
+    }
+    return s_hub_user_cbs.rbf_ota_evt_handle(evt, status);
+}
+
+
+static int crc_subdev_data_handle(unsigned int offset, unsigned int size, unsigned char* data)
+{
+    return crc_data_handle(RBF_OTA_TARGET_SUBDEV, offset, size, data);
+}
+
+
+static int crc_subdev_evt_handle(RBF_subdev_ota_evt_t evt, RBF_subdev_ota_faild_response_t* responses, uint8_t response_count)
+{
+    s_crcs[RBF_OTA_TARGET_SUBDEV].ended = true;
+
+    if (s_subdev_user_cbs.rbf_subdev_ota_evt_handle == NULL) {
+        return 0;
+    }
+    return s_subdev_user_cbs.rbf_subdev_ota_evt_handle(evt, responses, response_count);
+}
+
+
+int rbf_ota_crc_wrap_hub(RBF_ota_evt_callbacks_t* cbs)
+{
+    if (cbs == NULL) {
+        return -1;
+    }
+
+    s_hub_user_cbs = *cbs;
+    s_crcs[RBF_OTA_TARGET_HUB].source = cbs->rbf_ota_request_upgrade_data_handle;
+    cbs->rbf_ota_request_upgrade_data_handle = crc_hub_data_handle;
+    cbs->rbf_ota_evt_handle = crc_hub_evt_handle;
+
+    return 0;
+}
+
+
+int rbf_ota_crc_wrap_subdev(RBF_subdev_ota_evt_callbacks_t* cbs)
+{
+    if (cbs == NULL) {
+        return -1;
+    }
+
+    s_subdev_user_cbs = *cbs;
+    s_crcs[RBF_OTA_TARGET_SUBDEV].source = cbs->rbf_subdev_ota_request_upgrade_data_handle;
+    cbs->rbf_subdev_ota_request_upgrade_data_handle = crc_subdev_data_handle;
+    cbs->rbf_subdev_ota_evt_handle = crc_subdev_evt_handle;
+
+    return 0;
+}
+
+
+int rbf_ota_crc_reset(rbf_ota_target_t target, uint32_t fw_size)
+{
+    if (target >= RBF_OTA_TARGET_MAX) {
+        return -1;
+    }
+
+    memset(&s_crcs[target].state, 0, sizeof(rbf_ota_crc_state_t));
+    s_crcs[target].state.fw_size = fw_size;
+    s_crcs[target].ended = false;
+    return 0;
+}
+
+
+int rbf_ota_crc_get(rbf_ota_target_t target, rbf_ota_crc_state_t* state)
+{
+    if (target >= RBF_OTA_TARGET_MAX || state == NULL) {
+        return -1;
+    }
+
+    *state = s_crcs[target].state;
+    return 0;
+}
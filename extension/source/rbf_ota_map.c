@@ -0,0 +1,121 @@
+/**
+ * @file rbf_ota_map.c
+ * @brief Memory-mapped firmware data source for OTA
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+#include <string.h>
+#include "rbf_ota_map.h"
+
+typedef struct 
+{
+    rbf_ota_map_source_t source;
+    const unsigned char* image;
+    uint32_t fw_size;
+}ota_map_t;
+
+static ota_map_t s_maps[RBF_OTA_TARGET_MAX];
+
+
+static int map_read(rbf_ota_target_t target, unsigned int offset, unsigned int size, unsigned char* data)
+{
+    uint32_t fw_size = s_maps[target].fw_size;
+
+    while (size > 0) {
+        unsigned int len = 0;
+        const unsigned char* ptr;
+
+        /* The last page runs past the image end, its tail is padded */
+        if (fw_size && offset >= fw_size) {
+            memset(data, 0, size);
+            break;
+        }
+
+        ptr = rbf_ota_map_get(target, offset, &len);
+
+        if (ptr == NULL || len == 0) {
+            return -1;
+        }
+        if (len > size) {
+            len = size;
+        }
+        memcpy(data, ptr, len);
+        offset += len;
+        data += len;
+        size -= len;
+    }
+
+    return 0;
+}
+
+
+int rbf_ota_map_set_source(rbf_ota_target_t target, const rbf_ota_map_source_t* source)
+{
+    if (target >= RBF_OTA_TARGET_MAX) {
+        return -1;
+    }
+
+    memset(&s_maps[target], 0, sizeof(ota_map_t));
+    if (source != NULL) {
+        s_maps[target].source = *source;
+        s_maps[target].fw_size = source->fw_size;
+    }
+    return 0;
+}
+
+
+int rbf_ota_map_set_image(rbf_ota_target_t target, const unsigned char* image, uint32_t fw_size)
+{
+    if (target >= RBF_OTA_TARGET_MAX || image == NULL || fw_size == 0) {
+        return -1;
+    }
+
+    memset(&s_maps[target], 0, sizeof(ota_map_t));
+    s_maps[target].image = image;
+    s_maps[target].fw_size = fw_size;
+    return 0;
+}
+
+
+const unsigned char* rbf_ota_map_get(rbf_ota_target_t target, unsigned int offset, unsigned int* len)
+{
+    ota_map_t* map;
+
+    if (target >= RBF_OTA_TARGET_MAX || len == NULL) {
+        return NULL;
+    }
+
+    map = &s_maps[target];
+    if (map->image != NULL) {
+        if (offset >= map->fw_size) {
+            return NULL;
+        }
+        *len = map->fw_size - offset;
+        return map->image + offset;
+    }
+
+    if (map->source.map != NULL && (map->fw_size == 0 || offset < map->fw_size)) {
+        const unsigned char* ptr = map->source.map(offset, len);
+
+        if (ptr != NULL && map->fw_size && *len > map->fw_size - offset) {
+            *len = map->fw_size - offset;
+        }
+        return ptr;
+    }
+    return NULL;
+}
+
+
+int rbf_ota_map_hub_data_handle(unsigned int offset, unsigned int size, unsigned char* data)
+{
+    return map_read(RBF_OTA_TARGET_HUB, offset, size, data);
+}
+
+
+int rbf_ota_map_subdev_data_handle(unsigned int offset, unsigned int size, unsigned char* data)
+{
+    return map_read(RBF_OTA_TARGET_SUBDEV, offset, size, data);
+}
@@ -0,0 +1,417 @@
+/**
+ * @file rbf_ota_stats.c
+ * @brief OTA throughput and ETA instrumentation
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+#include <string.h>
+#include "rbf_ota_stats.h"
+#include "rbf_mutex.h"
+#include "rbf_time.h"
+
+#define OTA_STATS_SUBDEV_MAX        (12)
+
+typedef struct 
+{
+    rbf_ota_stats_t stats;
+    rbf_ota_data_handle_t source;
+    rbf_time_t start_ms;
+    rbf_time_t last_return_ms;
+    uint32_t fetch_total_ms;
+    uint32_t link_total_ms;
+    uint32_t links;
+}ota_stats_t;
+
+static ota_stats_t s_stats[RBF_OTA_TARGET_MAX];
+static rbf_ota_stats_dev_t s_devs[OTA_STATS_SUBDEV_MAX];
+static uint8_t s_dev_count;
+static rbf_mutex_t s_stats_mutex;
+static rbf_ota_stats_evt_handle_t s_stats_evt_handle;
+static RBF_ota_evt_callbacks_t s_hub_user_cbs;
+static RBF_subdev_ota_evt_callbacks_t s_subdev_user_cbs;
+
+
+static void stats_update(ota_stats_t* ctx, rbf_time_t now)
+{
+    rbf_ota_stats_t* stats = &ctx->stats;
+    uint32_t elapsed_ms = (uint32_t)(now - ctx->start_ms);
+
+    stats->elapsed_s = elapsed_ms / 1000;
+    stats->fetch_avg_ms = stats->pages ? ctx->fetch_total_ms / stats->pages : 0;
+    stats->link_avg_ms = ctx->links ? ctx->link_total_ms / ctx->links : 0;
+    stats->bytes_per_s = elapsed_ms ? (uint32_t)((uint64_t)stats->bytes_transferred * 1000 / elapsed_ms) : 0;
+
+    if (stats->fw_size) {
+        uint32_t remaining = stats->fw_size > stats->bytes_transferred ? stats->fw_size - stats->bytes_transferred : 0;
+
+        stats->percent = (uint8_t)((uint64_t)(stats->fw_size - remaining) * 100 / stats->fw_size);
+        stats->eta_s = stats->bytes_per_s ? remaining / stats->bytes_per_s : 0;
+    }
+}
+
+
+static void stats_begin(rbf_ota_target_t target, uint32_t fw_size)
+{
+    ota_stats_t* ctx = &s_stats[target];
+
+    memset(&ctx->stats, 0, sizeof(rbf_ota_stats_t));
+    ctx->stats.upgrading = true;
+    ctx->stats.fw_size = fw_size;
+    ctx->fetch_total_ms = 0;
+    ctx->link_total_ms = 0;
+    ctx->links = 0;
+    rbf_time_get_ms(&ctx->start_ms);
+    ctx->last_return_ms = ctx->start_ms;
+}
+
+
+static void stats_emit(rbf_ota_target_t target, const rbf_ota_stats_t* stats)
+{
+    if (s_stats_evt_handle != NULL) {
+        s_stats_evt_handle(target, stats);
+    }
+}
+
+
+static int stats_data_handle(rbf_ota_target_t target, unsigned int offset, unsigned int size, unsigned char* data)
+{
+    ota_stats_t* ctx = &s_stats[target];
+    rbf_ota_stats_t snapshot;
+    rbf_time_t enter;
+    rbf_time_t leave;
+    uint32_t fetch_ms;
+    uint32_t link_ms;
+    uint8_t percent;
+    int ret;
+
+    if (ctx->source == NULL) {
+        return -1;
+    }
+
+    rbf_time_get_ms(&enter);
+    ret = ctx->source(offset, size, data);
+    rbf_time_get_ms(&leave);
+
+    fetch_ms = (uint32_t)(leave - enter);
+    link_ms = (uint32_t)(enter - ctx->last_return_ms);
+
+    rbf_mutex_lock(s_stats_mutex);
+    /*
+     * A request while no upgrade runs, or back at offset 0 after later pages, is a new upgrade
+     * started without rbf_ota_stats_*start(): the size is only kept for a restart.
+     */
+    if (!ctx->stats.upgrading || (offset == 0 && ctx->stats.bytes_transferred > size)) {
+        stats_begin(target, ctx->stats.upgrading ? ctx->stats.fw_size : 0);
+        ctx->start_ms = enter;
+        ctx->last_return_ms = enter;
+    }
+    percent = ctx->stats.percent;
+    ctx->stats.pages++;
+    ctx->stats.bytes_requested += size;
+    if (offset + size <= ctx->stats.bytes_transferred) {
+        ctx->stats.retransmitted_pages++;
+    } else {
+        ctx->stats.bytes_transferred = offset + size;
+    }
+
+    ctx->stats.fetch_last_ms = fetch_ms;
+    ctx->fetch_total_ms += fetch_ms;
+    if (fetch_ms > ctx->stats.fetch_max_ms) {
+        ctx->stats.fetch_max_ms = fetch_ms;
+    }
+
+    /* The first request follows the start command, not a page */
+    if (ctx->stats.pages > 1) {
+        ctx->stats.link_last_ms = link_ms;
+        ctx->link_total_ms += link_ms;
+        ctx->links++;
+        if (link_ms > ctx->stats.link_max_ms) {
+            ctx->stats.link_max_ms = link_ms;
+        }
+    }
+
+    ctx->last_return_ms = leave;
+    stats_update(ctx, leave);
+    snapshot = ctx->stats;
+    rbf_mutex_unlock(s_stats_mutex);
+
+    if (snapshot.percent != percent) {
+        stats_emit(target, &snapshot);
+    }
+
+    return ret;
+}
+
+
+static void stats_end(rbf_ota_target_t target)
+{
+    ota_stats_t* ctx = &s_stats[target];
+    rbf_ota_stats_t snapshot;
+    rbf_time_t now;
+
+    rbf_time_get_ms(&now);
+    rbf_mutex_lock(s_stats_mutex);
+    stats_update(ctx, now);
+    ctx->stats.upgrading = false;
+    snapshot = ctx->stats;
+    rbf_mutex_unlock(s_stats_mutex);
+
+    stats_emit(target, &snapshot);
+}
+
+
+static int stats_hub_data_handle(unsigned int offset, unsigned int size, unsigned char* data)
+{
+    return stats_data_handle(RBF_OTA_TARGET_HUB, offset, size, data);
+}
+
+
+static int stats_hub_evt_handle(RBF_ota_evt_t evt, RBF_ota_status_t* status)
+{
+    if (evt == RBF_OTA_EVT_ENTER_BOOTLOADER_SUCESS) {
+        /* An upgrade started with rbf_ota_start() directly */
+        rbf_mutex_lock(s_stats_mutex);
+        if (!s_stats[RBF_OTA_TARGET_HUB].stats.upgrading) {
+            stats_begin(RBF_OTA_TARGET_HUB, 0);
+        }
+        rbf_mutex_unlock(s_stats_mutex);
+    } else if (evt == RBF_OTA_EVT_UPGRADE_COMPLETE || evt == RBF_OTA_EVT_UPGRADE_FAIL
+        || evt == RBF_OTA_EVT_START_FAIL || evt == RBF_OTA_EVT_ENTER_BOOTLOADER_FAIL) {
+        stats_end(RBF_OTA_TARGET_HUB);
+    }
+
+    if (s_hub_user_cbs.rbf_ota_evt_handle == NULL) {
+        return 0;
+    }
+    return s_hub_user_cbs.rbf_ota_evt_handle(evt, status);
+}
+
+
+static int stats_subdev_data_handle(unsigned int offset, unsigned int size, unsigned char* data)
+{
+    return stats_data_handle(RBF_OTA_TARGET_SUBDEV, offset, size, data);
+}
+
+
+static const RBF_subdev_ota_faild_response_t* stats_response(uint8_t no, const RBF_subdev_ota_faild_response_t* responses,
+                                                             uint8_t response_count)
+{
+    uint8_t i;
+
+    for (i = 0; responses != NULL && i < response_count; i++) {
+        if (responses[i].devno == no) {
+            return &responses[i];
+        }
+    }
+    return NULL;
+}
+
+
+static int stats_subdev_evt_handle(RBF_subdev_ota_evt_t evt, RBF_subdev_ota_faild_response_t* responses, uint8_t response_count)
+{
+    bool timeout = evt == RBF_SUBDEV_OTA_EVT_UPGRADE_REQUEST_TIMEOUT && response_count > 0;
+    bool end = !timeout;
+    uint8_t ended = 0;
+    rbf_time_t now;
+    uint8_t i;
+
+    /* A request timeout listing devices only ends those, the others go on */
+    rbf_time_get_ms(&now);
+    rbf_mutex_lock(s_stats_mutex);
+    stats_update(&s_stats[RBF_OTA_TARGET_SUBDEV], now);
+    for (i = 0; i < s_dev_count; i++) {
+        rbf_ota_stats_dev_t* dev = &s_devs[i];
+        const RBF_subdev_ota_faild_response_t* response = stats_response(dev->no, responses, response_count);
+
+        if (dev->ended) {
+            ended++;
+            continue;
+        }
+        if (timeout && response == NULL) {
+            continue;
+        }
+        ended++;
+        dev->ended = true;
+        dev->elapsed_s = s_stats[RBF_OTA_TARGET_SUBDEV].stats.elapsed_s;
+        dev->failed = evt != RBF_SUBDEV_OTA_EVT_UPGRADE_COMPLETE || response != NULL;
+        if (response != NULL) {
+            dev->err_code = response->errorcode;
+        }
+    }
+    /* Without the device list of rbf_ota_stats_subdev_start() the upgrade ends with the wave */
+    if (timeout && s_dev_count > 0 && ended == s_dev_count) {
+        end = true;
+    }
+    rbf_mutex_unlock(s_stats_mutex);
+
+    if (end) {
+        stats_end(RBF_OTA_TARGET_SUBDEV);
+    }
+
+    if (s_subdev_user_cbs.rbf_subdev_ota_evt_handle == NULL) {
+        return 0;
+    }
+    return s_subdev_user_cbs.rbf_subdev_ota_evt_handle(evt, responses, response_count);
+}
+
+
+static int stats_init(void)
+{
+    if (s_stats_mutex == NULL) {
+        s_stats_mutex = rbf_mutex_create();
+    }
+    return s_stats_mutex != NULL ? 0 : -1;
+}
+
+
+int rbf_ota_stats_wrap_hub(RBF_ota_evt_callbacks_t* cbs)
+{
+    if (cbs == NULL || 0 != stats_init()) {
+        return -1;
+    }
+
+    s_hub_user_cbs = *cbs;
+    s_stats[RBF_OTA_TARGET_HUB].source = cbs->rbf_ota_request_upgrade_data_handle;
+    cbs->rbf_ota_request_upgrade_data_handle = stats_hub_data_handle;
+    cbs->rbf_ota_evt_handle = stats_hub_evt_handle;
+
+    return 0;
+}
+
+
+int rbf_ota_stats_wrap_subdev(RBF_subdev_ota_evt_callbacks_t* cbs)
+{
+    if (cbs == NULL || 0 != stats_init()) {
+        return -1;
+    }
+
+    s_subdev_user_cbs = *cbs;
+    s_stats[RBF_OTA_TARGET_SUBDEV].source = cbs->rbf_subdev_ota_request_upgrade_data_handle;
+    cbs->rbf_subdev_ota_request_upgrade_data_handle = stats_subdev_data_handle;
+    cbs->rbf_subdev_ota_evt_handle = stats_subdev_evt_handle;
+
+    return 0;
+}
+
+
+int rbf_ota_stats_set_evt_handle(rbf_ota_stats_evt_handle_t handle)
+{
+    s_stats_evt_handle = handle;
+    return 0;
+}
+
+
+int rbf_ota_stats_size_set(rbf_ota_target_t target, uint32_t fw_size)
+{
+    if (target >= RBF_OTA_TARGET_MAX || s_stats_mutex == NULL) {
+        return -1;
+    }
+
+    rbf_mutex_lock(s_stats_mutex);
+    s_stats[target].stats.fw_size = fw_size;
+    rbf_mutex_unlock(s_stats_mutex);
+
+    return 0;
+}
+
+
+/* The upgrade did not start: it is not upgrading, and no end is reported */
+static void stats_abort(rbf_ota_target_t target)
+{
+    rbf_mutex_lock(s_stats_mutex);
+    s_stats[target].stats.upgrading = false;
+    rbf_mutex_unlock(s_stats_mutex);
+}
+
+
+int rbf_ota_stats_start(uint32_t fw_size)
+{
+    int ret;
+
+    if (s_stats_mutex == NULL) {
+        return -1;
+    }
+
+    /* Begun first, the library may request data before returning */
+    rbf_mutex_lock(s_stats_mutex);
+    stats_begin(RBF_OTA_TARGET_HUB, fw_size);
+    rbf_mutex_unlock(s_stats_mutex);
+
+    ret = rbf_ota_start(fw_size);
+    if (ret != 0) {
+        stats_abort(RBF_OTA_TARGET_HUB);
+    }
+    return ret;
+}
+
+
+int rbf_ota_stats_subdev_start(uint8_t cat, uint8_t* no_list, uint8_t count, uint32_t fw_size)
+{
+    int ret;
+    uint8_t i;
+
+    if (s_stats_mutex == NULL || no_list == NULL || count > OTA_STATS_SUBDEV_MAX) {
+        return -1;
+    }
+
+    rbf_mutex_lock(s_stats_mutex);
+    stats_begin(RBF_OTA_TARGET_SUBDEV, fw_size);
+    memset(s_devs, 0, sizeof(s_devs));
+    for (i = 0; i < count; i++) {
+        s_devs[i].no = no_list[i];
+    }
+    s_dev_count = count;
+    rbf_mutex_unlock(s_stats_mutex);
+
+    ret = rbf_subdev_ota_start(cat, no_list, count, fw_size);
+    if (ret != 0) {
+        stats_abort(RBF_OTA_TARGET_SUBDEV);
+    }
+    return ret;
+}
+
+
+int rbf_ota_stats_get(rbf_ota_target_t target, rbf_ota_stats_t* stats)
+{
+    rbf_time_t now;
+
+    if (target >= RBF_OTA_TARGET_MAX || stats == NULL || s_stats_mutex == NULL) {
+        return -1;
+    }
+
+    rbf_time_get_ms(&now);
+    rbf_mutex_lock(s_stats_mutex);
+    if (s_stats[target].stats.upgrading) {
+        stats_update(&s_stats[target], now);
+    }
+    *stats = s_stats[target].stats;
+    rbf_mutex_unlock(s_stats_mutex);
+
+    return 0;
+}
+
+
+int rbf_ota_stats_subdev_device_get(uint8_t no, rbf_ota_stats_dev_t* dev)
+{
+    int ret = -1;
+    uint8_t i;
+
+    if (dev == NULL || s_stats_mutex == NULL) {
+        return -1;
+    }
+
+    rbf_mutex_lock(s_stats_mutex);
+    for (i = 0; i < s_dev_count; i++) {
+        if (s_devs[i].no == no) {
+            *dev = s_devs[i];
+            ret = 0;
+            break;
+        }
+    }
+    rbf_mutex_unlock(s_stats_mutex);
+
+    return ret;
+}
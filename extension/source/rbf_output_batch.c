@@ -0,0 +1,386 @@
+/**
+ * @file rbf_output_batch.c
+ * @brief Batch control of relays, wall switches and smartplugs with output status confirmation
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+#include <string.h>
+#include <stdbool.h>
+#include "rbf_output_batch.h"
+#include "rbf_observer.h"
+#include "rbf_mutex.h"
+#include "rbf_time.h"
+
+#define BATCH_STATE_UNKNOWN     (0xFF)
+#define BATCH_STATE_TYPES       (3)
+#define BATCH_STATE_WORDS       (256 / 32)
+
+static rbf_mutex_t s_batch_mutex;
+static rbf_output_batch_dev_t s_devs[RBF_OUTPUT_BATCH_MAX];
+static rbf_time_t s_sent_ms[RBF_OUTPUT_BATCH_MAX];
+static rbf_time_t s_first_ms[RBF_OUTPUT_BATCH_MAX];
+static uint8_t s_expect[RBF_OUTPUT_BATCH_MAX];     /**< Output state confirming a toggle, BATCH_STATE_UNKNOWN if none */
+static uint32_t s_known[BATCH_STATE_TYPES][BATCH_STATE_WORDS];     /**< Output status received since init */
+static uint32_t s_onoff[BATCH_STATE_TYPES][BATCH_STATE_WORDS];     /**< Last received output state */
+static uint8_t s_count;
+static bool s_running;
+static rbf_output_batch_action_t s_action;
+static rbf_output_batch_cfg_t s_cfg;
+static rbf_output_batch_done_t s_done;
+
+
+typedef struct
+{
+    RBF_dev_type_t type;
+    uint8_t no;
+    rbf_output_batch_action_t action;
+}batch_send_t;
+
+
+static int batch_ctrl(const batch_send_t* send)
+{
+    switch (send->type) {
+    case RBF_DEV_TYPE_RELAY: {
+        rbf_relay_ctrl_t ctrl;
+        ctrl.action = send->action == RBF_OUTPUT_BATCH_ON ? RBF_RELAY_ACTION_ON
+                      : (send->action == RBF_OUTPUT_BATCH_OFF ? RBF_RELAY_ACTION_OFF : RBF_RELAY_ACTION_TOOGLE);
+        return rbf_relay_ctrl(send->no, &ctrl);
+    }
+    case RBF_DEV_TYPE_WALL_SWITCH: {
+        rbf_wall_switch_ctrl_t ctrl;
+        ctrl.action = send->action == RBF_OUTPUT_BATCH_ON ? RBF_WALL_SWITCH_ACTION_ON
+                      : (send->action == RBF_OUTPUT_BATCH_OFF ? RBF_WALL_SWITCH_ACTION_OFF : RBF_WALL_SWITCH_ACTION_TOOGLE);
+        return rbf_wall_switch_ctrl(send->no, &ctrl);
+    }
+    case RBF_DEV_TYPE_SMART_PLUG: {
+        rbf_smartplug_ctrl_t ctrl;
+        ctrl.action = send->action == RBF_OUTPUT_BATCH_ON ? RBF_SMARTPLUG_ACTION_ON
+                      : (send->action == RBF_OUTPUT_BATCH_OFF ? RBF_SMARTPLUG_ACTION_OFF : RBF_SMARTPLUG_ACTION_TOOGLE);
+        ctrl.lock = 0;
+        return rbf_smartplug_ctrl(send->no, &ctrl);
+    }
+    default:
+        return -1;
+    }
+}
+
+
+static int batch_state_index(RBF_dev_type_t type)
+{
+    switch (type) {
+    case RBF_DEV_TYPE_RELAY:
+        return 0;
+    case RBF_DEV_TYPE_WALL_SWITCH:
+        return 1;
+    case RBF_DEV_TYPE_SMART_PLUG:
+        return 2;
+    default:
+        return -1;
+    }
+}
+
+
+/* Last known output state of a device, BATCH_STATE_UNKNOWN if none */
+static uint8_t batch_state_get(RBF_dev_type_t type, uint8_t no)
+{
+    int index = batch_state_index(type);
+    uint32_t mask = 1UL << (no % 32);
+
+    if (index < 0 || (s_known[index][no / 32] & mask) == 0) {
+        return BATCH_STATE_UNKNOWN;
+    }
+    return (s_onoff[index][no / 32] & mask) ? 1 : 0;
+}
+
+
+static void batch_state_set(RBF_dev_type_t type, uint8_t no, uint8_t onoff)
+{
+    int index = batch_state_index(type);
+    uint32_t mask = 1UL << (no % 32);
+
+    if (index < 0) {
+        return;
+    }
+    s_known[index][no / 32] |= mask;
+    if (onoff) {
+        s_onoff[index][no / 32] |= mask;
+    } else {
+        s_onoff[index][no / 32] &= ~mask;
+    }
+}
+
+
+static int batch_observer(const rbf_observer_msg_t* msg, void* arg)
+{
+    uint8_t onoff;
+    uint8_t i;
+
+    (void)arg;
+    if (msg->msg != RBF_OBSERVER_MSG_OUTPUT_STATUS || msg->payload == NULL || s_batch_mutex == NULL) {
+        return RBF_OBSERVER_PASS;
+    }
+
+    switch (msg->type) {
+    case RBF_DEV_TYPE_RELAY:
+        onoff = ((const rbf_relay_output_status_t*)msg->payload)->onoff;
+        break;
+    case RBF_DEV_TYPE_WALL_SWITCH:
+        onoff = ((const rbf_wall_switch_output_status_t*)msg->payload)->onoff;
+        break;
+    case RBF_DEV_TYPE_SMART_PLUG:
+        onoff = ((const rbf_smartplug_output_status_t*)msg->payload)->onoff;
+        break;
+    default:
+        return RBF_OBSERVER_PASS;
+    }
+
+    rbf_mutex_lock(s_batch_mutex);
+    batch_state_set(msg->type, msg->id.no, onoff);
+
+    /* A status with the previous output state does not confirm the control */
+    if (!s_running || (s_action == RBF_OUTPUT_BATCH_ON && !onoff) || (s_action == RBF_OUTPUT_BATCH_OFF && onoff)) {
+        rbf_mutex_unlock(s_batch_mutex);
+        return RBF_OBSERVER_PASS;
+    }
+
+    for (i = 0; i < s_count; i++) {
+        rbf_output_batch_dev_t* dev = &s_devs[i];
+
+        if (dev->no == msg->id.no && dev->type == msg->type && dev->state == RBF_OUTPUT_BATCH_SENT) {
+            if (s_action == RBF_OUTPUT_BATCH_TOGGLE && s_expect[i] != BATCH_STATE_UNKNOWN && s_expect[i] != (onoff ? 1 : 0)) {
+                break;
+            }
+            dev->state = RBF_OUTPUT_BATCH_CONFIRMED;
+            dev->latency_ms = (uint32_t)(msg->time - s_first_ms[i]);
+            break;
+        }
+    }
+    rbf_mutex_unlock(s_batch_mutex);
+
+    return RBF_OBSERVER_PASS;
+}
+
+
+int rbf_output_batch_init(void)
+{
+    if (s_batch_mutex != NULL) {
+        return 0;
+    }
+
+    s_batch_mutex = rbf_mutex_create();
+    if (s_batch_mutex == NULL) {
+        return -1;
+    }
+    return rbf_observer_add(batch_observer, NULL);
+}
+
+
+int rbf_output_batch_start(const rbf_output_batch_dev_t* devs, uint8_t count, rbf_output_batch_action_t action,
+                           const rbf_output_batch_cfg_t* cfg, rbf_output_batch_done_t done)
+{
+    uint8_t i;
+
+    if (s_batch_mutex == NULL || devs == NULL || count == 0 || count > RBF_OUTPUT_BATCH_MAX
+        || action > RBF_OUTPUT_BATCH_TOGGLE) {
+        return -1;
+    }
+
+    for (i = 0; i < count; i++) {
+        if (devs[i].type != RBF_DEV_TYPE_RELAY && devs[i].type != RBF_DEV_TYPE_WALL_SWITCH
+            && devs[i].type != RBF_DEV_TYPE_SMART_PLUG) {
+            return -1;
+        }
+    }
+
+    rbf_mutex_lock(s_batch_mutex);
+    if (s_running) {
+        rbf_mutex_unlock(s_batch_mutex);
+        return -1;
+    }
+
+    for (i = 0; i < count; i++) {
+        s_devs[i].type = devs[i].type;
+        s_devs[i].no = devs[i].no;
+        s_devs[i].state = RBF_OUTPUT_BATCH_PENDING;
+        s_devs[i].tries = 0;
+        s_devs[i].latency_ms = 0;
+    }
+    s_count = count;
+    s_action = action;
+    memset(&s_cfg, 0, sizeof(s_cfg));
+    if (cfg != NULL) {
+        s_cfg = *cfg;
+    }
+    if (s_cfg.window == 0) {
+        s_cfg.window = RBF_OUTPUT_BATCH_WINDOW_DEFAULT;
+    }
+    if (s_cfg.timeout_ms == 0) {
+        s_cfg.timeout_ms = RBF_OUTPUT_BATCH_TIMEOUT_DEFAULT;
+    }
+    s_done = done;
+    s_running = true;
+    rbf_mutex_unlock(s_batch_mutex);
+
+    return 0;
+}
+
+
+/* Action sent to a device: a toggle is sent as the absolute state it expects when that is known */
+static rbf_output_batch_action_t batch_send_action(uint8_t i)
+{
+    if (s_action != RBF_OUTPUT_BATCH_TOGGLE || s_expect[i] == BATCH_STATE_UNKNOWN) {
+        return s_action;
+    }
+    return s_expect[i] ? RBF_OUTPUT_BATCH_ON : RBF_OUTPUT_BATCH_OFF;
+}
+
+
+/* Ends the batch if every device is confirmed or failed and copies the results to report */
+static rbf_output_batch_done_t batch_complete(rbf_output_batch_dev_t* result, uint8_t* count)
+{
+    uint8_t i;
+
+    for (i = 0; i < s_count; i++) {
+        if (s_devs[i].state == RBF_OUTPUT_BATCH_PENDING || s_devs[i].state == RBF_OUTPUT_BATCH_SENT) {
+            return NULL;
+        }
+    }
+
+    s_running = false;
+    memcpy(result, s_devs, sizeof(rbf_output_batch_dev_t) * s_count);
+    *count = s_count;
+    return s_done;
+}
+
+
+int rbf_output_batch_poll(void)
+{
+    rbf_output_batch_dev_t result[RBF_OUTPUT_BATCH_MAX];
+    batch_send_t to_send[RBF_OUTPUT_BATCH_MAX];
+    uint8_t to_send_index[RBF_OUTPUT_BATCH_MAX];
+    uint8_t send_count = 0;
+    uint8_t result_count = 0;
+    uint8_t outstanding = 0;
+    rbf_output_batch_done_t done = NULL;
+    rbf_time_t now;
+    uint8_t i;
+
+    if (s_batch_mutex == NULL) {
+        return 0;
+    }
+
+    rbf_time_get_ms(&now);
+    rbf_mutex_lock(s_batch_mutex);
+    if (!s_running) {
+        rbf_mutex_unlock(s_batch_mutex);
+        return 0;
+    }
+
+    for (i = 0; i < s_count; i++) {
+        rbf_output_batch_dev_t* dev = &s_devs[i];
+
+        /* A toggle of unknown state is not repeated: a lost status would make it toggle back */
+        if (dev->state == RBF_OUTPUT_BATCH_SENT && now - s_sent_ms[i] >= s_cfg.timeout_ms) {
+            dev->state = (dev->tries > s_cfg.retries || batch_send_action(i) == RBF_OUTPUT_BATCH_TOGGLE)
+                         ? RBF_OUTPUT_BATCH_FAILED : RBF_OUTPUT_BATCH_PENDING;
+        }
+        if (dev->state == RBF_OUTPUT_BATCH_SENT) {
+            outstanding++;
+        }
+    }
+
+    /* Keep up to window devices in flight instead of waiting for each confirmation */
+    for (i = 0; i < s_count && outstanding < s_cfg.window; i++) {
+        rbf_output_batch_dev_t* dev = &s_devs[i];
+
+        if (dev->state != RBF_OUTPUT_BATCH_PENDING) {
+            continue;
+        }
+        dev->state = RBF_OUTPUT_BATCH_SENT;
+        if (dev->tries++ == 0) {
+            uint8_t state = batch_state_get(dev->type, dev->no);
+
+            s_first_ms[i] = now;
+            s_expect[i] = state == BATCH_STATE_UNKNOWN ? BATCH_STATE_UNKNOWN : !state;
+        }
+        s_sent_ms[i] = now;
+        to_send[send_count].type = dev->type;
+        to_send[send_count].no = dev->no;
+        to_send[send_count].action = batch_send_action(i);
+        to_send_index[send_count++] = i;
+        outstanding++;
+    }
+    rbf_mutex_unlock(s_batch_mutex);
+
+    for (i = 0; i < send_count; i++) {
+        if (0 != batch_ctrl(&to_send[i])) {
+            /* Treated as a timeout by the next poll */
+            rbf_mutex_lock(s_batch_mutex);
+            s_sent_ms[to_send_index[i]] = now - s_cfg.timeout_ms;
+            rbf_mutex_unlock(s_batch_mutex);
+        }
+    }
+
+    rbf_mutex_lock(s_batch_mutex);
+    if (s_running) {
+        done = batch_complete(result, &result_count);
+    }
+    rbf_mutex_unlock(s_batch_mutex);
+
+    if (done != NULL) {
+        done(result, result_count);
+    }
+    return send_count;
+}
+
+
+int rbf_output_batch_cancel(void)
+{
+    rbf_output_batch_dev_t result[RBF_OUTPUT_BATCH_MAX];
+    rbf_output_batch_done_t done;
+    uint8_t result_count;
+    uint8_t i;
+
+    if (s_batch_mutex == NULL) {
+        return -1;
+    }
+
+    rbf_mutex_lock(s_batch_mutex);
+    if (!s_running) {
+        rbf_mutex_unlock(s_batch_mutex);
+        return -1;
+    }
+
+    for (i = 0; i < s_count; i++) {
+        if (s_devs[i].state != RBF_OUTPUT_BATCH_CONFIRMED) {
+            s_devs[i].state = RBF_OUTPUT_BATCH_FAILED;
+        }
+    }
+    done = batch_complete(result, &result_count);
+    rbf_mutex_unlock(s_batch_mutex);
+
+    if (done != NULL) {
+        done(result, result_count);
+    }
+    return 0;
+}
+
+
+int rbf_output_batch_result_get(rbf_output_batch_dev_t* devs, uint8_t max_count)
+{
+    uint8_t count;
+
+    if (s_batch_mutex == NULL || devs == NULL) {
+        return 0;
+    }
+
+    rbf_mutex_lock(s_batch_mutex);
+    count = s_count < max_count ? s_count : max_count;
+    memcpy(devs, s_devs, sizeof(rbf_output_batch_dev_t) * count);
+    rbf_mutex_unlock(s_batch_mutex);
+
+    return count;
+}
@@ -0,0 +1,399 @@
+/**
+ * @file rbf_rule.c
+ * @brief Local automation rules evaluated in the rbfsdk thread
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+#include <string.h>
+#include <stdbool.h>
+#include "rbf_rule.h"
+#include "rbf_observer.h"
+#include "rbf_mem.h"
+#include "rbf_mutex.h"
+
+#define RULE_INDEX_SIZE         (RBF_DEV_TYPE_UNKNOW * RBF_RULE_TRIG_MAX)
+#define RULE_STATE_TYPES        (6)         /**< Device types reporting an alarm or tamper status */
+#define RULE_STATE_WORDS        (256 / 32)
+
+typedef struct
+{
+    uint8_t no;
+    uint8_t key;
+    uint8_t action;
+    uint8_t consume;
+    uint32_t modes;
+    uint8_t* targets;
+    uint8_t target_count;
+    union
+    {
+        RBF_sounder_param_t sounder;
+        RBF_indoor_siren_param_t indoor_siren;
+        rbf_relay_ctrl_t relay;
+        rbf_smartplug_ctrl_t smartplug;
+        rbf_wall_switch_ctrl_t wall_switch;
+    }param;
+}rule_compiled_t;
+
+static rbf_mutex_t s_rule_mutex;
+static rule_compiled_t* s_rules;
+static uint16_t s_index[RULE_INDEX_SIZE + 1];  /**< Rules of (type, trigger) are s_rules[s_index[i]..s_index[i + 1]) */
+static uint32_t s_generation;                  /**< Incremented on every table replacement */
+static uint8_t s_mode;
+static rbf_rule_stats_t s_stats;
+static uint32_t s_known[RULE_STATE_TYPES][RULE_STATE_WORDS];   /**< Status reported since init */
+static uint32_t s_alarm[RULE_STATE_TYPES][RULE_STATE_WORDS];   /**< Last reported alarm status */
+static uint32_t s_tamper[RULE_STATE_TYPES][RULE_STATE_WORDS];  /**< Last reported tamper status */
+
+
+static uint16_t rule_slot(RBF_dev_type_t type, rbf_rule_trigger_t trigger)
+{
+    return (uint16_t)(type * RBF_RULE_TRIG_MAX + trigger);
+}
+
+
+static int rule_do(rule_compiled_t* rule)
+{
+    int ret = 0;
+    uint8_t i;
+
+    switch (rule->action) {
+    case RBF_RULE_ACTION_SOUNDER:
+        return rbf_sounder_boardcast_control(rule->targets, rule->target_count, &rule->param.sounder);
+    case RBF_RULE_ACTION_INDOOR_SIREN:
+        return rbf_indoor_siren_boardcast_control(rule->targets, rule->target_count, &rule->param.indoor_siren);
+    case RBF_RULE_ACTION_RELAY:
+        for (i = 0; i < rule->target_count; i++) {
+            ret |= rbf_relay_ctrl(rule->targets[i], &rule->param.relay);
+        }
+        return ret;
+    case RBF_RULE_ACTION_SMARTPLUG:
+        for (i = 0; i < rule->target_count; i++) {
+            ret |= rbf_smartplug_ctrl(rule->targets[i], &rule->param.smartplug);
+        }
+        return ret;
+    case RBF_RULE_ACTION_WALL_SWITCH:
+        for (i = 0; i < rule->target_count; i++) {
+            ret |= rbf_wall_switch_ctrl(rule->targets[i], &rule->param.wall_switch);
+        }
+        return ret;
+    default:
+        return -1;
+    }
+}
+
+
+static bool rule_match(const rule_compiled_t* rule, uint8_t no, rbf_rule_trigger_t trigger, uint8_t key)
+{
+    return (rule->no == RBF_RULE_ANY_NO || rule->no == no)
+           && (trigger != RBF_RULE_TRIG_KEY || rule->key == RBF_RULE_ANY_KEY || rule->key == key)
+           && (rule->modes == 0 || (rule->modes & (1UL << s_mode)) != 0);
+}
+
+
+/**
+ * Each matched rule is copied with its targets under the lock and done after unlocking, so the
+ * control calls never run under s_rule_mutex. A table replaced meanwhile ends the scan.
+ */
+static bool rule_fire(RBF_dev_type_t type, uint8_t no, rbf_rule_trigger_t trigger, uint8_t key)
+{
+    uint16_t slot = rule_slot(type, trigger);
+    uint8_t targets[RBF_RULE_TARGETS_MAX];
+    rule_compiled_t rule;
+    bool consume = false;
+    uint32_t generation;
+    uint16_t i;
+    int ret;
+
+    rbf_mutex_lock(s_rule_mutex);
+    generation = s_generation;
+    for (i = s_index[slot]; generation == s_generation && i < s_index[slot + 1]; i++) {
+        if (!rule_match(&s_rules[i], no, trigger, key)) {
+            continue;
+        }
+
+        rule = s_rules[i];
+        memcpy(targets, rule.targets, rule.target_count);
+        rule.targets = targets;
+        s_stats.fired++;
+        consume |= rule.consume;
+        rbf_mutex_unlock(s_rule_mutex);
+
+        ret = rule_do(&rule);
+
+        rbf_mutex_lock(s_rule_mutex);
+        if (0 != ret) {
+            s_stats.failed++;
+        }
+    }
+    rbf_mutex_unlock(s_rule_mutex);
+
+    return consume;
+}
+
+
+static int rule_state_index(RBF_dev_type_t type)
+{
+    switch (type) {
+    case RBF_DEV_TYPE_MC:
+        return 0;
+    case RBF_DEV_TYPE_PIR:
+        return 1;
+    case RBF_DEV_TYPE_WATERT_LEAK:
+        return 2;
+    case RBF_DEV_TYPE_SMOKE:
+        return 3;
+    case RBF_DEV_TYPE_TEMP_HUMI:
+        return 4;
+    case RBF_DEV_TYPE_LED_KEYPAD:
+        return 5;
+    default:
+        return -1;
+    }
+}
+
+
+/* Set a state bit and return its previous value */
+static bool rule_state_set(uint32_t* map, uint8_t no, bool on)
+{
+    uint32_t mask = 1UL << (no % 32);
+    bool prev = (map[no / 32] & mask) != 0;
+
+    if (on) {
+        map[no / 32] |= mask;
+    } else {
+        map[no / 32] &= ~mask;
+    }
+    return prev;
+}
+
+
+/**
+ * Status reports repeat the current levels: triggers fire on a change from the last reported
+ * status only. The first report of a device fires its alarm and tamper but no alarm clear.
+ */
+static uint8_t rule_status_edges(RBF_dev_type_t type, uint8_t no, bool has_alarm, bool alarm, bool tamper,
+                                 rbf_rule_trigger_t triggers[2])
+{
+    int index = rule_state_index(type);
+    uint8_t count = 0;
+    bool known;
+    bool prev_alarm;
+    bool prev_tamper;
+
+    if (index < 0) {
+        return 0;
+    }
+
+    known = rule_state_set(s_known[index], no, true);
+    prev_alarm = rule_state_set(s_alarm[index], no, alarm);
+    prev_tamper = rule_state_set(s_tamper[index], no, tamper);
+
+    if (has_alarm && (known ? alarm != prev_alarm : alarm)) {
+        triggers[count++] = alarm ? RBF_RULE_TRIG_ALARM : RBF_RULE_TRIG_ALARM_CLEAR;
+    }
+    if (tamper && !(known && prev_tamper)) {
+        triggers[count++] = RBF_RULE_TRIG_TAMPER;
+    }
+    return count;
+}
+
+
+/**
+ * Translate a device message into up to two triggers
+ */
+static uint8_t rule_triggers(const rbf_observer_msg_t* msg, rbf_rule_trigger_t triggers[2], uint8_t* key)
+{
+    uint8_t count = 0;
+
+    if (msg->msg == RBF_OBSERVER_MSG_INPUT_EVT) {
+        if ((msg->type == RBF_DEV_TYPE_PIR && msg->value == RBF_PIR_INPUT_EVT_ALARM)
+            || (msg->type == RBF_DEV_TYPE_FIXED_PA && msg->value == RBF_EMERGENCY_BUTTON_INPUT_EVT_ALARM)) {
+            triggers[count++] = RBF_RULE_TRIG_ALARM;
+        }
+    } else if (msg->msg == RBF_OBSERVER_MSG_ALARM && msg->type == RBF_DEV_TYPE_LED_KEYPAD && msg->payload != NULL) {
+        const rbf_keypad_alarm_status_t* status = msg->payload;
+        bool alarm = status->emergency_alarm || status->fire_alarm || status->medical_alarm;
+        count = rule_status_edges(msg->type, msg->id.no, true, alarm, status->tamper, triggers);
+    } else if (msg->msg == RBF_OBSERVER_MSG_KEY && msg->type == RBF_DEV_TYPE_KEYFOB) {
+        *key = (uint8_t)msg->value;
+        triggers[count++] = RBF_RULE_TRIG_KEY;
+    } else if (msg->msg == RBF_OBSERVER_MSG_INPUT_STATUS && msg->payload != NULL) {
+        switch (msg->type) {
+        case RBF_DEV_TYPE_MC: {
+            const rbf_magnetic_input_status_t* status = msg->payload;
+            count = rule_status_edges(msg->type, msg->id.no, true, status->alarm, status->tamper, triggers);
+            break;
+        }
+        case RBF_DEV_TYPE_PIR: {
+            const rbf_pir_input_status_t* status = msg->payload;
+            count = rule_status_edges(msg->type, msg->id.no, false, false, status->tamper, triggers);
+            break;
+        }
+        case RBF_DEV_TYPE_SMOKE: {
+            const rbf_smoke_input_status_t* status = msg->payload;
+            count = rule_status_edges(msg->type, msg->id.no, true, status->alarm, false, triggers);
+            break;
+        }
+        case RBF_DEV_TYPE_WATERT_LEAK: {
+            const rbf_water_leak_input_status_t* status = msg->payload;
+            count = rule_status_edges(msg->type, msg->id.no, true, status->alarm, false, triggers);
+            break;
+        }
+        case RBF_DEV_TYPE_TEMP_HUMI: {
+            const rbf_temp_humi_status_t* status = msg->payload;
+            bool alarm = status->over_temp_alarm || status->low_temp_alarm
+                         || status->over_humi_alarm || status->low_humi_alarm;
+            count = rule_status_edges(msg->type, msg->id.no, true, alarm, false, triggers);
+            break;
+        }
+        default:
+            break;
+        }
+    }
+
+    return count;
+}
+
+
+static int rule_observer(const rbf_observer_msg_t* msg, void* arg)
+{
+    rbf_rule_trigger_t triggers[2];
+    uint8_t key = 0;
+    uint8_t count;
+    bool consume = false;
+    uint8_t i;
+
+    (void)arg;
+    if (s_rules == NULL || msg->type >= RBF_DEV_TYPE_UNKNOW) {
+        return RBF_OBSERVER_PASS;
+    }
+
+    rbf_mutex_lock(s_rule_mutex);
+    count = rule_triggers(msg, triggers, &key);
+    if (count) {
+        s_stats.messages++;
+    }
+    rbf_mutex_unlock(s_rule_mutex);
+
+    for (i = 0; i < count; i++) {
+        consume |= rule_fire(msg->type, msg->id.no, triggers[i], key);
+    }
+
+    return consume ? RBF_OBSERVER_DROP : RBF_OBSERVER_PASS;
+}
+
+
+int rbf_rule_init(void)
+{
+    if (s_rule_mutex != NULL) {
+        return 0;
+    }
+
+    s_rule_mutex = rbf_mutex_create();
+    if (s_rule_mutex == NULL) {
+        return -1;
+    }
+    return rbf_observer_add(rule_observer, NULL);
+}
+
+
+int rbf_rule_load(const rbf_rule_t* rules, uint16_t count)
+{
+    uint16_t index[RULE_INDEX_SIZE + 1];
+    uint16_t fill[RULE_INDEX_SIZE];
+    rule_compiled_t* compiled = NULL;
+    rule_compiled_t* old;
+    uint8_t* targets;
+    uint32_t target_total = 0;
+    uint16_t i;
+
+    if (s_rule_mutex == NULL || count > RBF_RULE_MAX || (count && rules == NULL)) {
+        return -1;
+    }
+
+    memset(index, 0, sizeof(index));
+    for (i = 0; i < count; i++) {
+        const rbf_rule_t* rule = &rules[i];
+
+        if (rule->type >= RBF_DEV_TYPE_UNKNOW || rule->trigger >= RBF_RULE_TRIG_MAX
+            || rule->action > RBF_RULE_ACTION_WALL_SWITCH || rule->target_count == 0
+            || rule->target_count > RBF_RULE_TARGETS_MAX || rule->targets == NULL) {
+            return -1;
+        }
+        index[rule_slot(rule->type, rule->trigger) + 1]++;
+        target_total += rule->target_count;
+    }
+
+    if (count) {
+        /* One block: compiled rules followed by their targets */
+        compiled = rbf_malloc(sizeof(rule_compiled_t) * count + target_total);
+        if (compiled == NULL) {
+            return -1;
+        }
+    }
+
+    /* Counting sort by (type, trigger) */
+    for (i = 0; i < RULE_INDEX_SIZE; i++) {
+        index[i + 1] += index[i];
+        fill[i] = index[i];
+    }
+
+    targets = (uint8_t*)(compiled + count);
+    for (i = 0; i < count; i++) {
+        const rbf_rule_t* rule = &rules[i];
+        rule_compiled_t* dst = &compiled[fill[rule_slot(rule->type, rule->trigger)]++];
+
+        dst->no = rule->no;
+        dst->key = rule->key;
+        dst->action = (uint8_t)rule->action;
+        dst->consume = rule->consume ? 1 : 0;
+        dst->modes = rule->modes;
+        memcpy(&dst->param, &rule->param, sizeof(dst->param));
+        dst->targets = targets;
+        dst->target_count = rule->target_count;
+        memcpy(targets, rule->targets, rule->target_count);
+        targets += rule->target_count;
+    }
+
+    rbf_mutex_lock(s_rule_mutex);
+    old = s_rules;
+    s_rules = compiled;
+    memcpy(s_index, index, sizeof(s_index));
+    s_generation++;
+    rbf_mutex_unlock(s_rule_mutex);
+
+    if (old != NULL) {
+        rbf_free(old);
+    }
+    return 0;
+}
+
+
+int rbf_rule_mode_set(uint8_t mode)
+{
+    if (mode >= 32 || s_rule_mutex == NULL) {
+        return -1;
+    }
+
+    rbf_mutex_lock(s_rule_mutex);
+    s_mode = mode;
+    rbf_mutex_unlock(s_rule_mutex);
+    return 0;
+}
+
+
+int rbf_rule_stats_get(rbf_rule_stats_t* stats)
+{
+    if (stats == NULL || s_rule_mutex == NULL) {
+        return -1;
+    }
+
+    rbf_mutex_lock(s_rule_mutex);
+    *stats = s_stats;
+    rbf_mutex_unlock(s_rule_mutex);
+
+    return 0;
+}
@@ -0,0 +1,289 @@
+/**
+ * @file rbf_rxq.c
+ * @brief Deferred receive queue: sub-device messages are delivered from the application thread, heartbeats are shed first when full
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+#include <string.h>
+#include <stdbool.h>
+#include "rbf_rxq.h"
+#include "rbf_mutex.h"
+#include "rbf_mem.h"
+#include "rbf_time.h"
+
+typedef struct
+{
+    bool used;
+    rbf_rxq_class_t cls;
+    uint32_t seq;               /**< Arrival order */
+    rbf_observer_msg_t msg;
+    rbf_observer_payload_t payload;
+}rxq_entry_t;
+
+typedef struct rxq_extra
+{
+    struct rxq_extra* next;
+    rxq_entry_t entry;
+}rxq_extra_t;
+
+static rbf_mutex_t s_rxq_mutex;
+static rxq_entry_t s_entries[RBF_RXQ_MAX];
+static rxq_extra_t* s_extra_head;      /**< Alarms beyond RBF_RXQ_MAX, oldest first */
+static rxq_extra_t* s_extra_tail;
+static uint32_t s_seq;
+static rbf_rxq_stats_t s_stats;
+static uint64_t s_latency_total_ms[RBF_RXQ_CLASS_MAX];
+
+
+static void rxq_release(rxq_entry_t* entry)
+{
+    entry->used = false;
+    s_stats.classes[entry->cls].pending--;
+    s_stats.pending--;
+}
+
+
+/* Oldest message of the lowest class below RBF_RXQ_ALARM and not above cls */
+static rxq_entry_t* rxq_victim(rbf_rxq_class_t cls)
+{
+    rxq_entry_t* victim = NULL;
+    uint8_t i;
+
+    for (i = 0; i < RBF_RXQ_MAX; i++) {
+        rxq_entry_t* entry = &s_entries[i];
+
+        if (!entry->used || entry->cls == RBF_RXQ_ALARM || entry->cls > cls) {
+            continue;
+        }
+        if (victim == NULL || entry->cls < victim->cls || (entry->cls == victim->cls && (int32_t)(entry->seq - victim->seq) < 0)) {
+            victim = entry;
+        }
+    }
+    return victim;
+}
+
+
+static rxq_entry_t* rxq_free_entry(void)
+{
+    uint8_t i;
+
+    for (i = 0; i < RBF_RXQ_MAX; i++) {
+        if (!s_entries[i].used) {
+            return &s_entries[i];
+        }
+    }
+    return NULL;
+}
+
+
+/* Queue entry on the heap for an alarm that found the queue full of alarms */
+static rxq_entry_t* rxq_extra_entry(void)
+{
+    rxq_extra_t* extra = rbf_malloc(sizeof(rxq_extra_t));
+
+    if (extra == NULL) {
+        return NULL;
+    }
+    extra->next = NULL;
+    if (s_extra_tail != NULL) {
+        s_extra_tail->next = extra;
+    } else {
+        s_extra_head = extra;
+    }
+    s_extra_tail = extra;
+    s_stats.extra++;
+    return &extra->entry;
+}
+
+
+static int rxq_observer(const rbf_observer_msg_t* msg, void* arg)
+{
+    rbf_rxq_class_t cls = rbf_rxq_class(msg);
+    rbf_rxq_class_stats_t* stats = &s_stats.classes[cls];
+    uint32_t size = rbf_observer_payload_size(msg);
+    rxq_entry_t* entry;
+
+    (void)arg;
+    rbf_mutex_lock(s_rxq_mutex);
+    entry = rxq_free_entry();
+    if (entry == NULL) {
+        entry = rxq_victim(cls);
+        if (entry != NULL) {
+            s_stats.classes[entry->cls].dropped++;
+            rxq_release(entry);
+        } else if (cls == RBF_RXQ_ALARM) {
+            /* Never dropped: grow the queue, so that alarms keep their order and their thread */
+            entry = rxq_extra_entry();
+            if (entry == NULL) {
+                /* Out of memory: let rbfsdk call the application callback now */
+                s_stats.direct++;
+                rbf_mutex_unlock(s_rxq_mutex);
+                return RBF_OBSERVER_PASS;
+            }
+        } else {
+            stats->dropped++;
+            rbf_mutex_unlock(s_rxq_mutex);
+            return RBF_OBSERVER_DROP;
+        }
+    }
+
+    entry->used = true;
+    entry->cls = cls;
+    entry->seq = s_seq++;
+    entry->msg = *msg;
+    entry->msg.payload = NULL;
+    if (size) {
+        memcpy(&entry->payload, msg->payload, size);
+        entry->msg.payload = &entry->payload;
+    }
+    stats->queued++;
+    if (++stats->pending > stats->high_water) {
+        stats->high_water = stats->pending;
+    }
+    if (++s_stats.pending > s_stats.high_water) {
+        s_stats.high_water = s_stats.pending;
+    }
+    rbf_mutex_unlock(s_rxq_mutex);
+
+    return RBF_OBSERVER_DROP;
+}
+
+
+int rbf_rxq_init(void)
+{
+    if (s_rxq_mutex != NULL) {
+        return 0;
+    }
+
+    s_rxq_mutex = rbf_mutex_create();
+    if (s_rxq_mutex == NULL) {
+        return -1;
+    }
+    return rbf_observer_add(rxq_observer, NULL);
+}
+
+
+rbf_rxq_class_t rbf_rxq_class(const rbf_observer_msg_t* msg)
+{
+    switch (msg->msg) {
+    case RBF_OBSERVER_MSG_HEARTBEAT:
+        return RBF_RXQ_HEARTBEAT;
+    case RBF_OBSERVER_MSG_OUTPUT_STATUS:
+        return RBF_RXQ_STATUS;
+    case RBF_OBSERVER_MSG_INPUT_STATUS:
+        return msg->type == RBF_DEV_TYPE_TEMP_HUMI ? RBF_RXQ_STATUS : RBF_RXQ_ALARM;
+    default:
+        return RBF_RXQ_ALARM;
+    }
+}
+
+
+int rbf_rxq_poll(uint16_t max_count)
+{
+    rxq_entry_t msg;
+    rbf_time_t now;
+    int count = 0;
+
+    if (s_rxq_mutex == NULL) {
+        return -1;
+    }
+
+    while (max_count == 0 || count < max_count) {
+        rxq_entry_t* next = NULL;
+        rbf_rxq_class_stats_t* stats;
+        uint32_t latency;
+        uint8_t i;
+
+        rbf_mutex_lock(s_rxq_mutex);
+        for (i = 0; i < RBF_RXQ_MAX; i++) {
+            rxq_entry_t* entry = &s_entries[i];
+
+            if (!entry->used) {
+                continue;
+            }
+            if (next == NULL || entry->cls > next->cls ||
+                (entry->cls == next->cls && (int32_t)(entry->seq - next->seq) < 0)) {
+                next = entry;
+            }
+        }
+        if (s_extra_head != NULL && (next == NULL || next->cls < RBF_RXQ_ALARM
+                                     || (int32_t)(s_extra_head->entry.seq - next->seq) < 0)) {
+            rxq_extra_t* extra = s_extra_head;
+
+            s_extra_head = extra->next;
+            if (s_extra_head == NULL) {
+                s_extra_tail = NULL;
+            }
+            msg = extra->entry;
+            rxq_release(&extra->entry);
+            rbf_free(extra);
+        } else if (next != NULL) {
+            msg = *next;
+            rxq_release(next);
+        } else {
+            rbf_mutex_unlock(s_rxq_mutex);
+            break;
+        }
+
+        rbf_time_get_ms(&now);
+        latency = (uint32_t)(now - msg.msg.time);
+        stats = &s_stats.classes[msg.cls];
+        stats->delivered++;
+        s_latency_total_ms[msg.cls] += latency;
+        stats->latency_avg_ms = (uint32_t)(s_latency_total_ms[msg.cls] / stats->delivered);
+        if (latency > stats->latency_max_ms) {
+            stats->latency_max_ms = latency;
+        }
+        rbf_mutex_unlock(s_rxq_mutex);
+
+        if (msg.msg.payload != NULL) {
+            msg.msg.payload = &msg.payload;
+        }
+        rbf_observer_deliver(&msg.msg);
+        count++;
+    }
+    return count;
+}
+
+
+int rbf_rxq_stats_get(rbf_rxq_stats_t* stats)
+{
+    if (s_rxq_mutex == NULL || stats == NULL) {
+        return -1;
+    }
+
+    rbf_mutex_lock(s_rxq_mutex);
+    *stats = s_stats;
+    rbf_mutex_unlock(s_rxq_mutex);
+
+    return 0;
+}
+
+
+int rbf_rxq_stats_clear(void)
+{
+    uint8_t i;
+
+    if (s_rxq_mutex == NULL) {
+        return -1;
+    }
+
+    rbf_mutex_lock(s_rxq_mutex);
+    for (i = 0; i < RBF_RXQ_CLASS_MAX; i++) {
+        uint16_t pending = s_stats.classes[i].pending;
+
+        memset(&s_stats.classes[i], 0, sizeof(rbf_rxq_class_stats_t));
+        s_stats.classes[i].pending = pending;
+        s_stats.classes[i].high_water = pending;
+    }
+    s_stats.high_water = s_stats.pending;
+    s_stats.direct = 0;
+    s_stats.extra = 0;
+    memset(s_latency_total_ms, 0, sizeof(s_latency_total_ms));
+    rbf_mutex_unlock(s_rxq_mutex);
+
+    return 0;
+}
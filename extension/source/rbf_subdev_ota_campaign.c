@@ -0,0 +1,397 @@
+/**
+ * @file rbf_subdev_ota_campaign.c
+ * @brief Sub-device OTA campaign: wave scheduler for any number of devices across categories
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+#include <string.h>
+#include "rbf_subdev_ota_campaign.h"
+#include "rbf_mutex.h"
+#include "rbf_time.h"
+
+typedef enum
+{
+    CAMPAIGN_DEV_PENDING = 0,
+    CAMPAIGN_DEV_ACTIVE,
+    CAMPAIGN_DEV_DONE,
+    CAMPAIGN_DEV_FAILED,
+}campaign_dev_state_t;
+
+typedef struct
+{
+    uint8_t cat;
+    uint8_t no;
+    uint8_t state;
+    uint8_t retries;
+}campaign_dev_t;
+
+static RBF_subdev_ota_evt_callbacks_t s_user_cbs;
+static rbf_subdev_ota_campaign_evt_handle_t s_campaign_evt_cb;
+static rbf_mutex_t s_campaign_mutex;
+
+static campaign_dev_t s_devs[RBF_SUBDEV_OTA_CAMPAIGN_MAX_DEVICES];
+static rbf_subdev_ota_campaign_cfg_t s_cfg;
+static rbf_subdev_ota_campaign_status_t s_status;
+static bool s_stop_request;
+static bool s_wave_ended;
+
+static uint16_t s_wave_idx[RBF_SUBDEV_OTA_WAVE_MAX_DEVICES];
+static bool s_wave_timeout[RBF_SUBDEV_OTA_WAVE_MAX_DEVICES];   /**< Device timed out, the wave goes on without it */
+static rbf_time_t s_campaign_start_ms;
+static rbf_time_t s_wave_start_ms;
+static uint32_t s_wave_total_ms;
+
+
+static void campaign_update_status(void)
+{
+    rbf_time_t now;
+    uint16_t remaining;
+    uint16_t wave_size = s_cfg.wave_size ? s_cfg.wave_size : 1;
+
+    rbf_time_get_ms(&now);
+    s_status.elapsed_s = (uint32_t)(now - s_campaign_start_ms) / 1000;
+    s_status.avg_wave_s = s_status.waves ? (s_wave_total_ms / s_status.waves) / 1000 : 0;
+
+    remaining = s_status.pending + s_status.wave_count;
+    s_status.percent = s_status.total ? (uint8_t)((s_status.done + s_status.failed) * 100 / s_status.total) : 100;
+    s_status.eta_s = ((remaining + wave_size - 1) / wave_size) * s_status.avg_wave_s;
+    s_status.device_s_remaining = remaining * s_status.avg_wave_s;
+}
+
+
+static void campaign_emit(rbf_subdev_ota_campaign_evt_t evt, const RBF_dev_id_t* ids, uint8_t count)
+{
+    rbf_subdev_ota_campaign_status_t status;
+
+    if (s_campaign_evt_cb == NULL) {
+        return;
+    }
+
+    rbf_mutex_lock(s_campaign_mutex);
+    campaign_update_status();
+    status = s_status;
+    rbf_mutex_unlock(s_campaign_mutex);
+
+    s_campaign_evt_cb(evt, ids, count, &status);
+}
+
+
+/* A failed device is retried while it has retries left, even when the campaign is stopping */
+static bool campaign_retry(campaign_dev_t* dev)
+{
+    if (dev->retries < s_cfg.max_retries) {
+        dev->retries++;
+        dev->state = CAMPAIGN_DEV_PENDING;
+        s_status.pending++;
+        s_status.retries++;
+        return true;
+    }
+    dev->state = CAMPAIGN_DEV_FAILED;
+    s_status.failed++;
+    return false;
+}
+
+
+static bool campaign_wave_failed(uint8_t no, RBF_subdev_ota_faild_response_t* responses, uint8_t response_count)
+{
+    uint8_t i;
+
+    for (i = 0; i < response_count; i++) {
+        if (responses[i].devno == no) {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+static void campaign_wave_end(RBF_subdev_ota_evt_t evt, RBF_subdev_ota_faild_response_t* responses, uint8_t response_count)
+{
+    RBF_dev_id_t wave_failed[RBF_SUBDEV_OTA_WAVE_MAX_DEVICES];
+    RBF_dev_id_t given_up[RBF_SUBDEV_OTA_WAVE_MAX_DEVICES];
+    uint8_t wave_failed_count = 0;
+    uint8_t given_up_count = 0;
+    uint8_t timeout_count = 0;
+    bool complete;
+    rbf_time_t now;
+    uint8_t i;
+
+    rbf_mutex_lock(s_campaign_mutex);
+    if (s_status.wave_count == 0) {
+        rbf_mutex_unlock(s_campaign_mutex);
+        return;
+    }
+
+    if (evt == RBF_SUBDEV_OTA_EVT_UPGRADE_REQUEST_TIMEOUT) {
+        /* The listed devices did not answer, the wave only ends once none is left */
+        for (i = 0; i < s_status.wave_count; i++) {
+            if (response_count == 0 || campaign_wave_failed(s_devs[s_wave_idx[i]].no, responses, response_count)) {
+                s_wave_timeout[i] = true;
+            }
+            timeout_count += s_wave_timeout[i];
+        }
+        if (timeout_count < s_status.wave_count) {
+            rbf_mutex_unlock(s_campaign_mutex);
+            return;
+        }
+    }
+
+    rbf_time_get_ms(&now);
+    s_wave_total_ms += (uint32_t)(now - s_wave_start_ms);
+    s_status.waves++;
+
+    for (i = 0; i < s_status.wave_count; i++) {
+        campaign_dev_t* dev = &s_devs[s_wave_idx[i]];
+        bool failed = s_wave_timeout[i] || (evt != RBF_SUBDEV_OTA_EVT_UPGRADE_COMPLETE && response_count == 0)
+                      || campaign_wave_failed(dev->no, responses, response_count);
+
+        if (!failed) {
+            dev->state = CAMPAIGN_DEV_DONE;
+            s_status.done++;
+            continue;
+        }
+
+        wave_failed[wave_failed_count].cat = (RBF_dev_cat_t)dev->cat;
+        wave_failed[wave_failed_count].no = dev->no;
+        wave_failed_count++;
+
+        if (!campaign_retry(dev)) {
+            given_up[given_up_count] = wave_failed[wave_failed_count - 1];
+            given_up_count++;
+        }
+    }
+
+    s_status.wave_count = 0;
+    s_wave_ended = true;
+    complete = (s_status.pending == 0 || s_stop_request);
+    if (complete) {
+        s_status.running = false;
+    }
+    rbf_mutex_unlock(s_campaign_mutex);
+
+    campaign_emit(RBF_SUBDEV_OTA_CAMPAIGN_EVT_WAVE_END, wave_failed, wave_failed_count);
+    if (given_up_count) {
+        campaign_emit(RBF_SUBDEV_OTA_CAMPAIGN_EVT_DEVICE_FAIL, given_up, given_up_count);
+    }
+    if (complete) {
+        campaign_emit(RBF_SUBDEV_OTA_CAMPAIGN_EVT_COMPLETE, NULL, 0);
+    }
+}
+
+
+static int campaign_evt_handle(RBF_subdev_ota_evt_t evt, RBF_subdev_ota_faild_response_t* responses, uint8_t response_count)
+{
+    campaign_wave_end(evt, responses, response_count);
+
+    if (s_user_cbs.rbf_subdev_ota_evt_handle == NULL) {
+        return 0;
+    }
+    return s_user_cbs.rbf_subdev_ota_evt_handle(evt, responses, response_count);
+}
+
+
+int rbf_subdev_ota_campaign_wrap(RBF_subdev_ota_evt_callbacks_t* cbs, rbf_subdev_ota_campaign_evt_handle_t evt_cb)
+{
+    if (cbs == NULL) {
+        return -1;
+    }
+
+    if (s_campaign_mutex == NULL) {
+        s_campaign_mutex = rbf_mutex_create();
+        if (s_campaign_mutex == NULL) {
+            return -1;
+        }
+    }
+
+    s_user_cbs = *cbs;
+    s_campaign_evt_cb = evt_cb;
+    cbs->rbf_subdev_ota_evt_handle = campaign_evt_handle;
+
+    return 0;
+}
+
+
+int rbf_subdev_ota_campaign_start(const RBF_dev_id_t* ids, uint16_t count, const rbf_subdev_ota_campaign_cfg_t* cfg)
+{
+    uint16_t i;
+
+    if (s_campaign_mutex == NULL || ids == NULL || cfg == NULL || count == 0
+        || count > RBF_SUBDEV_OTA_CAMPAIGN_MAX_DEVICES
+        || cfg->wave_size == 0 || cfg->wave_size > RBF_SUBDEV_OTA_WAVE_MAX_DEVICES) {
+        return -1;
+    }
+
+    for (i = 0; i < count; i++) {
+        if (ids[i].cat == 0 || ids[i].cat >= RBF_DEV_UNKNOW || cfg->fw_size[ids[i].cat] == 0) {
+            return -1;
+        }
+    }
+
+    rbf_mutex_lock(s_campaign_mutex);
+    if (s_status.running) {
+        rbf_mutex_unlock(s_campaign_mutex);
+        return -1;
+    }
+
+    for (i = 0; i < count; i++) {
+        s_devs[i].cat = (uint8_t)ids[i].cat;
+        s_devs[i].no = ids[i].no;
+        s_devs[i].state = CAMPAIGN_DEV_PENDING;
+        s_devs[i].retries = 0;
+    }
+
+    memset(&s_status, 0, sizeof(s_status));
+    s_cfg = *cfg;
+    s_status.running = true;
+    s_status.total = count;
+    s_status.pending = count;
+    s_stop_request = false;
+    s_wave_ended = false;
+    s_wave_total_ms = 0;
+    rbf_time_get_ms(&s_campaign_start_ms);
+    rbf_mutex_unlock(s_campaign_mutex);
+
+    return 0;
+}
+
+
+int rbf_subdev_ota_campaign_stop(void)
+{
+    bool idle;
+
+    if (s_campaign_mutex == NULL) {
+        return -1;
+    }
+
+    rbf_mutex_lock(s_campaign_mutex);
+    s_stop_request = true;
+    idle = s_status.running && s_status.wave_count == 0;
+    if (idle) {
+        s_status.running = false;
+    }
+    rbf_mutex_unlock(s_campaign_mutex);
+
+    if (idle) {
+        campaign_emit(RBF_SUBDEV_OTA_CAMPAIGN_EVT_COMPLETE, NULL, 0);
+    }
+    return 0;
+}
+
+
+int rbf_subdev_ota_campaign_resume(void)
+{
+    if (s_campaign_mutex == NULL) {
+        return -1;
+    }
+
+    rbf_mutex_lock(s_campaign_mutex);
+    if (s_status.running || s_status.pending == 0) {
+        rbf_mutex_unlock(s_campaign_mutex);
+        return -1;
+    }
+    s_status.running = true;
+    s_stop_request = false;
+    rbf_mutex_unlock(s_campaign_mutex);
+
+    return 0;
+}
+
+
+int rbf_subdev_ota_campaign_poll(void)
+{
+    RBF_dev_id_t wave_ids[RBF_SUBDEV_OTA_WAVE_MAX_DEVICES];
+    RBF_dev_id_t given_up[RBF_SUBDEV_OTA_WAVE_MAX_DEVICES];
+    uint8_t no_list[RBF_SUBDEV_OTA_WAVE_MAX_DEVICES];
+    uint8_t given_up_count = 0;
+    uint8_t wave_count = 0;
+    uint8_t cat = 0;
+    bool complete = false;
+    uint16_t i;
+
+    if (s_campaign_mutex == NULL) {
+        return 0;
+    }
+
+    rbf_mutex_lock(s_campaign_mutex);
+    if (!s_status.running || s_stop_request || s_status.wave_count != 0 || s_status.pending == 0) {
+        rbf_mutex_unlock(s_campaign_mutex);
+        return 0;
+    }
+
+    /* A wave is made of pending devices of the category of the first pending device */
+    for (i = 0; i < s_status.total && wave_count < s_cfg.wave_size; i++) {
+        if (s_devs[i].state != CAMPAIGN_DEV_PENDING) {
+            continue;
+        }
+        if (cat == 0) {
+            cat = s_devs[i].cat;
+        } else if (s_devs[i].cat != cat) {
+            continue;
+        }
+
+        s_devs[i].state = CAMPAIGN_DEV_ACTIVE;
+        s_wave_idx[wave_count] = i;
+        s_wave_timeout[wave_count] = false;
+        no_list[wave_count] = s_devs[i].no;
+        wave_ids[wave_count].cat = (RBF_dev_cat_t)cat;
+        wave_ids[wave_count].no = s_devs[i].no;
+        wave_count++;
+    }
+
+    s_status.pending -= wave_count;
+    s_status.wave_count = wave_count;
+    s_status.wave_cat = (RBF_dev_cat_t)cat;
+    s_wave_ended = false;
+    rbf_time_get_ms(&s_wave_start_ms);
+    rbf_mutex_unlock(s_campaign_mutex);
+
+    /* Let the application select the image of the category before data is requested */
+    campaign_emit(RBF_SUBDEV_OTA_CAMPAIGN_EVT_WAVE_START, wave_ids, wave_count);
+
+    if (0 != rbf_subdev_ota_start(cat, no_list, wave_count, s_cfg.fw_size[cat])) {
+        /* Each failed start costs the devices a retry, a device that is never accepted is given up */
+        rbf_mutex_lock(s_campaign_mutex);
+        if (!s_wave_ended) {
+            for (i = 0; i < wave_count; i++) {
+                if (!campaign_retry(&s_devs[s_wave_idx[i]])) {
+                    given_up[given_up_count] = wave_ids[i];
+                    given_up_count++;
+                }
+            }
+            s_status.wave_count = 0;
+            complete = s_status.pending == 0;
+            if (complete) {
+                s_status.running = false;
+            }
+        }
+        rbf_mutex_unlock(s_campaign_mutex);
+
+        if (given_up_count) {
+            campaign_emit(RBF_SUBDEV_OTA_CAMPAIGN_EVT_DEVICE_FAIL, given_up, given_up_count);
+        }
+        if (complete) {
+            campaign_emit(RBF_SUBDEV_OTA_CAMPAIGN_EVT_COMPLETE, NULL, 0);
+        }
+        return -1;
+    }
+
+    return 1;
+}
+
+
+int rbf_subdev_ota_campaign_status_get(rbf_subdev_ota_campaign_status_t* status)
+{
+    if (status == NULL || s_campaign_mutex == NULL) {
+        return -1;
+    }
+
+    rbf_mutex_lock(s_campaign_mutex);
+    campaign_update_status();
+    *status = s_status;
+    rbf_mutex_unlock(s_campaign_mutex);
+
+    return 0;
+}
@@ -0,0 +1,431 @@
+/**
+ * @file rbf_supervision.c
+ * @brief Sub-device supervision: offline and online events from missed heartbeats
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+#include <string.h>
+#include <stdbool.h>
+#include "rbf_supervision.h"
+#include "rbf_observer.h"
+#include "rbf_mutex.h"
+
+/*
+ * Hierarchical timer wheel: 3 levels of 64 slots, level n slots are 64^n ticks wide. A report
+ * moves the device to the slot of its new expiry in O(1), a level 0 slot holds the devices
+ * expiring at that exact tick, and the upper levels are cascaded down when the lower one wraps.
+ */
+#define WHEEL_BITS          (6)
+#define WHEEL_SIZE          (1 << WHEEL_BITS)
+#define WHEEL_MASK          (WHEEL_SIZE - 1)
+#define WHEEL_LEVELS        (3)
+#define WHEEL_SPAN          (1UL << (WHEEL_BITS * WHEEL_LEVELS))
+
+#define NODE_NONE           (0xFFFF)
+#define NODE_IDLE           (0xFF)      /**< Level of a node not in the wheel */
+
+typedef struct
+{
+    uint16_t prev;
+    uint16_t next;              /**< Wheel slot list, free list when unused */
+    uint32_t expire;            /**< Expiry tick */
+    RBF_dev_id_t id;
+    RBF_dev_type_t type;
+    rbf_time_t last_ms;
+    uint8_t state;
+    uint8_t reported;           /**< Last state given to the application */
+    uint8_t level;
+    uint8_t slot;
+    bool used;
+    bool queued;                /**< In the event ring */
+}supervision_node_t;
+
+static rbf_mutex_t s_supervision_mutex;
+static rbf_supervision_evt_handle_t s_handle;
+static supervision_node_t s_nodes[RBF_SUPERVISION_MAX];
+static uint16_t s_map[RBF_DEV_UNKNOW - RBF_DEV_IO][256];  /**< (cat, no) to node */
+static uint16_t s_wheel[WHEEL_LEVELS][WHEEL_SIZE];
+static uint16_t s_free;
+static uint16_t s_evt[RBF_SUPERVISION_MAX];
+static uint16_t s_evt_head;
+static uint16_t s_evt_count;
+static uint32_t s_tick;
+static rbf_time_t s_tick_ms;
+static uint32_t s_interval_s[RBF_DEV_TYPE_UNKNOW];
+
+
+static uint16_t* supervision_map(const RBF_dev_id_t* id)
+{
+    if (id->cat < RBF_DEV_IO || id->cat >= RBF_DEV_UNKNOW) {
+        return NULL;
+    }
+    return &s_map[id->cat - RBF_DEV_IO][id->no];
+}
+
+
+static void wheel_unlink(uint16_t i)
+{
+    supervision_node_t* node = &s_nodes[i];
+
+    if (node->level == NODE_IDLE) {
+        return;
+    }
+
+    if (node->prev != NODE_NONE) {
+        s_nodes[node->prev].next = node->next;
+    } else {
+        s_wheel[node->level][node->slot] = node->next;
+    }
+    if (node->next != NODE_NONE) {
+        s_nodes[node->next].prev = node->prev;
+    }
+    node->level = NODE_IDLE;
+}
+
+
+static void wheel_link(uint16_t i)
+{
+    supervision_node_t* node = &s_nodes[i];
+    uint32_t delta = node->expire - s_tick;
+    uint8_t level = 0;
+
+    while (level < WHEEL_LEVELS - 1 && delta >= (1UL << (WHEEL_BITS * (level + 1)))) {
+        level++;
+    }
+    node->level = level;
+    node->slot = (node->expire >> (WHEEL_BITS * level)) & WHEEL_MASK;
+    node->prev = NODE_NONE;
+    node->next = s_wheel[level][node->slot];
+    if (node->next != NODE_NONE) {
+        s_nodes[node->next].prev = i;
+    }
+    s_wheel[level][node->slot] = i;
+}
+
+
+static void supervision_queue(uint16_t i)
+{
+    if (!s_nodes[i].queued) {
+        s_nodes[i].queued = true;
+        s_evt[(s_evt_head + s_evt_count) % RBF_SUPERVISION_MAX] = i;
+        s_evt_count++;
+    }
+}
+
+
+static void supervision_arm(uint16_t i, rbf_time_t now)
+{
+    supervision_node_t* node = &s_nodes[i];
+    uint32_t interval = s_interval_s[node->type];
+    int32_t lag = (int32_t)(now - s_tick_ms);
+    uint32_t ticks;
+
+    wheel_unlink(i);
+    if (interval == 0) {
+        return;
+    }
+
+    /* The wheel may be behind the report by up to one poll period */
+    ticks = (interval * 1000 + RBF_SUPERVISION_TICK_MS - 1) / RBF_SUPERVISION_TICK_MS;
+    if (lag > 0) {
+        ticks += (uint32_t)lag / RBF_SUPERVISION_TICK_MS;
+    }
+    if (ticks == 0) {
+        ticks = 1;
+    } else if (ticks >= WHEEL_SPAN) {
+        ticks = WHEEL_SPAN - 1;
+    }
+    node->expire = s_tick + ticks;
+    wheel_link(i);
+}
+
+
+static uint16_t supervision_alloc(const RBF_dev_id_t* id, RBF_dev_type_t type)
+{
+    uint16_t* map = supervision_map(id);
+    uint16_t i;
+
+    if (map == NULL) {
+        return NODE_NONE;
+    }
+    if (*map != NODE_NONE) {
+        s_nodes[*map].type = type;
+        return *map;
+    }
+    if (s_free == NODE_NONE) {
+        return NODE_NONE;
+    }
+
+    i = s_free;
+    s_free = s_nodes[i].next;
+    /* A freed node may still be in the event ring, keep its queued flag */
+    s_nodes[i].used = true;
+    s_nodes[i].id = *id;
+    s_nodes[i].type = type;
+    s_nodes[i].last_ms = 0;
+    s_nodes[i].state = RBF_SUPERVISION_UNKNOWN;
+    s_nodes[i].reported = RBF_SUPERVISION_UNKNOWN;
+    s_nodes[i].level = NODE_IDLE;
+    *map = i;
+    return i;
+}
+
+
+static void wheel_cascade(uint8_t level, uint8_t slot)
+{
+    uint16_t i = s_wheel[level][slot];
+
+    s_wheel[level][slot] = NODE_NONE;
+    while (i != NODE_NONE) {
+        uint16_t next = s_nodes[i].next;
+
+        wheel_link(i);
+        i = next;
+    }
+}
+
+
+static void wheel_tick(void)
+{
+    uint8_t index;
+    uint16_t i;
+
+    s_tick++;
+    index = s_tick & WHEEL_MASK;
+    if (index == 0) {
+        wheel_cascade(1, (s_tick >> WHEEL_BITS) & WHEEL_MASK);
+        if (((s_tick >> WHEEL_BITS) & WHEEL_MASK) == 0) {
+            wheel_cascade(2, (s_tick >> (WHEEL_BITS * 2)) & WHEEL_MASK);
+        }
+    }
+
+    i = s_wheel[0][index];
+    s_wheel[0][index] = NODE_NONE;
+    while (i != NODE_NONE) {
+        uint16_t next = s_nodes[i].next;
+
+        s_nodes[i].level = NODE_IDLE;
+        s_nodes[i].state = RBF_SUPERVISION_OFFLINE;
+        supervision_queue(i);
+        i = next;
+    }
+}
+
+
+static int supervision_observer(const rbf_observer_msg_t* msg, void* arg)
+{
+    uint16_t* map = supervision_map(&msg->id);
+    uint16_t i;
+
+    (void)arg;
+    if (map == NULL || msg->type >= RBF_DEV_TYPE_UNKNOW) {
+        return RBF_OBSERVER_PASS;
+    }
+
+    rbf_mutex_lock(s_supervision_mutex);
+    /* Devices of an unsupervised type are not tracked */
+    i = *map == NODE_NONE && s_interval_s[msg->type] == 0 ? NODE_NONE : supervision_alloc(&msg->id, msg->type);
+    if (i != NODE_NONE) {
+        supervision_node_t* node = &s_nodes[i];
+
+        node->last_ms = msg->time;
+        if (node->state != RBF_SUPERVISION_ONLINE) {
+            node->state = RBF_SUPERVISION_ONLINE;
+            supervision_queue(i);
+        }
+        supervision_arm(i, msg->time);
+    }
+    rbf_mutex_unlock(s_supervision_mutex);
+
+    return RBF_OBSERVER_PASS;
+}
+
+
+int rbf_supervision_init(rbf_supervision_evt_handle_t handle)
+{
+    uint16_t i;
+
+    if (s_supervision_mutex != NULL) {
+        return 0;
+    }
+
+    s_supervision_mutex = rbf_mutex_create();
+    if (s_supervision_mutex == NULL) {
+        return -1;
+    }
+
+    s_handle = handle;
+    memset(s_map, 0xFF, sizeof(s_map));
+    memset(s_wheel, 0xFF, sizeof(s_wheel));
+    for (i = 0; i < RBF_SUPERVISION_MAX; i++) {
+        s_nodes[i].next = i + 1 < RBF_SUPERVISION_MAX ? i + 1 : NODE_NONE;
+        s_nodes[i].level = NODE_IDLE;
+    }
+    s_free = 0;
+    for (i = 0; i < RBF_DEV_TYPE_UNKNOW; i++) {
+        s_interval_s[i] = RBF_SUPERVISION_INTERVAL_DEFAULT;
+    }
+    s_interval_s[RBF_DEV_TYPE_KEYFOB] = 0;
+    rbf_time_get_ms(&s_tick_ms);
+
+    return rbf_observer_add(supervision_observer, NULL);
+}
+
+
+int rbf_supervision_interval_set(RBF_dev_type_t type, uint32_t seconds)
+{
+    if (s_supervision_mutex == NULL || type >= RBF_DEV_TYPE_UNKNOW || seconds > RBF_SUPERVISION_INTERVAL_MAX) {
+        return -1;
+    }
+
+    rbf_mutex_lock(s_supervision_mutex);
+    s_interval_s[type] = seconds;
+    rbf_mutex_unlock(s_supervision_mutex);
+
+    return 0;
+}
+
+
+int rbf_supervision_intervals_set(const uint32_t seconds[RBF_DEV_TYPE_UNKNOW])
+{
+    uint8_t i;
+
+    if (s_supervision_mutex == NULL || seconds == NULL) {
+        return -1;
+    }
+    for (i = 0; i < RBF_DEV_TYPE_UNKNOW; i++) {
+        if (seconds[i] > RBF_SUPERVISION_INTERVAL_MAX) {
+            return -1;
+        }
+    }
+
+    rbf_mutex_lock(s_supervision_mutex);
+    for (i = 0; i < RBF_DEV_TYPE_UNKNOW; i++) {
+        if (seconds[i]) {
+            s_interval_s[i] = seconds[i];
+        }
+    }
+    rbf_mutex_unlock(s_supervision_mutex);
+
+    return 0;
+}
+
+
+int rbf_supervision_add(const RBF_dev_id_t* id, RBF_dev_type_t type)
+{
+    rbf_time_t now;
+    uint16_t i;
+
+    if (s_supervision_mutex == NULL || id == NULL || type >= RBF_DEV_TYPE_UNKNOW) {
+        return -1;
+    }
+
+    rbf_time_get_ms(&now);
+    rbf_mutex_lock(s_supervision_mutex);
+    i = supervision_alloc(id, type);
+    if (i != NODE_NONE && s_nodes[i].level == NODE_IDLE && s_nodes[i].state != RBF_SUPERVISION_OFFLINE) {
+        supervision_arm(i, now);
+    }
+    rbf_mutex_unlock(s_supervision_mutex);
+
+    return i != NODE_NONE ? 0 : -1;
+}
+
+
+int rbf_supervision_remove(const RBF_dev_id_t* id)
+{
+    uint16_t* map;
+    uint16_t i;
+
+    if (s_supervision_mutex == NULL || id == NULL) {
+        return -1;
+    }
+
+    rbf_mutex_lock(s_supervision_mutex);
+    map = supervision_map(id);
+    i = map != NULL ? *map : NODE_NONE;
+    if (i != NODE_NONE) {
+        wheel_unlink(i);
+        s_nodes[i].used = false;
+        s_nodes[i].next = s_free;
+        s_free = i;
+        *map = NODE_NONE;
+    }
+    rbf_mutex_unlock(s_supervision_mutex);
+
+    return i != NODE_NONE ? 0 : -1;
+}
+
+
+int rbf_supervision_state_get(const RBF_dev_id_t* id, rbf_supervision_state_t* state, rbf_time_t* last_ms)
+{
+    uint16_t* map;
+    uint16_t i;
+
+    if (s_supervision_mutex == NULL || id == NULL || state == NULL) {
+        return -1;
+    }
+
+    rbf_mutex_lock(s_supervision_mutex);
+    map = supervision_map(id);
+    i = map != NULL ? *map : NODE_NONE;
+    if (i != NODE_NONE) {
+        *state = (rbf_supervision_state_t)s_nodes[i].state;
+        if (last_ms != NULL) {
+            *last_ms = s_nodes[i].last_ms;
+        }
+    }
+    rbf_mutex_unlock(s_supervision_mutex);
+
+    return i != NODE_NONE ? 0 : -1;
+}
+
+
+int rbf_supervision_poll(void)
+{
+    rbf_time_t now;
+    int count = 0;
+
+    if (s_supervision_mutex == NULL) {
+        return 0;
+    }
+
+    rbf_time_get_ms(&now);
+    rbf_mutex_lock(s_supervision_mutex);
+    while (now - s_tick_ms >= RBF_SUPERVISION_TICK_MS) {
+        wheel_tick();
+        s_tick_ms += RBF_SUPERVISION_TICK_MS;
+    }
+
+    /* Report outside the lock, a device back before the poll reports nothing */
+    while (s_evt_count) {
+        supervision_node_t* node = &s_nodes[s_evt[s_evt_head]];
+        RBF_dev_id_t id;
+        RBF_dev_type_t type;
+        rbf_supervision_state_t state;
+
+        s_evt_head = (s_evt_head + 1) % RBF_SUPERVISION_MAX;
+        s_evt_count--;
+        node->queued = false;
+        if (!node->used || node->state == node->reported || node->state == RBF_SUPERVISION_UNKNOWN) {
+            continue;
+        }
+
+        node->reported = node->state;
+        id = node->id;
+        type = node->type;
+        state = (rbf_supervision_state_t)node->state;
+        rbf_mutex_unlock(s_supervision_mutex);
+        if (s_handle != NULL) {
+            s_handle(&id, type, state);
+        }
+        count++;
+        rbf_mutex_lock(s_supervision_mutex);
+    }
+    rbf_mutex_unlock(s_supervision_mutex);
+
+    return count;
+}
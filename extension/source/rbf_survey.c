@@ -0,0 +1,332 @@
+/**
+ * @file rbf_survey.c
+ * @brief Site survey: RSSI broadcast of the devices for a set duration and a per-device report
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+#include <string.h>
+#include <stdbool.h>
+#include "rbf_survey.h"
+#include "rbf_observer.h"
+#include "rbf_mutex.h"
+#include "rbf_time.h"
+
+typedef enum
+{
+    SURVEY_IDLE = 0,
+    SURVEY_INFO,            /**< Waiting for the registration information */
+    SURVEY_READY,           /**< Devices known, RSSI broadcast to enable */
+    SURVEY_RUNNING,
+    SURVEY_END,             /**< RSSI broadcast to disable */
+}survey_state_t;
+
+typedef struct
+{
+    int32_t sum;
+    uint32_t min_gap_ms;
+    rbf_time_t last_ms;
+}survey_acc_t;
+
+static rbf_mutex_t s_survey_mutex;
+static RBF_evt_callbacks_t s_user_cbs;
+static bool s_observing;
+static survey_state_t s_state;
+static RBF_dev_id_t s_ids[RBF_SURVEY_MAX];
+static rbf_survey_report_t s_reports[RBF_SURVEY_MAX];
+static survey_acc_t s_accs[RBF_SURVEY_MAX];
+static uint8_t s_count;
+static uint8_t s_skipped;
+static uint32_t s_duration_ms;
+static uint32_t s_period_ms;
+static rbf_time_t s_start_ms;
+static rbf_survey_done_t s_done;
+
+
+static int survey_register_info_handle(RBF_dev_id_t* ids, int count)
+{
+    rbf_mutex_lock(s_survey_mutex);
+    if (s_state == SURVEY_INFO && ids != NULL) {
+        s_count = count < RBF_SURVEY_MAX ? (uint8_t)count : RBF_SURVEY_MAX;
+        s_skipped = (uint8_t)(count - s_count);
+        memcpy(s_ids, ids, sizeof(RBF_dev_id_t) * s_count);
+        s_state = SURVEY_READY;
+    }
+    rbf_mutex_unlock(s_survey_mutex);
+
+    if (s_user_cbs.rbf_dev_register_info_handle == NULL) {
+        return 0;
+    }
+    return s_user_cbs.rbf_dev_register_info_handle(ids, count);
+}
+
+
+static int survey_observer(const rbf_observer_msg_t* msg, void* arg)
+{
+    uint8_t i;
+
+    (void)arg;
+    if (msg->msg != RBF_OBSERVER_MSG_HEARTBEAT || s_state != SURVEY_RUNNING) {
+        return RBF_OBSERVER_PASS;
+    }
+
+    rbf_mutex_lock(s_survey_mutex);
+    for (i = 0; i < s_count && s_state == SURVEY_RUNNING; i++) {
+        rbf_survey_report_t* report = &s_reports[i];
+        survey_acc_t* acc = &s_accs[i];
+
+        if (report->id.cat != msg->id.cat || report->id.no != msg->id.no) {
+            continue;
+        }
+        if (report->samples) {
+            uint32_t gap = (uint32_t)(msg->time - acc->last_ms);
+
+            if (acc->min_gap_ms == 0 || gap < acc->min_gap_ms) {
+                acc->min_gap_ms = gap;
+            }
+        }
+        if (report->samples == 0 || msg->rssi < report->worst) {
+            report->worst = msg->rssi;
+        }
+        if (report->samples == 0 || msg->rssi > report->best) {
+            report->best = msg->rssi;
+        }
+        report->samples++;
+        acc->sum += msg->rssi;
+        acc->last_ms = msg->time;
+        break;
+    }
+    rbf_mutex_unlock(s_survey_mutex);
+
+    return RBF_OBSERVER_PASS;
+}
+
+
+static uint8_t survey_loss(const rbf_survey_report_t* report, const survey_acc_t* acc, uint32_t elapsed_ms)
+{
+    uint32_t period = s_period_ms ? s_period_ms : acc->min_gap_ms;
+    uint32_t expected;
+
+    if (report->samples == 0) {
+        return 100;
+    }
+    if (period == 0) {
+        return RBF_SURVEY_LOSS_UNKNOW;
+    }
+
+    expected = elapsed_ms / period;
+    if (expected <= report->samples) {
+        return 0;
+    }
+    return (uint8_t)((expected - report->samples) * 100 / expected);
+}
+
+
+static int survey_rssi(bool start)
+{
+    if (s_count == 0) {
+        return 0;
+    }
+    if (start) {
+        return rbf_start_rssi(s_ids, s_count);
+    }
+    return rbf_stop_rssi(s_ids, s_count);
+}
+
+
+int rbf_survey_wrap(RBF_evt_callbacks_t* cbs)
+{
+    if (cbs == NULL) {
+        return -1;
+    }
+
+    if (s_survey_mutex == NULL) {
+        s_survey_mutex = rbf_mutex_create();
+        if (s_survey_mutex == NULL) {
+            return -1;
+        }
+    }
+
+    s_user_cbs = *cbs;
+    cbs->rbf_dev_register_info_handle = survey_register_info_handle;
+
+    return 0;
+}
+
+
+int rbf_survey_start(const RBF_dev_id_t* ids, uint8_t count, uint32_t duration_ms, uint32_t period_ms,
+                     rbf_survey_done_t done)
+{
+    if (s_survey_mutex == NULL || duration_ms == 0 || (ids != NULL && count == 0)) {
+        return -1;
+    }
+#if RBF_SURVEY_MAX < 255
+    if (ids != NULL && count > RBF_SURVEY_MAX) {
+        return -1;
+    }
+#endif
+
+    if (!s_observing) {
+        if (0 != rbf_observer_add(survey_observer, NULL)) {
+            return -1;
+        }
+        s_observing = true;
+    }
+
+    rbf_mutex_lock(s_survey_mutex);
+    if (s_state != SURVEY_IDLE) {
+        rbf_mutex_unlock(s_survey_mutex);
+        return -1;
+    }
+    s_duration_ms = duration_ms;
+    s_period_ms = period_ms;
+    s_done = done;
+    s_count = 0;
+    s_skipped = 0;
+    rbf_time_get_ms(&s_start_ms);
+    if (ids != NULL) {
+        memcpy(s_ids, ids, sizeof(RBF_dev_id_t) * count);
+        s_count = count;
+        s_state = SURVEY_READY;
+    } else {
+        s_state = SURVEY_INFO;
+    }
+    rbf_mutex_unlock(s_survey_mutex);
+
+    if (ids == NULL && 0 != rbf_get_register_info()) {
+        rbf_mutex_lock(s_survey_mutex);
+        s_state = SURVEY_IDLE;
+        rbf_mutex_unlock(s_survey_mutex);
+        return -1;
+    }
+    return 0;
+}
+
+
+int rbf_survey_stop(void)
+{
+    int ret = 0;
+
+    if (s_survey_mutex == NULL) {
+        return -1;
+    }
+
+    rbf_mutex_lock(s_survey_mutex);
+    if (s_state == SURVEY_RUNNING) {
+        s_state = SURVEY_END;
+    } else if (s_state == SURVEY_INFO || s_state == SURVEY_READY) {
+        s_state = SURVEY_IDLE;
+        s_count = 0;
+    } else {
+        ret = -1;
+    }
+    rbf_mutex_unlock(s_survey_mutex);
+
+    return ret;
+}
+
+
+int rbf_survey_poll(void)
+{
+    rbf_survey_done_t done = NULL;
+    uint32_t elapsed;
+    rbf_time_t now;
+    uint8_t count = 0;
+    uint8_t i;
+
+    if (s_survey_mutex == NULL) {
+        return -1;
+    }
+
+    rbf_time_get_ms(&now);
+    rbf_mutex_lock(s_survey_mutex);
+    switch (s_state) {
+    case SURVEY_INFO:
+        if (now - s_start_ms >= RBF_SURVEY_INFO_TIMEOUT_MS) {
+            s_state = SURVEY_IDLE;
+            s_count = 0;
+            done = s_done;
+        }
+        break;
+    case SURVEY_READY:
+        memset(s_reports, 0, sizeof(s_reports));
+        memset(s_accs, 0, sizeof(s_accs));
+        for (i = 0; i < s_count; i++) {
+            s_reports[i].id = s_ids[i];
+        }
+        s_start_ms = now;
+        s_state = SURVEY_RUNNING;
+        rbf_mutex_unlock(s_survey_mutex);
+        if (0 == survey_rssi(true)) {
+            return 0;
+        }
+
+        /* No report rather than a 100 % loss for every device */
+        survey_rssi(false);
+        rbf_mutex_lock(s_survey_mutex);
+        s_state = SURVEY_IDLE;
+        s_count = 0;
+        done = s_done;
+        rbf_mutex_unlock(s_survey_mutex);
+        if (done != NULL) {
+            done(s_reports, 0);
+        }
+        return -1;
+    case SURVEY_RUNNING:
+        if (now - s_start_ms >= s_duration_ms) {
+            s_state = SURVEY_END;
+        }
+        break;
+    default:
+        break;
+    }
+
+    if (s_state == SURVEY_END) {
+        /* Disable RSSI broadcast first to save the device batteries and the airtime */
+        rbf_mutex_unlock(s_survey_mutex);
+        survey_rssi(false);
+        rbf_mutex_lock(s_survey_mutex);
+
+        elapsed = (uint32_t)(now - s_start_ms);
+        for (i = 0; i < s_count; i++) {
+            rbf_survey_report_t* report = &s_reports[i];
+
+            report->mean = report->samples ? s_accs[i].sum / report->samples : 0;
+            report->loss_percent = survey_loss(report, &s_accs[i], elapsed);
+        }
+        s_state = SURVEY_IDLE;
+        count = s_count;
+        done = s_done;
+    }
+    rbf_mutex_unlock(s_survey_mutex);
+
+    if (done != NULL) {
+        done(s_reports, count);
+    }
+    return 0;
+}
+
+
+uint8_t rbf_survey_skipped(void)
+{
+    return s_skipped;
+}
+
+
+int rbf_survey_report_get(rbf_survey_report_t* reports, uint8_t max_count)
+{
+    uint8_t count;
+
+    if (s_survey_mutex == NULL || reports == NULL) {
+        return 0;
+    }
+
+    rbf_mutex_lock(s_survey_mutex);
+    count = s_state == SURVEY_IDLE ? (s_count < max_count ? s_count : max_count) : 0;
+    memcpy(reports, s_reports, sizeof(rbf_survey_report_t) * count);
+    rbf_mutex_unlock(s_survey_mutex);
+
+    return count;
+}
@@ -0,0 +1,99 @@
+/**
+ * @file rbf_temphumi_fixed.c
+ * @brief Fixed-point temperature and humidity path for FPU-less targets
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+#include <string.h>
+#include "rbf_temphumi_fixed.h"
+#include "rbf_observer.h"
+
+
+int16_t rbf_float_to_centi(float value)
+{
+    uint32_t bits;
+    uint32_t mant;
+    int32_t exp;
+    int32_t result;
+
+    memcpy(&bits, &value, sizeof(bits));
+    exp = (int32_t)((bits >> 23) & 0xFF);
+    if (exp == 0xFF) {
+        /* NaN/Inf */
+        return (bits & 0x80000000) ? INT16_MIN : INT16_MAX;
+    }
+    if (exp == 0) {
+        /* Zero and denormals are far below 0.005 */
+        return 0;
+    }
+
+    /* value = mant * 2^(exp - 150), mant * 100 fits in 31 bits */
+    mant = ((bits & 0x007FFFFF) | 0x00800000) * 100;
+    exp -= 150;
+
+    if (exp >= 0) {
+        /* |value| >= 2^23, always saturates */
+        result = 32768;
+    } else if (exp < -31) {
+        result = 0;
+    } else {
+        uint32_t shift = (uint32_t)(-exp);
+        uint32_t scaled = (mant >> shift) + ((mant >> (shift - 1)) & 1);
+
+        result = scaled > 32768 ? 32768 : (int32_t)scaled;
+    }
+
+    if (bits & 0x80000000) {
+        result = -result;
+    } else if (result > INT16_MAX) {
+        result = INT16_MAX;
+    }
+    return (int16_t)result;
+}
+
+
+#if RBF_TEMP_HUMI_FIXED_POINT
+
+static rbf_temp_humi_fixed_callbacks_t m_rbf_temp_humi_fixed_callbacks;
+
+
+static int rbf_temp_humi_fixed_handle_heartbeat(uint8_t no, rbf_temp_humi_heartbeat_t* heartbeat)
+{
+    rbf_temp_humi_heartbeat_fixed_t fixed;
+
+    if (m_rbf_temp_humi_fixed_callbacks.hb_cb == NULL) {
+        return 0;
+    }
+
+    fixed.power = heartbeat->power;
+    fixed.temp = rbf_float_to_centi(heartbeat->temp);
+    fixed.humi = rbf_float_to_centi(heartbeat->humi);
+    fixed.rssi = heartbeat->rssi;
+
+    return m_rbf_temp_humi_fixed_callbacks.hb_cb(no, &fixed);
+}
+
+
+int rbf_temp_humi_fixed_register_callbacks(rbf_temp_humi_fixed_callbacks_t* cbs)
+{
+    rbf_temp_humi_callbacks_t float_cbs;
+
+    if (cbs == NULL) {
+        return 1;
+    }
+
+    m_rbf_temp_humi_fixed_callbacks = *cbs;
+    float_cbs.hb_cb = rbf_temp_humi_fixed_handle_heartbeat;
+    float_cbs.input_status_cb = cbs->input_status_cb;
+    /* Observers see the heartbeat before it is converted and may drop it */
+    if (0 != rbf_observer_wrap_temp_humi(&float_cbs)) {
+        return 1;
+    }
+
+    return rbf_temp_humi_register_callbacks(&float_cbs);
+}
+
+#endif
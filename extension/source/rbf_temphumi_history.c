@@ -0,0 +1,515 @@
+/**
+ * @file rbf_temphumi_history.c
+ * @brief Temperature and humidity history with min/max/avg downsampling
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+#include <string.h>
+#include "rbf_temphumi_history.h"
+#include "rbf_temphumi_fixed.h"
+#include "rbf_observer.h"
+#include "rbf_mutex.h"
+#include "rbf_time.h"
+
+#if (RBF_TEMP_HUMI_HISTORY_COARSE_S % RBF_TEMP_HUMI_HISTORY_FINE_S) != 0
+#error "RBF_TEMP_HUMI_HISTORY_COARSE_S must be a multiple of RBF_TEMP_HUMI_HISTORY_FINE_S"
+#endif
+
+#if RBF_TEMP_HUMI_HISTORY_FINE_BUCKETS < 3 || RBF_TEMP_HUMI_HISTORY_COARSE_BUCKETS < 3
+#error "RBF_TEMP_HUMI_HISTORY_*_BUCKETS must hold an absolute bucket"
+#endif
+
+#define HISTORY_DELTA_EMPTY         (-128)      /**< Delta marking a bucket without sample */
+#define HISTORY_DELTA_ABSOLUTE      (-127)      /**< Delta marking a bucket stored in the next HISTORY_ABSOLUTE_EXT records */
+#define HISTORY_DELTA_MIN           (-126)
+#define HISTORY_DELTA_MAX           (127)
+#define HISTORY_OFFSET_MAX          (255)
+#define HISTORY_ABSOLUTE_EXT        (2)         /**< Records holding the 6 values of an absolute bucket */
+
+/**
+ * Bucket record, 6 bytes: averages are stored as 0.1 unit deltas from the previous valid
+ * bucket, min/max as 0.1 unit offsets from the average. A bucket whose delta or offsets do
+ * not fit is an absolute bucket: a HISTORY_DELTA_ABSOLUTE record followed by records holding
+ * the avg/min/max values as int16_t.
+ */
+typedef struct
+{
+    int8_t temp_delta;
+    int8_t humi_delta;
+    uint8_t temp_below;
+    uint8_t temp_above;
+    uint8_t humi_below;
+    uint8_t humi_above;
+}history_record_t;
+
+typedef struct
+{
+    int32_t temp_sum;
+    int32_t humi_sum;
+    int16_t temp_min;
+    int16_t temp_max;
+    int16_t humi_min;
+    int16_t humi_max;
+    uint16_t count;
+}history_acc_t;
+
+typedef struct
+{
+    history_record_t* records;
+    uint16_t size;
+    uint32_t duration;
+    uint32_t start;         /**< Start time of the bucket in progress */
+    uint16_t head;          /**< Oldest record */
+    uint16_t count;         /**< Records */
+    uint16_t buckets;       /**< Closed buckets, absolute ones take several records */
+    int16_t temp_base;      /**< Average before the oldest record */
+    int16_t humi_base;
+    int16_t temp_last;      /**< Average of the newest valid record */
+    int16_t humi_last;
+    bool has_ref;
+    history_acc_t acc;
+}history_tier_t;
+
+typedef struct
+{
+    bool used;
+    uint8_t no;
+    history_tier_t tiers[RBF_TEMP_HUMI_HISTORY_TIER_MAX];
+    history_record_t fine[RBF_TEMP_HUMI_HISTORY_FINE_BUCKETS];
+    history_record_t coarse[RBF_TEMP_HUMI_HISTORY_COARSE_BUCKETS];
+}history_sensor_t;
+
+static history_sensor_t s_sensors[RBF_TEMP_HUMI_HISTORY_SENSORS];
+static rbf_temp_humi_history_time_t s_history_now;
+static rbf_mutex_t s_history_mutex;
+
+
+static uint32_t history_now(void)
+{
+    rbf_time_t ms;
+
+    if (s_history_now != NULL) {
+        return s_history_now();
+    }
+    rbf_time_get_ms(&ms);
+    return (uint32_t)(ms / 1000);
+}
+
+
+static int16_t history_to_deci(int16_t centi)
+{
+    return (int16_t)(centi >= 0 ? (centi + 5) / 10 : (centi - 5) / 10);
+}
+
+
+static uint8_t history_record_slots(const history_record_t* record)
+{
+    return record->temp_delta == HISTORY_DELTA_ABSOLUTE ? 1 + HISTORY_ABSOLUTE_EXT : 1;
+}
+
+
+/* values: temp avg/min/max, humi avg/min/max */
+static void history_absolute_get(const history_tier_t* tier, uint16_t index, int16_t values[6])
+{
+    memcpy(&values[0], &tier->records[(index + 1) % tier->size], sizeof(history_record_t));
+    memcpy(&values[3], &tier->records[(index + 2) % tier->size], sizeof(history_record_t));
+}
+
+
+static void history_acc_reset(history_acc_t* acc)
+{
+    memset(acc, 0, sizeof(history_acc_t));
+}
+
+
+static void history_acc_add(history_acc_t* acc, int16_t temp_min, int16_t temp_max, int32_t temp_sum,
+                            int16_t humi_min, int16_t humi_max, int32_t humi_sum, uint16_t count)
+{
+    if (acc->count == 0 || temp_min < acc->temp_min) {
+        acc->temp_min = temp_min;
+    }
+    if (acc->count == 0 || temp_max > acc->temp_max) {
+        acc->temp_max = temp_max;
+    }
+    if (acc->count == 0 || humi_min < acc->humi_min) {
+        acc->humi_min = humi_min;
+    }
+    if (acc->count == 0 || humi_max > acc->humi_max) {
+        acc->humi_max = humi_max;
+    }
+    acc->temp_sum += temp_sum;
+    acc->humi_sum += humi_sum;
+    acc->count += count;
+}
+
+
+static void history_evict(history_tier_t* tier)
+{
+    /* The average of the oldest bucket becomes the base of the next one */
+    const history_record_t* oldest = &tier->records[tier->head];
+    uint8_t slots = history_record_slots(oldest);
+
+    if (oldest->temp_delta == HISTORY_DELTA_ABSOLUTE) {
+        int16_t values[6];
+
+        history_absolute_get(tier, tier->head, values);
+        tier->temp_base = values[0];
+        tier->humi_base = values[3];
+    } else if (oldest->temp_delta != HISTORY_DELTA_EMPTY) {
+        tier->temp_base += oldest->temp_delta;
+        tier->humi_base += oldest->humi_delta;
+    }
+    tier->head = (tier->head + slots) % tier->size;
+    tier->count -= slots;
+    tier->buckets--;
+}
+
+
+static void history_push(history_tier_t* tier, const history_record_t* records, uint8_t slots)
+{
+    uint8_t i;
+
+    while (tier->count + slots > tier->size) {
+        history_evict(tier);
+    }
+
+    for (i = 0; i < slots; i++) {
+        tier->records[(tier->head + tier->count) % tier->size] = records[i];
+        tier->count++;
+    }
+    tier->buckets++;
+}
+
+
+static void history_close(history_tier_t* tier)
+{
+    history_record_t records[1 + HISTORY_ABSOLUTE_EXT];
+    history_acc_t* acc = &tier->acc;
+    int16_t temp_avg;
+    int16_t humi_avg;
+    int32_t temp_delta;
+    int32_t humi_delta;
+
+    memset(records, 0, sizeof(records));
+    if (acc->count == 0) {
+        records[0].temp_delta = HISTORY_DELTA_EMPTY;
+        history_push(tier, records, 1);
+        return;
+    }
+
+    temp_avg = (int16_t)(acc->temp_sum / acc->count);
+    humi_avg = (int16_t)(acc->humi_sum / acc->count);
+    if (!tier->has_ref) {
+        tier->has_ref = true;
+        tier->temp_last = temp_avg;
+        tier->humi_last = humi_avg;
+        /* Records before are all empty */
+        tier->temp_base = temp_avg;
+        tier->humi_base = humi_avg;
+    }
+
+    temp_delta = temp_avg - tier->temp_last;
+    humi_delta = humi_avg - tier->humi_last;
+    tier->temp_last = temp_avg;
+    tier->humi_last = humi_avg;
+
+    if (temp_delta < HISTORY_DELTA_MIN || temp_delta > HISTORY_DELTA_MAX
+        || humi_delta < HISTORY_DELTA_MIN || humi_delta > HISTORY_DELTA_MAX
+        || temp_avg - acc->temp_min > HISTORY_OFFSET_MAX || acc->temp_max - temp_avg > HISTORY_OFFSET_MAX
+        || humi_avg - acc->humi_min > HISTORY_OFFSET_MAX || acc->humi_max - humi_avg > HISTORY_OFFSET_MAX) {
+        /* Does not fit a delta record, keep the exact values */
+        int16_t values[6] = {temp_avg, acc->temp_min, acc->temp_max, humi_avg, acc->humi_min, acc->humi_max};
+
+        records[0].temp_delta = HISTORY_DELTA_ABSOLUTE;
+        memcpy(&records[1], &values[0], sizeof(history_record_t));
+        memcpy(&records[2], &values[3], sizeof(history_record_t));
+        history_push(tier, records, 1 + HISTORY_ABSOLUTE_EXT);
+        return;
+    }
+
+    records[0].temp_delta = (int8_t)temp_delta;
+    records[0].humi_delta = (int8_t)humi_delta;
+    records[0].temp_below = (uint8_t)(temp_avg - acc->temp_min);
+    records[0].temp_above = (uint8_t)(acc->temp_max - temp_avg);
+    records[0].humi_below = (uint8_t)(humi_avg - acc->humi_min);
+    records[0].humi_above = (uint8_t)(acc->humi_max - humi_avg);
+    history_push(tier, records, 1);
+}
+
+
+static void history_tier_advance(history_tier_t* tier, uint32_t now)
+{
+    uint32_t elapsed;
+
+    if (now - tier->start < tier->duration) {
+        return;
+    }
+
+    history_close(tier);
+    history_acc_reset(&tier->acc);
+    tier->start += tier->duration;
+
+    /* The following buckets got no sample */
+    elapsed = (now - tier->start) / tier->duration;
+    if (elapsed >= tier->size) {
+        tier->head = 0;
+        tier->count = 0;
+        tier->buckets = 0;
+        tier->has_ref = false;
+        tier->start = now - now % tier->duration;
+        return;
+    }
+    while (elapsed--) {
+        history_close(tier);
+        tier->start += tier->duration;
+    }
+}
+
+
+static void history_advance(history_sensor_t* sensor, uint32_t now)
+{
+    history_tier_t* fine = &sensor->tiers[RBF_TEMP_HUMI_HISTORY_FINE];
+    history_tier_t* coarse = &sensor->tiers[RBF_TEMP_HUMI_HISTORY_COARSE];
+    history_acc_t* acc = &fine->acc;
+
+    /* The fine bucket is merged into the coarse one it belongs to before either is closed */
+    if (now - fine->start >= fine->duration && acc->count) {
+        history_acc_add(&coarse->acc, acc->temp_min, acc->temp_max, acc->temp_sum,
+                        acc->humi_min, acc->humi_max, acc->humi_sum, acc->count);
+    }
+    history_tier_advance(fine, now);
+    history_tier_advance(coarse, now);
+}
+
+
+static void history_tier_init(history_tier_t* tier, history_record_t* records, uint16_t size, uint32_t duration, uint32_t now)
+{
+    memset(tier, 0, sizeof(history_tier_t));
+    tier->records = records;
+    tier->size = size;
+    tier->duration = duration;
+    tier->start = now - now % duration;
+}
+
+
+static history_sensor_t* history_find(uint8_t no, bool create, uint32_t now)
+{
+    history_sensor_t* free_slot = NULL;
+    uint8_t i;
+
+    for (i = 0; i < RBF_TEMP_HUMI_HISTORY_SENSORS; i++) {
+        if (s_sensors[i].used && s_sensors[i].no == no) {
+            return &s_sensors[i];
+        }
+        if (!s_sensors[i].used && free_slot == NULL) {
+            free_slot = &s_sensors[i];
+        }
+    }
+
+    if (!create || free_slot == NULL) {
+        return NULL;
+    }
+
+    free_slot->used = true;
+    free_slot->no = no;
+    history_tier_init(&free_slot->tiers[RBF_TEMP_HUMI_HISTORY_FINE], free_slot->fine,
+                      RBF_TEMP_HUMI_HISTORY_FINE_BUCKETS, RBF_TEMP_HUMI_HISTORY_FINE_S, now);
+    history_tier_init(&free_slot->tiers[RBF_TEMP_HUMI_HISTORY_COARSE], free_slot->coarse,
+                      RBF_TEMP_HUMI_HISTORY_COARSE_BUCKETS, RBF_TEMP_HUMI_HISTORY_COARSE_S, now);
+    return free_slot;
+}
+
+
+static int history_observer(const rbf_observer_msg_t* msg, void* arg)
+{
+    const rbf_temp_humi_heartbeat_t* heartbeat = msg->payload;
+
+    (void)arg;
+    if (msg->msg == RBF_OBSERVER_MSG_HEARTBEAT && msg->type == RBF_DEV_TYPE_TEMP_HUMI && heartbeat != NULL) {
+        rbf_temp_humi_history_add(msg->id.no, rbf_float_to_centi(heartbeat->temp), rbf_float_to_centi(heartbeat->humi));
+    }
+    return RBF_OBSERVER_PASS;
+}
+
+
+int rbf_temp_humi_history_init(rbf_temp_humi_history_time_t now)
+{
+    if (s_history_mutex == NULL) {
+        s_history_mutex = rbf_mutex_create();
+        if (s_history_mutex == NULL) {
+            return -1;
+        }
+        if (0 != rbf_observer_add(history_observer, NULL)) {
+            return -1;
+        }
+    }
+
+    s_history_now = now;
+    return 0;
+}
+
+
+int rbf_temp_humi_history_add(uint8_t no, int16_t temp, int16_t humi)
+{
+    history_sensor_t* sensor;
+    history_acc_t* acc;
+    uint32_t now = history_now();
+    int16_t temp_deci = history_to_deci(temp);
+    int16_t humi_deci = history_to_deci(humi);
+
+    if (s_history_mutex == NULL) {
+        return -1;
+    }
+
+    rbf_mutex_lock(s_history_mutex);
+    sensor = history_find(no, true, now);
+    if (sensor == NULL) {
+        rbf_mutex_unlock(s_history_mutex);
+        return -1;
+    }
+
+    history_advance(sensor, now);
+    acc = &sensor->tiers[RBF_TEMP_HUMI_HISTORY_FINE].acc;
+    history_acc_add(acc, temp_deci, temp_deci, temp_deci, humi_deci, humi_deci, humi_deci, 1);
+    rbf_mutex_unlock(s_history_mutex);
+
+    return 0;
+}
+
+
+int rbf_temp_humi_history_poll(void)
+{
+    uint32_t now = history_now();
+    uint8_t i;
+
+    if (s_history_mutex == NULL) {
+        return 0;
+    }
+
+    rbf_mutex_lock(s_history_mutex);
+    for (i = 0; i < RBF_TEMP_HUMI_HISTORY_SENSORS; i++) {
+        if (s_sensors[i].used) {
+            history_advance(&s_sensors[i], now);
+        }
+    }
+    rbf_mutex_unlock(s_history_mutex);
+
+    return 0;
+}
+
+
+static void history_point_from_acc(rbf_temp_humi_history_point_t* point, const history_acc_t* acc)
+{
+    point->valid = true;
+    point->temp_avg = (int16_t)(acc->temp_sum / acc->count * 10);
+    point->temp_min = (int16_t)(acc->temp_min * 10);
+    point->temp_max = (int16_t)(acc->temp_max * 10);
+    point->humi_avg = (int16_t)(acc->humi_sum / acc->count * 10);
+    point->humi_min = (int16_t)(acc->humi_min * 10);
+    point->humi_max = (int16_t)(acc->humi_max * 10);
+}
+
+
+int rbf_temp_humi_history_query(uint8_t no, rbf_temp_humi_history_tier_t tier, uint32_t from, uint32_t to,
+                                rbf_temp_humi_history_point_t* points, uint16_t max_points)
+{
+    history_sensor_t* sensor;
+    history_tier_t* t;
+    int16_t temp;
+    int16_t humi;
+    uint32_t time;
+    uint16_t count = 0;
+    uint16_t i;
+    uint8_t slots;
+
+    if (s_history_mutex == NULL || tier >= RBF_TEMP_HUMI_HISTORY_TIER_MAX || points == NULL) {
+        return -1;
+    }
+
+    rbf_mutex_lock(s_history_mutex);
+    sensor = history_find(no, false, 0);
+    if (sensor == NULL) {
+        rbf_mutex_unlock(s_history_mutex);
+        return -1;
+    }
+
+    history_advance(sensor, history_now());
+    t = &sensor->tiers[tier];
+    temp = t->temp_base;
+    humi = t->humi_base;
+    time = t->start - t->buckets * t->duration;
+
+    for (i = 0; i < t->count; i += slots, time += t->duration) {
+        uint16_t index = (t->head + i) % t->size;
+        const history_record_t* record = &t->records[index];
+        rbf_temp_humi_history_point_t* point = &points[count];
+        int16_t values[6];
+
+        slots = history_record_slots(record);
+        if (record->temp_delta == HISTORY_DELTA_ABSOLUTE) {
+            history_absolute_get(t, index, values);
+            temp = values[0];
+            humi = values[3];
+        } else if (record->temp_delta != HISTORY_DELTA_EMPTY) {
+            temp += record->temp_delta;
+            humi += record->humi_delta;
+        }
+        if (time < from || time > to || count >= max_points) {
+            continue;
+        }
+
+        memset(point, 0, sizeof(rbf_temp_humi_history_point_t));
+        point->time = time;
+        if (record->temp_delta == HISTORY_DELTA_ABSOLUTE) {
+            point->valid = true;
+            point->temp_avg = (int16_t)(values[0] * 10);
+            point->temp_min = (int16_t)(values[1] * 10);
+            point->temp_max = (int16_t)(values[2] * 10);
+            point->humi_avg = (int16_t)(values[3] * 10);
+            point->humi_min = (int16_t)(values[4] * 10);
+            point->humi_max = (int16_t)(values[5] * 10);
+        } else if (record->temp_delta != HISTORY_DELTA_EMPTY) {
+            point->valid = true;
+            point->temp_avg = (int16_t)(temp * 10);
+            point->temp_min = (int16_t)((temp - record->temp_below) * 10);
+            point->temp_max = (int16_t)((temp + record->temp_above) * 10);
+            point->humi_avg = (int16_t)(humi * 10);
+            point->humi_min = (int16_t)((humi - record->humi_below) * 10);
+            point->humi_max = (int16_t)((humi + record->humi_above) * 10);
+        }
+        count++;
+    }
+
+    /* Bucket in progress */
+    if (t->acc.count && t->start >= from && t->start <= to && count < max_points) {
+        memset(&points[count], 0, sizeof(rbf_temp_humi_history_point_t));
+        points[count].time = t->start;
+        history_point_from_acc(&points[count], &t->acc);
+        count++;
+    }
+    rbf_mutex_unlock(s_history_mutex);
+
+    return count;
+}
+
+
+int rbf_temp_humi_history_clear(uint8_t no)
+{
+    history_sensor_t* sensor;
+
+    if (s_history_mutex == NULL) {
+        return -1;
+    }
+
+    rbf_mutex_lock(s_history_mutex);
+    sensor = history_find(no, false, 0);
+    if (sensor != NULL) {
+        sensor->used = false;
+    }
+    rbf_mutex_unlock(s_history_mutex);
+
+    return sensor != NULL ? 0 : -1;
+}
@@ -0,0 +1,111 @@
+/**
+ * @file rbf_devtab_test.c
+ * @brief Host test of rbf_devtab at full capacity: lookups, removal and registration information
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ * Build and run from the repository root:
+ * gcc -std=c99 -Wall -Iinclude -Iplatform/include -Iextension/include
+ *     extension/test/rbf_devtab_test.c extension/test/rbf_test_platform.c
+ *     extension/source/rbf_devtab.c -o rbf_devtab_test && ./rbf_devtab_test
+ */
+#include <string.h>
+#include "rbf_test_platform.h"
+#include "rbf_devtab.h"
+
+static RBF_dev_id_t s_ids[RBF_DEVTAB_MAX];
+static RBF_evt_callbacks_t s_cbs;
+
+
+/* Every device of s_ids from first on is found at a valid index, with its id */
+static void test_lookup(uint16_t first)
+{
+    rbf_devtab_entry_t entry;
+    uint16_t i;
+    int index;
+
+    for (i = first; i < RBF_DEVTAB_MAX; i++) {
+        index = rbf_devtab_index(&s_ids[i]);
+        RBF_TEST_CHECK(index >= 0 && index < rbf_devtab_count());
+        RBF_TEST_CHECK(rbf_devtab_at((uint16_t)index, &entry) == 0);
+        RBF_TEST_CHECK(entry.id.cat == s_ids[i].cat && entry.id.no == s_ids[i].no);
+        RBF_TEST_CHECK(rbf_devtab_get(&s_ids[i], &entry) == 0);
+        RBF_TEST_CHECK(entry.id.cat == s_ids[i].cat && entry.id.no == s_ids[i].no);
+    }
+}
+
+
+/* Fills the table at full capacity, spread over the categories */
+static void test_fill(void)
+{
+    RBF_register_response_t reponse;
+    uint16_t i;
+
+    for (i = 0; i < RBF_DEVTAB_MAX; i++) {
+        s_ids[i].cat = (RBF_dev_cat_t)(RBF_DEV_IO + i % (RBF_DEV_UNKNOW - RBF_DEV_IO));
+        s_ids[i].no = (uint8_t)(i / (RBF_DEV_UNKNOW - RBF_DEV_IO) + 1);
+    }
+    RBF_TEST_CHECK(rbf_devtab_wrap(&s_cbs) == 0);
+    RBF_TEST_CHECK(s_cbs.rbf_dev_register_info_handle(s_ids, RBF_DEVTAB_MAX) == 0);
+    RBF_TEST_CHECK(rbf_devtab_count() == RBF_DEVTAB_MAX);
+    test_lookup(0);
+
+    /* No room for one more */
+    memset(&reponse, 0, sizeof(reponse));
+    reponse.cat = RBF_DEV_KEYFOB;
+    reponse.no = 255;
+    RBF_TEST_CHECK(s_cbs.rbf_dev_register_reponse_handle(&reponse) == 0);
+    RBF_TEST_CHECK(rbf_devtab_count() == RBF_DEVTAB_MAX);
+}
+
+
+/* A removal moves the last device into the hole, every other device must still be found */
+static void test_remove(void)
+{
+    RBF_register_response_t reponse;
+    rbf_devtab_entry_t entry;
+
+    RBF_TEST_CHECK(rbf_devtab_remove(&s_ids[0]) == 0);
+    RBF_TEST_CHECK(rbf_devtab_remove(&s_ids[0]) == -1);
+    RBF_TEST_CHECK(rbf_devtab_index(&s_ids[0]) == -1);
+    RBF_TEST_CHECK(rbf_devtab_count() == RBF_DEVTAB_MAX - 1);
+    test_lookup(1);
+
+    /* A registration response takes the free number back with its information */
+    memset(&reponse, 0, sizeof(reponse));
+    reponse.cat = s_ids[0].cat;
+    reponse.no = s_ids[0].no;
+    reponse.type = RBF_DEV_TYPE_PIR;
+    RBF_TEST_CHECK(s_cbs.rbf_dev_register_reponse_handle(&reponse) == 0);
+    RBF_TEST_CHECK(rbf_devtab_get(&s_ids[0], &entry) == 0 && entry.type == RBF_DEV_TYPE_PIR);
+    test_lookup(0);
+}
+
+
+/* The registration information drops the devices missing from it */
+static void test_register_info(void)
+{
+    uint16_t half = RBF_DEVTAB_MAX / 2;
+
+    RBF_TEST_CHECK(s_cbs.rbf_dev_register_info_handle(&s_ids[half], RBF_DEVTAB_MAX - half) == 0);
+    RBF_TEST_CHECK(rbf_devtab_count() == RBF_DEVTAB_MAX - half);
+    RBF_TEST_CHECK(rbf_devtab_index(&s_ids[half - 1]) == -1);
+    test_lookup(half);
+
+    RBF_TEST_CHECK(rbf_devtab_remove(NULL) == 0);
+    RBF_TEST_CHECK(rbf_devtab_count() == 0);
+    RBF_TEST_CHECK(rbf_devtab_index(&s_ids[half]) == -1);
+}
+
+
+int main(void)
+{
+    test_fill();
+    test_remove();
+    test_register_info();
+
+    printf("%u devices, %s\n", RBF_DEVTAB_MAX, rbf_test_failures ? "FAILED" : "OK");
+    return rbf_test_failures ? 1 : 0;
+}
@@ -0,0 +1,91 @@
+/**
+ * @file rbf_observer_test.c
+ * @brief Host test of rbf_observer, chain order, drop and the observer limit
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ * Build and run from the repository root:
+ * gcc -std=c99 -Wall -Iinclude -Iplatform/include -Iextension/include
+ *     extension/test/rbf_observer_test.c extension/test/rbf_test_platform.c
+ *     extension/source/rbf_observer.c -o rbf_observer_test && ./rbf_observer_test
+ */
+#include "rbf_test_platform.h"
+#include "rbf_observer.h"
+
+#define TEST_MODULES    (14)        /**< Extension modules adding an observer */
+
+static int s_args[RBF_OBSERVER_MAX + 1];
+static int s_order[RBF_OBSERVER_MAX];
+static int s_called;
+static int s_drop_at = -1;
+static int s_app_called;
+
+
+static int test_observer(const rbf_observer_msg_t* msg, void* arg)
+{
+    int index = *(int*)arg;
+
+    RBF_TEST_CHECK(msg->msg == RBF_OBSERVER_MSG_INPUT_EVT && msg->type == RBF_DEV_TYPE_PIR && msg->id.no == 5);
+    if (s_called < RBF_OBSERVER_MAX) {
+        s_order[s_called] = index;
+    }
+    s_called++;
+    return index == s_drop_at ? RBF_OBSERVER_DROP : RBF_OBSERVER_PASS;
+}
+
+
+static int test_app_evt(uint8_t no, rbf_pir_input_evt_t evt)
+{
+    (void)evt;
+    RBF_TEST_CHECK(no == 5);
+    s_app_called++;
+    return 0;
+}
+
+
+int main(void)
+{
+    rbf_pir_callbacks_t cbs = {NULL, test_app_evt, NULL};
+    int i;
+
+    RBF_TEST_CHECK(RBF_OBSERVER_MAX >= TEST_MODULES);
+
+    for (i = 0; i <= RBF_OBSERVER_MAX; i++) {
+        s_args[i] = i;
+    }
+    for (i = 0; i < RBF_OBSERVER_MAX; i++) {
+        RBF_TEST_CHECK(rbf_observer_add(test_observer, &s_args[i]) == 0);
+    }
+    /* One more than the limit fails */
+    RBF_TEST_CHECK(rbf_observer_add(test_observer, &s_args[RBF_OBSERVER_MAX]) == -1);
+    RBF_TEST_CHECK(rbf_observer_add(NULL, NULL) == -1);
+
+    RBF_TEST_CHECK(rbf_observer_wrap_pir(&cbs) == 0);
+
+    /* Every observer in the order added, then the application */
+    cbs.input_evt_cb(5, RBF_PIR_INPUT_EVT_ALARM);
+    RBF_TEST_CHECK(s_called == RBF_OBSERVER_MAX && s_app_called == 1);
+    for (i = 0; i < RBF_OBSERVER_MAX; i++) {
+        RBF_TEST_CHECK(s_order[i] == i);
+    }
+
+    /* A drop stops the chain and the application callback */
+    s_called = 0;
+    s_drop_at = 2;
+    cbs.input_evt_cb(5, RBF_PIR_INPUT_EVT_ALARM);
+    RBF_TEST_CHECK(s_called == 3 && s_app_called == 1);
+
+    /* Removing one makes room again */
+    s_drop_at = -1;
+    RBF_TEST_CHECK(rbf_observer_remove(test_observer, &s_args[2]) == 0);
+    RBF_TEST_CHECK(rbf_observer_remove(test_observer, &s_args[2]) == -1);
+    RBF_TEST_CHECK(rbf_observer_add(test_observer, &s_args[RBF_OBSERVER_MAX]) == 0);
+    s_called = 0;
+    cbs.input_evt_cb(5, RBF_PIR_INPUT_EVT_ALARM);
+    RBF_TEST_CHECK(s_called == RBF_OBSERVER_MAX && s_order[2] == 3 && s_order[RBF_OBSERVER_MAX - 1] == RBF_OBSERVER_MAX);
+
+    printf("%s\n", rbf_test_failures ? "FAILED" : "OK");
+    return rbf_test_failures ? 1 : 0;
+}
@@ -0,0 +1,144 @@
+/**
+ * @file rbf_ota_checkpoint_test.c
+ * @brief Host test of rbf_ota_checkpoint, an interrupted transfer resumes at its checkpoint
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ * Build and run from the repository root:
+ * gcc -std=c99 -Wall -Iinclude -Iplatform/include -Iextension/include
+ *     extension/test/rbf_ota_checkpoint_test.c extension/test/rbf_test_platform.c
+ *     extension/source/rbf_ota_checkpoint.c -o rbf_ota_checkpoint_test && ./rbf_ota_checkpoint_test
+ */
+#include <string.h>
+#include "rbf_test_platform.h"
+#include "rbf_ota_checkpoint.h"
+
+#define TEST_FW_SIZE    (10240)
+#define TEST_FW_CRC     (0x12345678)
+#define TEST_BLOCK      (128)
+
+static RBF_ota_evt_callbacks_t s_cbs;
+static rbf_ota_checkpoint_t s_saved;
+static bool s_saved_valid;
+static uint32_t s_start_size;
+static uint32_t s_last_offset;
+
+
+/* Stand-in of the library, records the transfer size */
+int rbf_ota_start(uint32_t fw_size)
+{
+    s_start_size = fw_size;
+    return 0;
+}
+
+
+static int test_load(rbf_ota_checkpoint_t* checkpoint)
+{
+    if (!s_saved_valid) {
+        return -1;
+    }
+    *checkpoint = s_saved;
+    return 0;
+}
+
+
+static int test_save(const rbf_ota_checkpoint_t* checkpoint)
+{
+    s_saved = *checkpoint;
+    s_saved_valid = true;
+    return 0;
+}
+
+
+static int test_clear(void)
+{
+    s_saved_valid = false;
+    return 0;
+}
+
+
+static int test_data(unsigned int offset, unsigned int size, unsigned char* data)
+{
+    (void)size;
+    (void)data;
+    s_last_offset = offset;
+    return 0;
+}
+
+
+static int test_evt(RBF_ota_evt_t evt, RBF_ota_status_t* status)
+{
+    (void)evt;
+    (void)status;
+    return 0;
+}
+
+
+/* The library requests blocks of its own transfer from 0 up to end */
+static void test_transfer(uint32_t end)
+{
+    unsigned char block[TEST_BLOCK];
+    uint32_t offset;
+
+    for (offset = 0; offset < end; offset += TEST_BLOCK) {
+        RBF_TEST_CHECK(s_cbs.rbf_ota_request_upgrade_data_handle(offset, TEST_BLOCK, block) == 0);
+    }
+}
+
+
+int main(void)
+{
+    rbf_ota_checkpoint_store_t store = {test_load, test_save, test_clear};
+    rbf_ota_checkpoint_info_t info;
+
+    s_cbs.rbf_ota_request_upgrade_data_handle = test_data;
+    s_cbs.rbf_ota_evt_handle = test_evt;
+    RBF_TEST_CHECK(rbf_ota_checkpoint_wrap(&s_cbs, &store, 1024) == 0);
+
+    /* A first transfer is interrupted after 40 blocks */
+    RBF_TEST_CHECK(rbf_ota_checkpoint_start(TEST_FW_SIZE, TEST_FW_CRC) == 0);
+    RBF_TEST_CHECK(s_start_size == TEST_FW_SIZE);
+    test_transfer(40 * TEST_BLOCK);
+    s_cbs.rbf_ota_evt_handle(RBF_OTA_EVT_UPGRADE_FAIL, NULL);
+    RBF_TEST_CHECK(s_saved_valid && s_saved.confirmed_offset == 39 * TEST_BLOCK);
+
+    /* The next start sends only the rest, image offsets are given to the data source */
+    RBF_TEST_CHECK(rbf_ota_checkpoint_start(TEST_FW_SIZE, TEST_FW_CRC) == 0);
+    RBF_TEST_CHECK(s_start_size == TEST_FW_SIZE - 39 * TEST_BLOCK);
+    RBF_TEST_CHECK(rbf_ota_checkpoint_info_get(&info) == 0);
+    RBF_TEST_CHECK(info.resumed && info.bytes_skipped == 39 * TEST_BLOCK && info.resume_count == 1);
+    test_transfer(TEST_BLOCK);
+    RBF_TEST_CHECK(s_last_offset == 39 * TEST_BLOCK);
+    RBF_TEST_CHECK(s_saved_valid);
+
+    /* Interrupted again, resumed again, then completed */
+    test_transfer(20 * TEST_BLOCK);
+    s_cbs.rbf_ota_evt_handle(RBF_OTA_EVT_UPGRADE_FAIL, NULL);
+    RBF_TEST_CHECK(s_saved.confirmed_offset == 58 * TEST_BLOCK);
+    RBF_TEST_CHECK(rbf_ota_checkpoint_start(TEST_FW_SIZE, TEST_FW_CRC) == 0);
+    RBF_TEST_CHECK(s_start_size == TEST_FW_SIZE - 58 * TEST_BLOCK);
+    test_transfer(TEST_FW_SIZE - 58 * TEST_BLOCK);
+    RBF_TEST_CHECK(s_last_offset == TEST_FW_SIZE - TEST_BLOCK);
+    s_cbs.rbf_ota_evt_handle(RBF_OTA_EVT_UPGRADE_COMPLETE, NULL);
+    RBF_TEST_CHECK(!s_saved_valid);
+    rbf_ota_checkpoint_info_get(&info);
+    RBF_TEST_CHECK(info.bytes_skipped_total == 97 * TEST_BLOCK && info.resume_count == 2);
+
+    /* Another image, or a refused start, restarts at 0 */
+    test_transfer(10 * TEST_BLOCK);
+    s_cbs.rbf_ota_evt_handle(RBF_OTA_EVT_UPGRADE_FAIL, NULL);
+    RBF_TEST_CHECK(rbf_ota_checkpoint_start(TEST_FW_SIZE, TEST_FW_CRC + 1) == 0);
+    RBF_TEST_CHECK(s_start_size == TEST_FW_SIZE && !s_saved_valid);
+    test_transfer(10 * TEST_BLOCK);
+    s_cbs.rbf_ota_evt_handle(RBF_OTA_EVT_UPGRADE_FAIL, NULL);
+    RBF_TEST_CHECK(rbf_ota_checkpoint_start(TEST_FW_SIZE, TEST_FW_CRC + 1) == 0);
+    RBF_TEST_CHECK(s_start_size == TEST_FW_SIZE - 9 * TEST_BLOCK);
+    s_cbs.rbf_ota_evt_handle(RBF_OTA_EVT_START_FAIL, NULL);
+    RBF_TEST_CHECK(rbf_ota_checkpoint_start(TEST_FW_SIZE, TEST_FW_CRC + 1) == 0);
+    RBF_TEST_CHECK(s_start_size == TEST_FW_SIZE);
+
+    printf("%s\n", rbf_test_failures ? "FAILED" : "OK");
+    return rbf_test_failures ? 1 : 0;
+}
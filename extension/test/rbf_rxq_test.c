@@ -0,0 +1,121 @@
+/**
+ * @file rbf_rxq_test.c
+ * @brief Host test of rbf_rxq under a heartbeat and sub-device OTA flood, alarm delivery bound
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ * Build and run from the repository root:
+ * gcc -std=c99 -Wall -Iinclude -Iplatform/include -Iextension/include
+ *     extension/test/rbf_rxq_test.c extension/test/rbf_test_platform.c
+ *     extension/source/rbf_observer.c extension/source/rbf_rxq.c -o rbf_rxq_test && ./rbf_rxq_test
+ */
+#include "rbf_test_platform.h"
+#include "rbf_rxq.h"
+
+#define TEST_ROUNDS         (50)
+#define TEST_POLL_MS        (20)        /**< Application poll period */
+#define TEST_POLL_BUDGET    (2)         /**< Messages delivered per poll, fewer than arrive */
+#define TEST_HEARTBEATS     (8)         /**< Heartbeats per poll period */
+#define TEST_OTA_REQUESTS   (4)         /**< Sub-device OTA data requests per poll period */
+#define TEST_OTA_MS         (3)         /**< rbfsdk thread time serving one OTA data request */
+
+static rbf_pir_callbacks_t s_cbs;
+static rbf_time_t s_now;
+static uint8_t s_alarm_sent;
+static uint8_t s_alarm_delivered;
+static uint32_t s_heartbeat_delivered;
+
+
+static int test_app_heartbeat(uint8_t no, rbf_pir_heartbeat_t* heartbeat)
+{
+    (void)no;
+    (void)heartbeat;
+    s_heartbeat_delivered++;
+    return 0;
+}
+
+
+/* Alarms carry their sending order in the registration number */
+static int test_app_evt(uint8_t no, rbf_pir_input_evt_t evt)
+{
+    RBF_TEST_CHECK(evt == RBF_PIR_INPUT_EVT_ALARM);
+    RBF_TEST_CHECK(no == s_alarm_delivered);
+    s_alarm_delivered++;
+    return 0;
+}
+
+
+static void test_advance(rbf_time_t ms)
+{
+    s_now += ms;
+    rbf_test_time_set(s_now);
+}
+
+
+/*
+ * The library serves a sub-device OTA data request in the rbfsdk thread: it delays the messages
+ * behind it before any extension hook sees them, with or without rbf_rxq
+ */
+static void test_ota_request(void)
+{
+    test_advance(TEST_OTA_MS);
+}
+
+
+static void test_heartbeat(uint8_t no)
+{
+    rbf_pir_heartbeat_t heartbeat = {100, -70};
+
+    s_cbs.hb_cb(no, &heartbeat);
+}
+
+
+int main(void)
+{
+    rbf_rxq_stats_t stats;
+    rbf_time_t start;
+    uint32_t round;
+    uint8_t i;
+
+    s_cbs.hb_cb = test_app_heartbeat;
+    s_cbs.input_evt_cb = test_app_evt;
+    RBF_TEST_CHECK(rbf_observer_wrap_pir(&s_cbs) == 0);
+    RBF_TEST_CHECK(rbf_rxq_init() == 0);
+
+    /* A poll period: heartbeats and OTA requests all along, one alarm in the middle */
+    for (round = 0; round < TEST_ROUNDS; round++) {
+        start = s_now;
+        for (i = 0; i < TEST_HEARTBEATS; i++) {
+            test_heartbeat((uint8_t)(i + 1));
+            if (i % (TEST_HEARTBEATS / TEST_OTA_REQUESTS) == 0) {
+                test_ota_request();
+            }
+            if (i == TEST_HEARTBEATS / 2) {
+                s_cbs.input_evt_cb(s_alarm_sent++, RBF_PIR_INPUT_EVT_ALARM);
+            }
+        }
+        test_advance(start + TEST_POLL_MS - s_now);
+
+        /* The alarm goes out with the first poll after it, ahead of the heartbeat backlog */
+        RBF_TEST_CHECK(rbf_rxq_poll(TEST_POLL_BUDGET) == TEST_POLL_BUDGET);
+        RBF_TEST_CHECK(s_alarm_delivered == s_alarm_sent);
+    }
+
+    RBF_TEST_CHECK(rbf_rxq_stats_get(&stats) == 0);
+    RBF_TEST_CHECK(stats.classes[RBF_RXQ_ALARM].queued == TEST_ROUNDS);
+    RBF_TEST_CHECK(stats.classes[RBF_RXQ_ALARM].delivered == TEST_ROUNDS);
+    RBF_TEST_CHECK(stats.classes[RBF_RXQ_ALARM].dropped == 0);
+    RBF_TEST_CHECK(stats.classes[RBF_RXQ_ALARM].latency_max_ms <= TEST_POLL_MS);
+    RBF_TEST_CHECK(stats.classes[RBF_RXQ_HEARTBEAT].dropped > 0);
+    RBF_TEST_CHECK(stats.classes[RBF_RXQ_HEARTBEAT].latency_max_ms > TEST_POLL_MS);
+    RBF_TEST_CHECK(stats.extra == 0 && stats.direct == 0);
+    RBF_TEST_CHECK(s_heartbeat_delivered == TEST_ROUNDS * (TEST_POLL_BUDGET - 1));
+
+    printf("alarm latency avg %u ms max %u ms, heartbeat latency max %u ms, %u heartbeats shed\n",
+           (unsigned)stats.classes[RBF_RXQ_ALARM].latency_avg_ms, (unsigned)stats.classes[RBF_RXQ_ALARM].latency_max_ms,
+           (unsigned)stats.classes[RBF_RXQ_HEARTBEAT].latency_max_ms, (unsigned)stats.classes[RBF_RXQ_HEARTBEAT].dropped);
+    printf("%s\n", rbf_test_failures ? "FAILED" : "OK");
+    return rbf_test_failures ? 1 : 0;
+}
@@ -0,0 +1,168 @@
+/**
+ * @file rbf_temphumi_history_test.c
+ * @brief Host test of rbf_temphumi_history, large jumps and spreads must be kept exactly
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ * Build and run from the repository root:
+ * gcc -std=c99 -Wall -Iinclude -Iplatform/include -Iextension/include -DRBF_TEMP_HUMI_FIXED_POINT=0
+ *     extension/test/rbf_temphumi_history_test.c extension/test/rbf_test_platform.c
+ *     extension/source/rbf_temphumi_history.c extension/source/rbf_temphumi_fixed.c
+ *     extension/source/rbf_observer.c -o rbf_temphumi_history_test && ./rbf_temphumi_history_test
+ */
+#include <string.h>
+#include "rbf_test_platform.h"
+#include "rbf_temphumi_history.h"
+#include "rbf_temphumi_fixed.h"
+
+#define TEST_SENSOR     (1)
+
+static uint32_t s_now;
+
+
+static uint32_t test_now(void)
+{
+    return s_now;
+}
+
+
+/* Adds a sample at the given second */
+static void test_add(uint32_t time, int16_t temp, int16_t humi)
+{
+    s_now = time;
+    RBF_TEST_CHECK(rbf_temp_humi_history_add(TEST_SENSOR, temp, humi) == 0);
+}
+
+
+static int test_query(rbf_temp_humi_history_point_t* points, uint16_t max_points)
+{
+    return rbf_temp_humi_history_query(TEST_SENSOR, RBF_TEMP_HUMI_HISTORY_FINE, 0, 0xFFFFFFFF, points, max_points);
+}
+
+
+static void test_point(const rbf_temp_humi_history_point_t* point, int16_t avg, int16_t min, int16_t max)
+{
+    RBF_TEST_CHECK(point->valid);
+    RBF_TEST_CHECK(point->temp_avg == avg);
+    RBF_TEST_CHECK(point->temp_min == min);
+    RBF_TEST_CHECK(point->temp_max == max);
+}
+
+
+/* A jump from 33.1 to -10.0 used to be clamped to 20.40 with min -5.10 */
+static void test_large_jump(void)
+{
+    rbf_temp_humi_history_point_t points[8];
+    uint32_t t = RBF_TEMP_HUMI_HISTORY_FINE_S;
+    int n;
+
+    test_add(t, 3310, 5000);
+    test_add(t + 1 * RBF_TEMP_HUMI_HISTORY_FINE_S, -1000, 5000);
+    test_add(t + 2 * RBF_TEMP_HUMI_HISTORY_FINE_S, -1000, 5000);
+    test_add(t + 3 * RBF_TEMP_HUMI_HISTORY_FINE_S, -990, 5000);
+    s_now = t + 4 * RBF_TEMP_HUMI_HISTORY_FINE_S;
+
+    n = test_query(points, 8);
+    RBF_TEST_CHECK(n == 4);
+    test_point(&points[0], 3310, 3310, 3310);
+    test_point(&points[1], -1000, -1000, -1000);
+    test_point(&points[2], -1000, -1000, -1000);
+    test_point(&points[3], -990, -990, -990);
+    RBF_TEST_CHECK(points[1].time == points[0].time + RBF_TEMP_HUMI_HISTORY_FINE_S);
+    RBF_TEST_CHECK(points[3].time == points[0].time + 3 * RBF_TEMP_HUMI_HISTORY_FINE_S);
+}
+
+
+/* Min and max more than 25.5 from the average in one bucket */
+static void test_large_spread(void)
+{
+    rbf_temp_humi_history_point_t points[8];
+    uint32_t t = RBF_TEMP_HUMI_HISTORY_FINE_S;
+    int n;
+
+    test_add(t, 2000, 5000);
+    test_add(t + RBF_TEMP_HUMI_HISTORY_FINE_S, 3310, 5000);
+    test_add(t + RBF_TEMP_HUMI_HISTORY_FINE_S + 1, -1000, 9000);
+    s_now = t + 2 * RBF_TEMP_HUMI_HISTORY_FINE_S;
+
+    n = test_query(points, 8);
+    RBF_TEST_CHECK(n == 2);
+    test_point(&points[1], 1150, -1000, 3310);
+    RBF_TEST_CHECK(points[1].humi_min == 5000);
+    RBF_TEST_CHECK(points[1].humi_max == 9000);
+}
+
+
+/* Absolute buckets take several records, eviction must keep the following averages */
+static void test_evict(void)
+{
+    rbf_temp_humi_history_point_t points[RBF_TEMP_HUMI_HISTORY_FINE_BUCKETS + 1];
+    uint32_t t = RBF_TEMP_HUMI_HISTORY_FINE_S;
+    uint32_t i;
+    int n;
+    int k;
+
+    for (i = 0; i < 3 * RBF_TEMP_HUMI_HISTORY_FINE_BUCKETS; i++) {
+        int16_t temp = (i % 4 == 0) ? -2000 : (int16_t)(2000 + i * 10);
+
+        test_add(t + i * RBF_TEMP_HUMI_HISTORY_FINE_S, temp, 5000);
+    }
+    s_now = t + i * RBF_TEMP_HUMI_HISTORY_FINE_S;
+
+    n = test_query(points, RBF_TEMP_HUMI_HISTORY_FINE_BUCKETS + 1);
+    RBF_TEST_CHECK(n > 0);
+    for (k = 0; k < n; k++) {
+        uint32_t j = (points[k].time - t) / RBF_TEMP_HUMI_HISTORY_FINE_S;
+        int16_t temp = (j % 4 == 0) ? -2000 : (int16_t)(2000 + j * 10);
+
+        test_point(&points[k], temp, temp, temp);
+        if (k > 0) {
+            RBF_TEST_CHECK(points[k].time == points[k - 1].time + RBF_TEMP_HUMI_HISTORY_FINE_S);
+        }
+    }
+    RBF_TEST_CHECK(points[n - 1].time == t + (i - 1) * RBF_TEMP_HUMI_HISTORY_FINE_S);
+}
+
+
+/* Small steps stay delta records, offline time gives gaps */
+static void test_delta(void)
+{
+    rbf_temp_humi_history_point_t points[8];
+    uint32_t t = RBF_TEMP_HUMI_HISTORY_FINE_S;
+    int n;
+
+    test_add(t, 2150, 4500);
+    test_add(t + 1, 2170, 4510);
+    test_add(t + RBF_TEMP_HUMI_HISTORY_FINE_S, 2230, 4600);
+    test_add(t + 3 * RBF_TEMP_HUMI_HISTORY_FINE_S, 2100, 4400);
+    s_now = t + 4 * RBF_TEMP_HUMI_HISTORY_FINE_S;
+
+    n = test_query(points, 8);
+    RBF_TEST_CHECK(n == 4);
+    test_point(&points[0], 2160, 2150, 2170);
+    test_point(&points[1], 2230, 2230, 2230);
+    RBF_TEST_CHECK(!points[2].valid);
+    test_point(&points[3], 2100, 2100, 2100);
+    RBF_TEST_CHECK(points[3].humi_avg == 4400);
+}
+
+
+int main(void)
+{
+    RBF_TEST_CHECK(rbf_float_to_centi(21.5f) == 2150);
+    RBF_TEST_CHECK(rbf_float_to_centi(-10.0f) == -1000);
+    RBF_TEST_CHECK(rbf_temp_humi_history_init(test_now) == 0);
+
+    test_large_jump();
+    rbf_temp_humi_history_clear(TEST_SENSOR);
+    test_large_spread();
+    rbf_temp_humi_history_clear(TEST_SENSOR);
+    test_evict();
+    rbf_temp_humi_history_clear(TEST_SENSOR);
+    test_delta();
+
+    printf("%s\n", rbf_test_failures ? "FAILED" : "OK");
+    return rbf_test_failures ? 1 : 0;
+}
@@ -0,0 +1,60 @@
+/**
+ * @file rbf_test_platform.c
+ * @brief Host stand-in of the platform layer for the extension tests and benchmarks
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+#include <stdlib.h>
+#include "rbf_test_platform.h"
+#include "rbf_mutex.h"
+#include "rbf_mem.h"
+
+int rbf_test_failures;
+static rbf_time_t s_test_time;
+static int s_test_mutex;
+
+
+void rbf_test_time_set(rbf_time_t ms)
+{
+    s_test_time = ms;
+}
+
+
+void rbf_time_get_ms(rbf_time_t* time)
+{
+    *time = s_test_time;
+}
+
+
+/* Single threaded: a mutex only has to be non-NULL */
+rbf_mutex_t rbf_mutex_create()
+{
+    return &s_test_mutex;
+}
+
+
+void rbf_mutex_lock(rbf_mutex_t mutex)
+{
+    (void)mutex;
+}
+
+
+void rbf_mutex_unlock(rbf_mutex_t mutex)
+{
+    (void)mutex;
+}
+
+
+void* rbf_malloc(size_t size)
+{
+    return malloc(size);
+}
+
+
+void rbf_free(void *ptr)
+{
+    free(ptr);
+}
@@ -0,0 +1,47 @@
+/**
+ * @file rbf_test_platform.h
+ * @brief Host stand-in of the platform layer for the extension tests
+ * @version 0.1
+ * @date 2026-10-19
+ * 
+ * @copyright Copyright (c) 2026
+ * 
+ */
+#ifndef RBF_TEST_PLATFORM_H
+#define RBF_TEST_PLATFORM_H
+
+#include <stdio.h>
+#include "rbf_time.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+/**
+ * @brief Check a condition, print the failed expression and count it
+ * 
+ */
+#define RBF_TEST_CHECK(cond) do { \
+        if (!(cond)) { \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            rbf_test_failures++; \
+        } \
+    } while (0)
+
+
+extern int rbf_test_failures;
+
+
+/**
+ * @brief Set the time returned by rbf_time_get_ms()
+ * 
+ * @param ms Time in milliseconds
+ */
+void rbf_test_time_set(rbf_time_t ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif